@@ -1,11 +1,19 @@
 // SmartGarden_ESP32C6.ino
 #include "config.h"
+#include "i2c_bus.h"
 #include "wifi_manager.h"
 #include "aht20_sensor.h"
 #include "ads1115_sensor.h"
+#include "sensor_manager.h"
+#include "report_policy.h"
+#include "sensor_history.h"
+#include "sample_log.h"
+#include "memory_monitor.h"
 #include "led_controller.h"
 #include "ntp_time.h"
 #include "mqtt_manager.h"
+#include "mqtt_queue.h"
+#include "command_handler.h"
 #include "reset_manager.h"
 #include "ota_manager.h"
 
@@ -35,30 +43,27 @@ void setup() {
   initLED();
   setLEDColor(LED_BLUE);
   initResetManager();
+  initMemoryMonitor();
   
   // Initialize I2C devices
   Serial.println("📡 Initializing I2C Sensors...");
+  initI2CBus();
   bool aht20Working = initAHT20();
   bool ads1115Working = initADS1115();
   allSensorsWorking = aht20Working || ads1115Working;
+  
+  // Persist samples across uplink outages
+  initSampleLog();
+  if (SOIL_PROBE_COUNT > HISTORY_MAX_PROBES) {
+    Serial.println("⚠️ RAM history keeps soil probes 1-" + String(HISTORY_MAX_PROBES) + " of " +
+                   String(SOIL_PROBE_COUNT) + "; the sample log keeps all of them");
+  }
 
-  // Initialize WiFi (this may start captive portal)
+  // Start connecting to WiFi in the background (this may start captive portal)
   setupWiFi();
-    
-    // Initialize OTA and check
-    initOTA();
-    if (WiFi.status() == WL_CONNECTED) {
-        Serial.println("\n--- Initial OTA Check on Startup ---");
-        checkForFirmwareUpdate();
-    }
   
-  // Force immediate OTA check on startup if WiFi is connected
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("\n--- Initial OTA Check on Startup ---");
-    checkForFirmwareUpdate();  // This will check immediately
-  } else {
-    Serial.println("⚠️ Skipping OTA check - WiFi not connected");
-  }
+  // The startup OTA check runs from loop() once the link is up
+  initOTA();
 
   // Initialize MQTT if server is configured
   if (MQTT_SERVER.length() > 0) {
@@ -74,18 +79,13 @@ void setup() {
     Serial.println("💡 LED Status: Cyan (Captive Portal Mode)");
   } else {
     bool mqttConnected = (MQTT_SERVER.length() > 0) ? isMQTTConnected() : true;
-    setLEDStatus(WiFi.status() == WL_CONNECTED, mqttConnected, allSensorsWorking);
-    
-    if (WiFi.status() == WL_CONNECTED) {
-      Serial.println("💡 LED Status: Green (WiFi Connected)");
-    } else {
-      Serial.println("💡 LED Status: Red (WiFi Disconnected)");
-    }
+    setLEDStatus(isWiFiConnected(), mqttConnected, allSensorsWorking);
+    Serial.println("💡 LED Status: Red (WiFi Connecting)");
   }
 
   Serial.println("✅ System initialization complete!");
   Serial.println("📊 System Status:");
-  Serial.println("   - WiFi: " + String(WiFi.status() == WL_CONNECTED ? "Connected" : "Disconnected"));
+  Serial.println("   - WiFi: " + String(isWiFiConnected() ? "Connected" : (isCaptivePortalRunning() ? "Off" : "Connecting")));
   Serial.println("   - Captive Portal: " + String(isCaptivePortalRunning() ? "Active" : "Inactive"));
   Serial.println("   - MQTT: " + String(MQTT_SERVER.length() > 0 ? (isMQTTConnected() ? "Connected" : "Disconnected") : "Not Configured"));
   Serial.println("   - AHT20 Sensor: " + String(aht20Working ? "Working" : "Not Found"));
@@ -113,9 +113,21 @@ void loop() {
     return;
   }
   
-  // Handle WiFi manager (captive portal)
+  // Handle WiFi manager (link state machine, captive portal)
   handleWiFiManagerLoop();
   
+  // Finish a pending NTP sync started on the last WiFi connect
+  handleNTPSync();
+  
+  // Sample sensors into the shared snapshot (non-blocking, runs in every mode)
+  handleSensorSampling();
+  
+  // Track heap, fragmentation and stack headroom
+  handleMemoryMonitor();
+  
+  // Replay samples logged while the broker was unreachable (rate limited)
+  handleSampleLog();
+  
   // If in captive portal mode, skip normal operations
   if (isCaptivePortalRunning()) {
     // Update LED to indicate captive portal mode
@@ -130,75 +142,67 @@ void loop() {
       }
       ledState = !ledState;
     }
-    delay(100);
+    delay(isSensorReadInProgress() ? LOOP_DELAY_SENSOR_BUSY_MS : LOOP_DELAY_MS);
     return;
   }
 
+  // Check for firmware updates once the first WiFi link is up
+  static bool startupOTAChecked = false;
+  if (!startupOTAChecked && isWiFiConnected()) {
+    startupOTAChecked = true;
+    Serial.println("\n--- Initial OTA Check on Startup ---");
+    checkForFirmwareUpdate();
+  }
+
   // Handle MQTT if server is configured
   if (MQTT_SERVER.length() > 0) {
     mqttLoop();
     checkMQTTConnection();
+    handleCommands();
   }
 
-  // Read sensors at regular intervals
+  // Update LED status at the sensor cadence
   if (millis() - lastSensorRead >= SENSOR_READ_INTERVAL) {
     lastSensorRead = millis();
     
-    Serial.println("\n--- Reading Sensors ---");
-    
-    // Read AHT20 data (air temperature & humidity)
-    AHT20_Data ahtData = readAHT20();
-    printAHT20Data(ahtData);
-    
-    // Read ADS1115 data (soil moisture & temperature)
-    ADS1115_Data soilData = readAllSoilSensors();
-    printADS1115Data(soilData);
-
-    // Update LED status
     bool mqttConnected = (MQTT_SERVER.length() > 0) ? isMQTTConnected() : true;
-    bool wifiConnected = (WiFi.status() == WL_CONNECTED);
+    bool wifiConnected = isWiFiConnected();
     setLEDStatus(wifiConnected, mqttConnected, allSensorsWorking);
-    
-    Serial.println("--- End of Readings ---\n");
   }
 
-  // Publish to MQTT at regular intervals (only if MQTT is enabled)
-  if (MQTT_SERVER.length() > 0 && millis() - lastMQTTPublish >= MQTT_PUBLISH_INTERVAL) {
-    if (isMQTTConnected()) {
+  // Publish to MQTT when the report policy says so (only if MQTT is enabled).
+  // The decision is only taken while connected, so an outage does not use up
+  // new snapshots or a pending full report.
+  if (MQTT_SERVER.length() > 0 && isMQTTConnected()) {
+    ReportDecision decision;
+    const SensorSnapshot& snapshot = getSensorSnapshot();
+    if (takeReportDecision(snapshot, decision)) {
       lastMQTTPublish = millis();
       
       Serial.println("📤 Publishing sensor data to MQTT...");
-      AHT20_Data ahtData = readAHT20();
-      ADS1115_Data soilData = readAllSoilSensors();
-      publishSensorData(ahtData, soilData);
+      if (publishSensorData(snapshot.air, snapshot.soil, decision)) {
+        markMetricsReported(decision, snapshot);
+      }
       
       // Print current time and system info
       printCurrentTime();
-      Serial.println("💾 Free Heap: " + String(ESP.getFreeHeap()) + " bytes");
+      printReportStats();
+      printSensorHistoryStats();
+      printSampleLogStats();
+      printMQTTQueueStats();
+      printMQTTConnectionStats();
+      printMemoryStats();
       Serial.println("📶 WiFi RSSI: " + String(WiFi.RSSI()) + " dBm");
-    } else {
-      Serial.println("⚠️ MQTT not connected, skipping publish");
-      // Try to reconnect
-      connectMQTT();
-    }
-  }
-
-  // Handle WiFi connection loss
-  if (WiFi.status() != WL_CONNECTED && !isCaptivePortalRunning()) {
-    Serial.println("⚠️ WiFi connection lost, attempting to reconnect...");
-    WiFi.reconnect();
-    delay(1000);
-    
-    if (WiFi.status() == WL_CONNECTED) {
-      Serial.println("✅ WiFi reconnected!");
-      // Reinitialize NTP and MQTT
-      initNTP();
-      if (MQTT_SERVER.length() > 0) {
-        connectMQTT();
-      }
+      printWiFiConnectionStats();
+      printI2CBusStats();
     }
+  } else if (MQTT_SERVER.length() > 0 && millis() - lastMQTTPublish >= getReportInterval()) {
+    lastMQTTPublish = millis();
+    Serial.println("⚠️ MQTT not connected, skipping publish");
+    printMQTTConnectionStats();
   }
 
-  // Small delay to prevent overwhelming the system
-  delay(100);
+  // Small delay to prevent overwhelming the system; short while a sensor
+  // read is in flight so the ADS1115 sweep is not paced by the loop
+  delay(isSensorReadInProgress() ? LOOP_DELAY_SENSOR_BUSY_MS : LOOP_DELAY_MS);
 }
\ No newline at end of file
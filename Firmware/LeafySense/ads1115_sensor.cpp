@@ -1,55 +1,297 @@
 #include "ads1115_sensor.h"
 #include "config.h"
+#include "soil_filter.h"
+#include "soil_conversion.h"
+#include "i2c_bus.h"
 #include <Arduino.h>
 
-// Global ADS1115 object and data
-Adafruit_ADS1115 ads1115;
+// ADS1115 registers and config bits (datasheet section 8.6)
+#define ADS1115_REG_CONVERSION 0x00
+#define ADS1115_REG_CONFIG 0x01
+#define ADS1115_CONFIG_OS_SINGLE 0x8000   // Write: start a conversion, read: idle
+#define ADS1115_CONFIG_MUX_SINGLE 0x4000  // AINx vs GND, channel in bits 13:12
+#define ADS1115_CONFIG_MODE_SINGLE 0x0100
+#define ADS1115_CONFIG_COMP_DISABLE 0x0003
+
+// Every probe owns two scan slots: 2*p = moisture, 2*p + 1 = temperature
+#define MAX_SCAN_SLOTS (MAX_SOIL_PROBES * 2)
+
+// One ADS1115 on the bus and its share of the scan. Chips convert in
+// parallel, so a sweep takes as long as the busiest chip.
+struct ADS1115Chip {
+  uint8_t address;
+  bool found;
+  uint8_t slots[MAX_SCAN_SLOTS];  // Scan slots wired to this chip
+  uint8_t slotCount;
+  uint16_t cursor;                // Conversions finished this sweep
+  unsigned long conversionStart;
+  bool conversionStarted;         // Config write for the current conversion succeeded
+};
+
+// Global ADS1115 chips and data
+static ADS1115Chip chips[ADS1115_MAX_CHIPS];
+static uint8_t chipCount = 0;
 ADS1115_Data currentADS1115Data;
 
+// Filter pipeline per scan slot, and good conversions seen this sweep
+static SoilChannelFilter slotFilters[MAX_SCAN_SLOTS];
+static uint8_t sweepGoodSamples[MAX_SCAN_SLOTS];
+static uint8_t slotChannel[MAX_SCAN_SLOTS];
+
+// Scan engine state
+static ADS1115ScanState scanState = ADS_SCAN_IDLE;
+
+static bool writeRegister(uint8_t address, uint8_t reg, uint16_t value) {
+  const uint8_t buf[3] = {reg, (uint8_t)(value >> 8), (uint8_t)(value & 0xFF)};
+  return i2cWrite(address, buf, sizeof(buf));
+}
+
+static bool readRegister(uint8_t address, uint8_t reg, uint16_t& value) {
+  uint8_t buf[2];
+  if (!i2cWriteRead(address, &reg, 1, buf, sizeof(buf))) {
+    return false;
+  }
+  value = ((uint16_t)buf[0] << 8) | buf[1];
+  return true;
+}
+
+static ADS1115Chip* findChip(uint8_t address) {
+  for (uint8_t i = 0; i < chipCount; i++) {
+    if (chips[i].address == address) return &chips[i];
+  }
+  return nullptr;
+}
+
+static bool isValidProbe(const SoilProbeConfig& probe) {
+  return probe.chip_address >= 0x48 && probe.chip_address <= 0x4B &&
+         probe.moisture_channel < 4 && probe.temp_channel < 4;
+}
+
 bool initADS1115() {
   Serial.println("🔍 Initializing ADS1115 ADC...");
   
   // Initializing the struct with default values
+  if (SOIL_PROBE_COUNT > MAX_SOIL_PROBES) SOIL_PROBE_COUNT = MAX_SOIL_PROBES;
+  currentADS1115Data.probe_count = SOIL_PROBE_COUNT;
+  currentADS1115Data.chips_found = 0;
   currentADS1115Data.ads1115_found = false;
-  currentADS1115Data.last_error = "";
-  
-  // Initialize sensor1
-  currentADS1115Data.sensor1.raw_moisture = 0;
-  currentADS1115Data.sensor1.raw_temperature = 0;
-  currentADS1115Data.sensor1.moisture_percentage = 0.0;
-  currentADS1115Data.sensor1.temperature_celsius = 0.0;
-  currentADS1115Data.sensor1.sensor_working = false;
-  currentADS1115Data.sensor1.last_error = "Not initialized";
-  
-  // Initialize sensor2
-  currentADS1115Data.sensor2.raw_moisture = 0;
-  currentADS1115Data.sensor2.raw_temperature = 0;
-  currentADS1115Data.sensor2.moisture_percentage = 0.0;
-  currentADS1115Data.sensor2.temperature_celsius = 0.0;
-  currentADS1115Data.sensor2.sensor_working = false;
-  currentADS1115Data.sensor2.last_error = "Not initialized";
-  
-  if (!ads1115.begin(ADS1115_I2C_ADDRESS, &Wire)) {
-    currentADS1115Data.last_error = "Failed to find ADS1115 chip";
+  currentADS1115Data.error = SENSOR_ERR_NOT_INITIALIZED;
+  currentADS1115Data.timestamp = 0;
+  
+  for (uint8_t p = 0; p < MAX_SOIL_PROBES; p++) {
+    SoilSensorData& probe = currentADS1115Data.probes[p];
+    probe.raw_moisture = 0;
+    probe.raw_temperature = 0;
+    probe.moisture_percentage = 0.0;
+    probe.temperature_celsius = 0.0;
+    probe.sensor_working = false;
+    probe.error = SENSOR_ERR_NOT_INITIALIZED;
+    probe.error_detail = 0;
+  }
+  
+  // Build the chip list from the probe registry and assign scan slots
+  chipCount = 0;
+  for (uint8_t p = 0; p < SOIL_PROBE_COUNT; p++) {
+    const SoilProbeConfig& probe = SOIL_PROBES[p];
+    if (!isValidProbe(probe)) {
+      currentADS1115Data.probes[p].error = SENSOR_ERR_INVALID_PROBE;
+      Serial.println("⚠️ Soil probe " + String(p + 1) + " has an invalid chip address or channel");
+      continue;
+    }
+    
+    ADS1115Chip* chip = findChip(probe.chip_address);
+    if (chip == nullptr) {
+      if (chipCount >= ADS1115_MAX_CHIPS) {
+        currentADS1115Data.probes[p].error = SENSOR_ERR_TOO_MANY_CHIPS;
+        continue;
+      }
+      chip = &chips[chipCount++];
+      chip->address = probe.chip_address;
+      chip->found = false;
+      chip->slotCount = 0;
+    }
+    
+    uint8_t moistureSlot = p * 2;
+    uint8_t tempSlot = p * 2 + 1;
+    slotChannel[moistureSlot] = probe.moisture_channel;
+    slotChannel[tempSlot] = probe.temp_channel;
+    chip->slots[chip->slotCount++] = moistureSlot;
+    chip->slots[chip->slotCount++] = tempSlot;
+  }
+  
+  for (uint8_t i = 0; i < MAX_SCAN_SLOTS; i++) {
+    resetSoilFilter(slotFilters[i]);
+  }
+  
+  // Bring up every chip the registry refers to
+  for (uint8_t c = 0; c < chipCount; c++) {
+    ADS1115Chip& chip = chips[c];
+    uint16_t config;
+    if (!readRegister(chip.address, ADS1115_REG_CONFIG, config)) {
+      Serial.println("❌ ADS1115 at 0x" + String(chip.address, HEX) + " initialization failed!");
+      continue;
+    }
+    chip.found = true;
+    currentADS1115Data.chips_found++;
+    Serial.println("✅ ADS1115 at 0x" + String(chip.address, HEX) + " initialized (" + String(chip.slotCount) + " channels)");
+  }
+  
+  // Probes on a missing chip stay in the error state
+  for (uint8_t p = 0; p < SOIL_PROBE_COUNT; p++) {
+    ADS1115Chip* chip = findChip(SOIL_PROBES[p].chip_address);
+    if (chip != nullptr && chip->found) {
+      currentADS1115Data.probes[p].error = SENSOR_OK;
+    } else if (chip != nullptr) {
+      currentADS1115Data.probes[p].error = SENSOR_ERR_NOT_FOUND;
+      currentADS1115Data.probes[p].error_detail = SOIL_PROBES[p].chip_address;
+    }
+  }
+  
+  if (currentADS1115Data.chips_found == 0) {
+    currentADS1115Data.error = SENSOR_ERR_NOT_FOUND;
     currentADS1115Data.ads1115_found = false;
     Serial.println("❌ ADS1115 initialization failed!");
     Serial.println("   Please check wiring and I2C address");
     return false;
   }
   
-  ads1115.setGain(ADS1115_GAIN);
-  
   currentADS1115Data.ads1115_found = true;
-  currentADS1115Data.last_error = "";
-  currentADS1115Data.sensor1.last_error = "";
-  currentADS1115Data.sensor2.last_error = "";
+  currentADS1115Data.error = SENSOR_OK;
   
   Serial.println("✅ ADS1115 initialized successfully!");
+  Serial.println("   Chips: " + String(currentADS1115Data.chips_found) + "/" + String(chipCount) +
+                 ", Probes: " + String(SOIL_PROBE_COUNT));
   Serial.println("   Gain: TWOTHIRDS (±6.144V), Resolution: 0.1875mV");
+  Serial.println("   Data Rate: 128 SPS, non-blocking scan, chips converting in parallel");
+  Serial.println("   Filter: median-of-" + String(SOIL_FILTER_MEDIAN_SIZE) + ", " + String(SOIL_FILTER_OVERSAMPLE) +
+                 "x oversampling, EMA alpha " + String(SOIL_FILTER_EMA_ALPHA) + "/256");
+  return true;
+}
+
+// Each chip visits its slots SOIL_FILTER_OVERSAMPLE times, interleaved
+static uint16_t chipSweepConversions(const ADS1115Chip& chip) {
+  return chip.slotCount * SOIL_FILTER_OVERSAMPLE;
+}
+
+// Single-shot conversion; gain and data rate are written with every start.
+// Returns false if the config write failed, in which case the conversion
+// register still holds the previous (different) channel.
+static bool startChipConversion(ADS1115Chip& chip) {
+  uint8_t slot = chip.slots[chip.cursor % chip.slotCount];
+  uint16_t config = ADS1115_CONFIG_OS_SINGLE |
+                    ADS1115_CONFIG_MUX_SINGLE | ((uint16_t)slotChannel[slot] << 12) |
+                    ADS1115_GAIN |
+                    ADS1115_CONFIG_MODE_SINGLE |
+                    ADS1115_DATA_RATE |
+                    ADS1115_CONFIG_COMP_DISABLE;
+  chip.conversionStarted = writeRegister(chip.address, ADS1115_REG_CONFIG, config);
+  chip.conversionStart = micros();
+  return chip.conversionStarted;
+}
+
+// OS bit reads back as 1 once the single-shot conversion has finished
+static bool conversionComplete(const ADS1115Chip& chip) {
+  uint16_t config;
+  return readRegister(chip.address, ADS1115_REG_CONFIG, config) && (config & ADS1115_CONFIG_OS_SINGLE);
+}
+
+// Smoothed counts for a slot, or the error value if it produced nothing
+// usable during the last sweep
+static int16_t resultForSlot(uint8_t slot) {
+  if (sweepGoodSamples[slot] == 0 || !slotFilters[slot].ready) return 0x7FFF;
+  return soilFilterValue(slotFilters[slot]);
+}
+
+// Assemble a full ADS1115_Data record once every chip has finished its sweep
+static void finishSoilSensorSweep() {
+  ADS1115_Data& data = currentADS1115Data;
+  data.error = SENSOR_OK;
+  
+  for (uint8_t p = 0; p < SOIL_PROBE_COUNT; p++) {
+    ADS1115Chip* chip = findChip(SOIL_PROBES[p].chip_address);
+    if (!isValidProbe(SOIL_PROBES[p]) || chip == nullptr || !chip->found) {
+      continue;  // Keeps the error set at init
+    }
+    data.probes[p] = readSoilSensor(resultForSlot(p * 2), resultForSlot(p * 2 + 1), SOIL_PROBES[p]);
+  }
+  data.timestamp = millis();
+}
+
+void startSoilSensorScan() {
+  if (!currentADS1115Data.ads1115_found || scanState != ADS_SCAN_IDLE) {
+    return;
+  }
+  
+  for (uint8_t i = 0; i < MAX_SCAN_SLOTS; i++) {
+    sweepGoodSamples[i] = 0;
+  }
+  
+  for (uint8_t c = 0; c < chipCount; c++) {
+    chips[c].cursor = 0;
+    if (chips[c].found && chips[c].slotCount > 0) {
+      startChipConversion(chips[c]);
+    }
+  }
+  scanState = ADS_SCAN_CONVERTING;
+}
+
+// Advance the scan by at most one conversion per chip. Called on every
+// loop() pass; only touches the I2C bus once a conversion should be done.
+// Returns true when a full sweep has completed and currentADS1115Data is fresh.
+bool handleADS1115Scan() {
+  if (scanState == ADS_SCAN_IDLE) {
+    return false;
+  }
+  
+  bool sweepDone = true;
+  for (uint8_t c = 0; c < chipCount; c++) {
+    ADS1115Chip& chip = chips[c];
+    if (!chip.found || chip.cursor >= chipSweepConversions(chip)) {
+      continue;
+    }
+    sweepDone = false;
+    
+    unsigned long elapsed = micros() - chip.conversionStart;
+    if (elapsed < ADS1115_CONVERSION_TIME_US) {
+      continue;
+    }
+    
+    uint8_t slot = chip.slots[chip.cursor % chip.slotCount];
+    uint16_t raw;
+    if (!chip.conversionStarted) {
+      // Never started: counts as a failed conversion for this slot, and the
+      // stale conversion register must not reach its filter
+    } else if (conversionComplete(chip)) {
+      if (readRegister(chip.address, ADS1115_REG_CONVERSION, raw) && raw != 0x7FFF) { // 0x7FFF is reserved as the error value
+        soilFilterAddSample(slotFilters[slot], (int16_t)raw);
+        sweepGoodSamples[slot]++;
+      }
+    } else if (elapsed < ADS1115_CONVERSION_TIMEOUT_US) {
+      continue;
+    }
+    // A timed-out conversion is simply dropped; the filter keeps its state
+    
+    chip.cursor++;
+    if (chip.cursor < chipSweepConversions(chip)) {
+      startChipConversion(chip);
+    }
+  }
+  
+  if (!sweepDone) {
+    return false;
+  }
+  
+  scanState = ADS_SCAN_IDLE;
+  finishSoilSensorSweep();
   return true;
 }
 
-SoilSensorData readSoilSensor(uint8_t moisture_channel, uint8_t temp_channel, const char* sensor_name) {
+bool isSoilSensorScanRunning() {
+  return scanState != ADS_SCAN_IDLE;
+}
+
+// Convert one moisture/temperature pair of filtered counts into a reading
+SoilSensorData readSoilSensor(int16_t moisture_adc, int16_t temp_adc, const SoilProbeConfig& probe) {
   SoilSensorData data;
   
   // Initialize with default values
@@ -58,21 +300,20 @@ SoilSensorData readSoilSensor(uint8_t moisture_channel, uint8_t temp_channel, co
   data.moisture_percentage = 0.0;
   data.temperature_celsius = 0.0;
   data.sensor_working = true;
-  data.last_error = "";
+  data.error = SENSOR_OK;
+  data.error_detail = 0;
   
-  // Read soil moisture (raw ADC value)
-  int16_t moisture_adc = ads1115.readADC_SingleEnded(moisture_channel);
-  if (moisture_adc == 0x7FFF) { // Error value from library
+  if (moisture_adc == 0x7FFF) { // Error value from the scan engine
     data.sensor_working = false;
-    data.last_error = "Failed to read moisture channel " + String(moisture_channel);
+    data.error = SENSOR_ERR_MOISTURE_CHANNEL;
+    data.error_detail = probe.moisture_channel;
     return data;
   }
   
-  // Read soil temperature (raw ADC value)
-  int16_t temp_adc = ads1115.readADC_SingleEnded(temp_channel);
-  if (temp_adc == 0x7FFF) { // Error value from library
+  if (temp_adc == 0x7FFF) { // Error value from the scan engine
     data.sensor_working = false;
-    data.last_error = "Failed to read temperature channel " + String(temp_channel);
+    data.error = SENSOR_ERR_TEMP_CHANNEL;
+    data.error_detail = probe.temp_channel;
     return data;
   }
   
@@ -80,85 +321,28 @@ SoilSensorData readSoilSensor(uint8_t moisture_channel, uint8_t temp_channel, co
   data.raw_temperature = temp_adc;
   
   // Calculate moisture percentage
-  data.moisture_percentage = calculateMoisturePercentage(moisture_adc);
+  data.moisture_percentage = calculateMoisturePercentage(moisture_adc, probe.moisture_dry, probe.moisture_wet);
   
   // Calculate temperature using your working formula
   data.temperature_celsius = readTemperatureFromADC(temp_adc);
   
-  data.sensor_working = true;
-  data.last_error = "";
-  
   return data;
 }
 
+// Returns the latest completed sweep without touching the bus or the heap
 ADS1115_Data readAllSoilSensors() {
-  ADS1115_Data data;
-  data.ads1115_found = currentADS1115Data.ads1115_found;
-  data.last_error = "";
-  
-  if (!data.ads1115_found) {
-    data.last_error = "ADS1115 not initialized";
-    return data;
-  }
-  
-  // Read first soil sensor pair (A0 & A1)
-  data.sensor1 = readSoilSensor(SOIL_MOISTURE_1_CHANNEL, SOIL_TEMP_1_CHANNEL, "Soil Sensor 1");
-  
-  // Small delay between readings
-  delay(10);
-  
-  // Read second soil sensor pair (A2 & A3)  
-  data.sensor2 = readSoilSensor(SOIL_MOISTURE_2_CHANNEL, SOIL_TEMP_2_CHANNEL, "Soil Sensor 2");
-  
-  // Update global data
-  currentADS1115Data = data;
-  
-  return data;
+  return currentADS1115Data;
 }
 
-float calculateMoisturePercentage(int raw_value) {
-  // Capacitive soil moisture sensors typically read lower values when wet
-  // Invert and map to percentage
-  int inverted_value = SOIL_MOISTURE_DRY - raw_value;
-  int range = SOIL_MOISTURE_DRY - SOIL_MOISTURE_WET;
-  
-  // Avoid division by zero
-  if (range <= 0) range = 1;
-  
-  float percentage = (inverted_value * 100.0) / range;
-  
-  // Constrain to 0-100%
-  if (percentage < 0) percentage = 0;
-  if (percentage > 100) percentage = 100;
-  
-  return percentage;
+// Fixed-point path; see soil_conversion.cpp
+float calculateMoisturePercentage(int raw_value, int16_t dry, int16_t wet) {
+  return moistureCountsToCentiPercent(raw_value, dry, wet) * 0.01f;
 }
 
-// working temperature calculation function
+// Table lookup generated from the Beta equation at compile time.
+// Returns -100.0 for readings outside the divider's valid range.
 float readTemperatureFromADC(int16_t adcValue) {
-  // ADS1115 with GAIN_TWOTHIRDS: 1 LSB = 0.1875mV = 0.0001875V
-  float voltage = adcValue * 0.0001875; // V
-
-  // Avoid division by zero for invalid voltage readings
-  if (voltage >= VCC || voltage <= 0) {
-    return -100.0; // Error value
-  }
-
-  // Voltage divider: Vout = Vcc * (R_ntc / (R_ntc + R_fixed))
-  // Solve for R_ntc:
-  float R_ntc = (voltage * R_FIXED) / (VCC - voltage);
-
-  // Avoid invalid resistance values
-  if (R_ntc <= 0) {
-    return -100.0; // Error value
-  }
-
-  // Compute Temperature using Beta equation
-  float invT = (1.0 / T0) + (1.0 / BETA) * log(R_ntc / R0);
-  float T = 1.0 / invT;       // Kelvin
-  float tempC = T - 273.15;   // Celsius
-
-  return tempC;
+  return ntcCountsToCentiCelsius(adcValue) * 0.01f;
 }
 
 void printADS1115Data(const ADS1115_Data& data) {
@@ -169,31 +353,29 @@ void printADS1115Data(const ADS1115_Data& data) {
     return;
   }
   
-  if (!data.last_error.isEmpty()) {
-    Serial.println("   Status: Error - " + data.last_error);
+  if (data.error != SENSOR_OK) {
+    Serial.print("   Status: Error - ");
+    Serial.println(sensorErrorString(data.error));
     return;
   }
   
-  // Sensor 1 data (A0: Moisture, A1: Temperature)
-  Serial.println("🌱 Soil Sensor 1 (A0=Moisture, A1=Temp):");
-  if (data.sensor1.sensor_working) {
-    Serial.println("   Moisture - Raw: " + String(data.sensor1.raw_moisture) + 
-                   ", Percentage: " + String(data.sensor1.moisture_percentage, 1) + "%");
-    Serial.println("   Temperature - Raw: " + String(data.sensor1.raw_temperature) +
-                   ", Temp: " + String(data.sensor1.temperature_celsius, 1) + "°C");
-  } else {
-    Serial.println("   Status: ❌ " + data.sensor1.last_error);
-  }
-  
-  // Sensor 2 data (A2: Moisture, A3: Temperature)  
-  Serial.println("🌱 Soil Sensor 2 (A2=Moisture, A3=Temp):");
-  if (data.sensor2.sensor_working) {
-    Serial.println("   Moisture - Raw: " + String(data.sensor2.raw_moisture) + 
-                   ", Percentage: " + String(data.sensor2.moisture_percentage, 1) + "%");
-    Serial.println("   Temperature - Raw: " + String(data.sensor2.raw_temperature) +
-                   ", Temp: " + String(data.sensor2.temperature_celsius, 1) + "°C");
-  } else {
-    Serial.println("   Status: ❌ " + data.sensor2.last_error);
+  char errorText[SENSOR_ERROR_TEXT_MAX];
+  
+  for (uint8_t p = 0; p < data.probe_count; p++) {
+    const SoilSensorData& probe = data.probes[p];
+    const SoilProbeConfig& config = SOIL_PROBES[p];
+    Serial.println("🌱 Soil Sensor " + String(p + 1) + " (0x" + String(config.chip_address, HEX) +
+                   ": A" + String(config.moisture_channel) + "=Moisture, A" + String(config.temp_channel) + "=Temp):");
+    if (probe.sensor_working) {
+      Serial.println("   Moisture - Raw: " + String(probe.raw_moisture) + 
+                     ", Percentage: " + String(probe.moisture_percentage, 1) + "%");
+      Serial.println("   Temperature - Raw: " + String(probe.raw_temperature) +
+                     ", Temp: " + String(probe.temperature_celsius, 1) + "°C");
+    } else {
+      formatSensorError(errorText, sizeof(errorText), probe.error, probe.error_detail);
+      Serial.print("   Status: ❌ ");
+      Serial.println(errorText);
+    }
   }
   
   Serial.println("====================================");
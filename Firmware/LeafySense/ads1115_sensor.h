@@ -2,32 +2,50 @@
 #ifndef ADS1115_SENSOR_H
 #define ADS1115_SENSOR_H
 
-#include <Wire.h>
-#include <Adafruit_ADS1X15.h>
+#include <Arduino.h>
+#include "config.h"
+#include "sensor_status.h"
+#include <type_traits>
 
 // Soil sensor data structure
 struct SoilSensorData {
-  int raw_moisture;
-  int raw_temperature;
+  int16_t raw_moisture;
+  int16_t raw_temperature;
   float moisture_percentage;
   float temperature_celsius;
-  bool sensor_working;
-  String last_error;
+  SensorError error;        // SENSOR_OK while the probe reads normally
+  uint8_t error_detail;     // Channel or I2C address the error refers to
+  bool sensor_working : 1;
 };
 
-// ADS1115 data structure
+// ADS1115 data structure, indexed the same way as SOIL_PROBES
 struct ADS1115_Data {
-  SoilSensorData sensor1;  // A0 (moisture) & A1 (temp)
-  SoilSensorData sensor2;  // A2 (moisture) & A3 (temp)
-  bool ads1115_found;
-  String last_error;
+  SoilSensorData probes[MAX_SOIL_PROBES];
+  uint8_t probe_count;
+  uint8_t chips_found;      // ADS1115 chips that answered at init
+  SensorError error;        // Whole-ADC error, SENSOR_OK if any chip works
+  bool ads1115_found : 1;   // At least one chip is working
+  unsigned long timestamp;  // millis() when the last sweep completed
+};
+
+// Returned by value every cycle, so they must stay plain copies
+static_assert(std::is_trivially_copyable<SoilSensorData>::value, "SoilSensorData must stay POD");
+static_assert(std::is_trivially_copyable<ADS1115_Data>::value, "ADS1115_Data must stay POD");
+
+// Non-blocking scan engine states
+enum ADS1115ScanState {
+  ADS_SCAN_IDLE,
+  ADS_SCAN_CONVERTING
 };
 
 // Function declarations
 bool initADS1115();
+void startSoilSensorScan();
+bool handleADS1115Scan();
+bool isSoilSensorScanRunning();
 ADS1115_Data readAllSoilSensors();
-SoilSensorData readSoilSensor(uint8_t moisture_channel, uint8_t temp_channel, const char* sensor_name);
-float calculateMoisturePercentage(int raw_value);
+SoilSensorData readSoilSensor(int16_t moisture_adc, int16_t temp_adc, const SoilProbeConfig& probe);
+float calculateMoisturePercentage(int raw_value, int16_t dry, int16_t wet);
 float readTemperatureFromADC(int16_t adcValue);
 void printADS1115Data(const ADS1115_Data& data);
 
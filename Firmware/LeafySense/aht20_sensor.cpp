@@ -1,20 +1,41 @@
 #include "aht20_sensor.h"
 #include "config.h"
+#include "i2c_bus.h"
 #include <Arduino.h>
 
-// Global sensor object and data
-Adafruit_AHTX0 aht;
-AHT20_Data currentAHT20Data = {0.0, 0.0, false, ""};
+// AHT20 command bytes (datasheet section 5.4)
+#define AHT20_CMD_TRIGGER 0xAC
+#define AHT20_CMD_CALIBRATE 0xBE
+#define AHT20_CMD_SOFT_RESET 0xBA
+#define AHT20_STATUS_BUSY 0x80
+#define AHT20_STATUS_CALIBRATED 0x08
+
+// Global sensor data
+AHT20_Data currentAHT20Data = {0.0, 0.0, SENSOR_ERR_NOT_INITIALIZED, false, 0};
+
+// Measurement state
+static AHT20State aht20State = AHT20_IDLE;
+static unsigned long measurementStart = 0;
 
 bool initAHT20() {
   Serial.println("🔍 Initializing AHT20 sensor...");
   
-  // Initialize I2C
-  Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN, I2C_FREQUENCY);
+  // Soft reset, then make sure the calibration bit is set (blocking at boot only)
+  const uint8_t reset[] = {AHT20_CMD_SOFT_RESET};
+  uint8_t status = 0;
+  bool found = i2cWrite(AHT20_I2C_ADDRESS, reset, sizeof(reset));
+  if (found) {
+    delay(20);
+    found = i2cRead(AHT20_I2C_ADDRESS, &status, 1);
+  }
+  if (found && !(status & AHT20_STATUS_CALIBRATED)) {
+    const uint8_t calibrate[] = {AHT20_CMD_CALIBRATE, 0x08, 0x00};
+    found = i2cWrite(AHT20_I2C_ADDRESS, calibrate, sizeof(calibrate));
+    delay(10);
+  }
   
-  // Try to initialize the sensor
-  if (!aht.begin()) {
-    currentAHT20Data.last_error = "Failed to find AHT20 chip";
+  if (!found) {
+    currentAHT20Data.error = SENSOR_ERR_NOT_FOUND;
     currentAHT20Data.sensor_found = false;
     Serial.println("❌ AHT20 initialization failed!");
     Serial.println("   Please check wiring: SDA->GPIO" + String(I2C_SDA_PIN) + ", SCL->GPIO" + String(I2C_SCL_PIN));
@@ -22,35 +43,101 @@ bool initAHT20() {
   }
   
   currentAHT20Data.sensor_found = true;
-  currentAHT20Data.last_error = "";
+  currentAHT20Data.error = SENSOR_OK;
   Serial.println("✅ AHT20 sensor initialized successfully!");
   return true;
 }
 
-AHT20_Data readAHT20() {
-  AHT20_Data data = {0.0, 0.0, currentAHT20Data.sensor_found, ""};
+// CRC-8, polynomial 0x31, initial value 0xFF (datasheet section 5.4)
+static uint8_t aht20CRC8(const uint8_t* data, uint8_t len) {
+  uint8_t crc = 0xFF;
+  for (uint8_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; b++) {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+// Send the trigger command and return immediately. The result is collected
+// by handleAHT20() on a later loop() pass.
+bool startAHT20Measurement() {
+  if (!currentAHT20Data.sensor_found || aht20State != AHT20_IDLE) {
+    return false;
+  }
   
-  if (!data.sensor_found) {
-    data.last_error = "Sensor not initialized";
-    return data;
+  const uint8_t trigger[] = {AHT20_CMD_TRIGGER, 0x33, 0x00};
+  if (!i2cWrite(AHT20_I2C_ADDRESS, trigger, sizeof(trigger))) {
+    currentAHT20Data.error = SENSOR_ERR_TRIGGER_FAILED;
+    return false;
+  }
+  
+  measurementStart = millis();
+  aht20State = AHT20_MEASURING;
+  return true;
+}
+
+// Poll the status byte once the conversion should be done and harvest the
+// result. Never waits; returns true when the measurement has finished,
+// successfully or not: currentAHT20Data then holds either a new sample or
+// the error that ended it.
+bool handleAHT20() {
+  if (aht20State != AHT20_MEASURING) {
+    return false;
   }
   
-  sensors_event_t humidity, temp;
+  unsigned long elapsed = millis() - measurementStart;
+  if (elapsed < AHT20_MEASUREMENT_TIME_MS) {
+    return false;
+  }
   
-  if (!aht.getEvent(&humidity, &temp)) {
-    data.last_error = "Failed to read data from AHT20";
+  // Status byte, 5 data bytes, CRC
+  uint8_t buf[7];
+  if (!i2cRead(AHT20_I2C_ADDRESS, buf, sizeof(buf))) {
+    aht20State = AHT20_IDLE;
+    currentAHT20Data.error = SENSOR_ERR_READ_FAILED;
     Serial.println("❌ Failed to read data from AHT20");
-    return data;
+    return true;
+  }
+  
+  if (buf[0] & AHT20_STATUS_BUSY) {
+    if (elapsed >= AHT20_MEASUREMENT_TIMEOUT_MS) {
+      aht20State = AHT20_IDLE;
+      currentAHT20Data.error = SENSOR_ERR_TIMEOUT;
+      Serial.println("❌ AHT20 measurement timed out");
+      return true;
+    }
+    return false;
+  }
+  
+  aht20State = AHT20_IDLE;
+  
+  if (aht20CRC8(buf, 6) != buf[6]) {
+    currentAHT20Data.error = SENSOR_ERR_CRC_MISMATCH;
+    Serial.println("❌ AHT20 CRC mismatch");
+    return true;
   }
   
-  data.temperature = temp.temperature;
-  data.humidity = humidity.relative_humidity;
-  data.last_error = "";
+  // 20-bit humidity and temperature, packed across bytes 1-5
+  uint32_t rawHumidity = ((uint32_t)buf[1] << 12) | ((uint32_t)buf[2] << 4) | (buf[3] >> 4);
+  uint32_t rawTemperature = ((uint32_t)(buf[3] & 0x0F) << 16) | ((uint32_t)buf[4] << 8) | buf[5];
   
-  // Update global data
-  currentAHT20Data = data;
+  currentAHT20Data.humidity = rawHumidity * 100.0f / 1048576.0f;
+  currentAHT20Data.temperature = rawTemperature * 200.0f / 1048576.0f - 50.0f;
+  currentAHT20Data.error = SENSOR_OK;
+  currentAHT20Data.timestamp = millis();
   
-  return data;
+  return true;
+}
+
+bool isAHT20Measuring() {
+  return aht20State != AHT20_IDLE;
+}
+
+// Returns the latest harvested sample without touching the bus or the heap
+AHT20_Data readAHT20() {
+  return currentAHT20Data;
 }
 
 void printAHT20Data(const AHT20_Data& data) {
@@ -61,8 +148,9 @@ void printAHT20Data(const AHT20_Data& data) {
     return;
   }
   
-  if (!data.last_error.isEmpty()) {
-    Serial.println("   Status: Error - " + data.last_error);
+  if (data.error != SENSOR_OK) {
+    Serial.print("   Status: Error - ");
+    Serial.println(sensorErrorString(data.error));
     return;
   }
   
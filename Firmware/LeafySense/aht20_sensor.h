@@ -1,19 +1,32 @@
 #ifndef AHT20_SENSOR_H
 #define AHT20_SENSOR_H
 
-#include <Wire.h>
-#include <Adafruit_AHTX0.h>
+#include <Arduino.h>
+#include "sensor_status.h"
+#include <type_traits>
 
 // Data structure to hold sensor readings and status
 struct AHT20_Data {
   float temperature;
   float humidity;
-  bool sensor_found;
-  String last_error;
+  SensorError error;        // SENSOR_OK when temperature/humidity are valid
+  bool sensor_found : 1;
+  unsigned long timestamp;  // millis() when the sample was harvested
+};
+
+static_assert(std::is_trivially_copyable<AHT20_Data>::value, "AHT20_Data must stay POD");
+
+// Split-phase measurement states
+enum AHT20State {
+  AHT20_IDLE,
+  AHT20_MEASURING
 };
 
 // Function declarations
 bool initAHT20();
+bool startAHT20Measurement();
+bool handleAHT20();
+bool isAHT20Measuring();
 AHT20_Data readAHT20();
 void printAHT20Data(const AHT20_Data& data);
 
@@ -0,0 +1,135 @@
+#include "command_handler.h"
+#include "config.h"
+#include "sensor_manager.h"
+#include "report_policy.h"
+#include "mqtt_manager.h"
+#include <Arduino.h>
+#include <stdlib.h>
+
+// Commands are copied out of the MQTT callback into fixed slots and run
+// from loop(), one per pass, so a flood of messages costs at most one
+// copy each and can never hold up sampling
+struct CommandSlot {
+  uint8_t length;
+  char text[COMMAND_MAX_LENGTH + 1];
+};
+
+static CommandSlot commandQueue[COMMAND_QUEUE_DEPTH];
+static uint8_t queueHead = 0;
+static uint8_t queueCount = 0;
+static CommandStats stats = {};
+static char resultBuffer[96];
+
+// Called from the MQTT callback. Never parses, only copies.
+bool queueCommand(const uint8_t* payload, unsigned int length) {
+  if (length == 0 || length > COMMAND_MAX_LENGTH) {
+    stats.rejected++;
+    return false;
+  }
+  if (queueCount == COMMAND_QUEUE_DEPTH) {
+    stats.dropped++;
+    return false;
+  }
+  
+  CommandSlot& slot = commandQueue[(queueHead + queueCount) % COMMAND_QUEUE_DEPTH];
+  memcpy(slot.text, payload, length);
+  slot.text[length] = '\0';
+  slot.length = length;
+  queueCount++;
+  stats.received++;
+  return true;
+}
+
+// Splits off the next space-separated token in place; nullptr at the end
+static char* nextToken(char*& cursor) {
+  while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r' || *cursor == '\n') cursor++;
+  if (*cursor == '\0') return nullptr;
+  
+  char* token = cursor;
+  while (*cursor != '\0' && *cursor != ' ' && *cursor != '\t' && *cursor != '\r' && *cursor != '\n') cursor++;
+  if (*cursor != '\0') *cursor++ = '\0';
+  return token;
+}
+
+// Parses a whole token as a decimal number within [minValue, maxValue]
+static bool parseBounded(const char* token, unsigned long minValue, unsigned long maxValue, unsigned long& value) {
+  if (token == nullptr || *token < '0' || *token > '9') return false;
+  char* end;
+  value = strtoul(token, &end, 10);
+  return *end == '\0' && value >= minValue && value <= maxValue;
+}
+
+static void reply(bool ok, const char* format, unsigned long a = 0, unsigned long b = 0) {
+  int used = snprintf(resultBuffer, sizeof(resultBuffer), "%s ", ok ? "ok" : "error");
+  snprintf(resultBuffer + used, sizeof(resultBuffer) - used, format, a, b);
+  if (ok) {
+    stats.executed++;
+  } else {
+    stats.rejected++;
+  }
+  Serial.println(String(ok ? "🛰️ Command: " : "⚠️ Command: ") + resultBuffer);
+  publishCommandResult(resultBuffer);
+}
+
+static void executeCommand(char* text) {
+  char* cursor = text;
+  char* verb = nextToken(cursor);
+  char* arg1 = nextToken(cursor);
+  char* arg2 = nextToken(cursor);
+  unsigned long value, interval;
+  
+  if (verb == nullptr) {
+    reply(false, "empty command");
+  } else if (strcmp(verb, "read") == 0) {
+    requestImmediateSample();
+    reply(true, "read");
+  } else if (strcmp(verb, "burst") == 0) {
+    if (arg1 != nullptr && strcmp(arg1, "stop") == 0) {
+      stopSensorBurst();
+      reply(true, "burst stopped");
+    } else if (!parseBounded(arg1, 1, BURST_MAX_DURATION, value)) {
+      reply(false, "burst duration must be 1-%lu s", BURST_MAX_DURATION);
+    } else if (arg2 != nullptr && !parseBounded(arg2, BURST_MIN_INTERVAL, COMMAND_SAMPLE_INTERVAL_MAX, interval)) {
+      reply(false, "burst interval must be >= %lu ms", BURST_MIN_INTERVAL);
+    } else {
+      if (arg2 == nullptr) interval = BURST_DEFAULT_INTERVAL;
+      startSensorBurst(value * 1000UL, interval);
+      reply(true, "burst %lu s every %lu ms", value, interval);
+    }
+  } else if (strcmp(verb, "sample") == 0) {
+    if (parseBounded(arg1, COMMAND_SAMPLE_INTERVAL_MIN, COMMAND_SAMPLE_INTERVAL_MAX, value)) {
+      setSensorReadInterval(value);
+      publishDeviceInfo();
+      reply(true, "sample %lu ms", value);
+    } else {
+      reply(false, "sample interval must be %lu-%lu ms", COMMAND_SAMPLE_INTERVAL_MIN, COMMAND_SAMPLE_INTERVAL_MAX);
+    }
+  } else if (strcmp(verb, "publish") == 0) {
+    if (parseBounded(arg1, COMMAND_PUBLISH_INTERVAL_MIN, COMMAND_PUBLISH_INTERVAL_MAX, value)) {
+      setReportInterval(value);
+      publishDeviceInfo();
+      reply(true, "publish %lu ms", value);
+    } else {
+      reply(false, "publish interval must be %lu-%lu ms", COMMAND_PUBLISH_INTERVAL_MIN, COMMAND_PUBLISH_INTERVAL_MAX);
+    }
+  } else if (strcmp(verb, "status") == 0) {
+    reply(true, isSensorBurstActive() ? "sample %lu ms, publish %lu ms, burst running" : "sample %lu ms, publish %lu ms",
+          getSensorReadInterval(), getReportInterval());
+  } else {
+    reply(false, "unknown command");
+  }
+}
+
+// Runs at most one queued command per call
+void handleCommands() {
+  if (queueCount == 0) return;
+  
+  CommandSlot& slot = commandQueue[queueHead];
+  queueHead = (queueHead + 1) % COMMAND_QUEUE_DEPTH;
+  queueCount--;
+  executeCommand(slot.text);
+}
+
+const CommandStats& getCommandStats() {
+  return stats;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+// command_handler.h
+#ifndef COMMAND_HANDLER_H
+#define COMMAND_HANDLER_H
+
+#include <Arduino.h>
+
+// Commands arrive as plain text on <prefix>/<device>/cmd, one per message.
+// Each one is answered on <prefix>/<device>/cmd/result with "ok ..." or
+// "error ...".
+//
+//   read                      Read every sensor now and publish the result
+//   burst <s> [interval_ms]   Sample every interval_ms (default
+//                             BURST_DEFAULT_INTERVAL) for <s> seconds and
+//                             publish every sample
+//   burst stop                End a running burst
+//   sample <ms>               Change the sensor read interval
+//   publish <ms>              Change the publish interval (the heartbeat in
+//                             deadband mode)
+//   status                    Report the current cadence
+//
+// Runtime changes are not persisted and revert to config.h on reboot.
+
+struct CommandStats {
+  uint32_t received;   // Accepted into the queue
+  uint32_t executed;   // Parsed and applied
+  uint32_t rejected;   // Too long, unknown or out of range
+  uint32_t dropped;    // Arrived while the queue was full
+};
+
+// Function declarations
+bool queueCommand(const uint8_t* payload, unsigned int length);
+void handleCommands();
+const CommandStats& getCommandStats();
+
+#endif
\ No newline at end of file
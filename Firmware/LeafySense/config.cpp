@@ -4,12 +4,12 @@
 String WIFI_SSID = "";
 String WIFI_PASSWORD = "";
 
-// NTC Thermistor Configuration
-const float R_FIXED = 10000.0;    // 10K series resistor
-const float BETA = 3950.0;        // B-constant for B3950 NTC
-const float T0 = 298.15;          // 25°C in Kelvin (298.15K = 25°C)
-const float R0 = 10000.0;         // 10K at 25°C
-const float VCC = 3.3;            // System voltage
+// Soil Probe Registry - the two onboard probes; extend for external boards
+SoilProbeConfig SOIL_PROBES[MAX_SOIL_PROBES] = {
+  {ADS1115_I2C_ADDRESS, SOIL_MOISTURE_1_CHANNEL, SOIL_TEMP_1_CHANNEL, SOIL_MOISTURE_DRY, SOIL_MOISTURE_WET},
+  {ADS1115_I2C_ADDRESS, SOIL_MOISTURE_2_CHANNEL, SOIL_TEMP_2_CHANNEL, SOIL_MOISTURE_DRY, SOIL_MOISTURE_WET},
+};
+uint8_t SOIL_PROBE_COUNT = 2;
 
 // MQTT Configuration - will be set via captive portal
 String MQTT_SERVER = "";
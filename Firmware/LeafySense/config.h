@@ -8,6 +8,25 @@
 #define WIFI_AP_IP "192.168.4.1"
 #define CAPTIVE_PORTAL_DNS "setup.smartgarden"
 
+// Web Server (ESPAsyncWebServer; handlers run on the AsyncTCP task)
+#define WEB_SERVER_PORT 80
+#define WEB_RESTART_DELAY 2000           // Lets the /save response reach the browser before restarting (ms)
+#define SENSOR_API_STREAMS 2             // /api/v1/sensors responses in progress at once (~0.6 KB static each)
+#define SENSOR_API_LINE_MAX 384          // Render buffer per response; fits the longest JSON section
+#define HISTORY_API_STREAMS 1            // /api/v1/history responses in progress at once (~0.3 KB static each)
+
+// WiFi Station (event-driven state machine in wifi_manager.cpp)
+#define WIFI_CONNECT_TIMEOUT 15000       // Abandon an association attempt with no IP after this (ms)
+#define WIFI_RECONNECT_MIN_MS 1000       // First retry delay after a failed attempt
+#define WIFI_RECONNECT_MAX_MS 60000      // Backoff doubles up to this
+#define WIFI_RECONNECT_JITTER_PCT 25     // Each delay is randomized by +/- this percent
+#define WIFI_BOOT_PORTAL_TIMEOUT 10000   // Start the captive portal if the first connection after boot takes longer
+
+// WiFi Fast Reconnect (last BSSID/channel/lease kept in the "wifi-config" preferences)
+#define WIFI_FAST_RECONNECT 1            // Join the cached BSSID on its channel without scanning
+#define WIFI_FAST_CONNECT_TIMEOUT 5000   // Fall back to a full scan if the fast join has no IP by then (ms)
+#define WIFI_REUSE_DHCP_LEASE 1          // Reuse the last DHCP address without asking DHCP (it is not renewed with the router)
+
 // Reset Button Configuration
 #define RESET_BUTTON_PIN 9
 #define RESET_HOLD_TIME 5000    // 5 seconds
@@ -19,12 +38,26 @@ extern String WIFI_PASSWORD;
 // I2C Configuration for AHT20 and ADS1115
 #define I2C_SDA_PIN 6
 #define I2C_SCL_PIN 7
-#define I2C_FREQUENCY 100000  // 100kHz
+#define I2C_FREQUENCY 400000  // 400kHz fast mode (AHT20 and ADS1115 both support it)
+
+// I2C Bus Manager
+#define I2C_TIMEOUT_MS 20                  // Upper bound for any single transaction
+#define I2C_MAX_DEVICES 8                  // Addresses tracked for error/latency counters
+#define I2C_RECOVERY_ERROR_THRESHOLD 3     // Consecutive errors before clocking out the bus
+#define I2C_RECOVERY_MIN_INTERVAL_MS 1000  // At most one bus recovery per second
+#define I2C_DEVICE_SUSPEND_THRESHOLD 5     // Consecutive errors before a device backs off
+#define I2C_DEVICE_BACKOFF_MS 10000        // Skip a failing device for 10 seconds
+
+// AHT20 Configuration (split-phase trigger/poll driver)
+#define AHT20_I2C_ADDRESS 0x38           // Fixed I2C address
+#define AHT20_MEASUREMENT_TIME_MS 80     // Datasheet conversion time
+#define AHT20_MEASUREMENT_TIMEOUT_MS 250 // Give up if still busy after this
 
 // ADS1115 Configuration
-#define ADS1115_I2C_ADDRESS 0x48  // Default I2C address
+#define ADS1115_I2C_ADDRESS 0x48  // Default I2C address (onboard chip)
+#define ADS1115_MAX_CHIPS 4       // 0x48-0x4B (ADDR pin to GND/VDD/SDA/SCL)
 
-// ADS1115 Channel Assignments
+// ADS1115 Channel Assignments (onboard probes, used by the default registry)
 #define SOIL_MOISTURE_1_CHANNEL 0  // A0 - First soil moisture sensor
 #define SOIL_TEMP_1_CHANNEL 1      // A1 - First soil temperature (NTC thermistor)
 #define SOIL_MOISTURE_2_CHANNEL 2  // A2 - Second soil moisture sensor  
@@ -34,15 +67,42 @@ extern String WIFI_PASSWORD;
 #define SOIL_MOISTURE_DRY 25000    // ADC value when dry - will need calibration
 #define SOIL_MOISTURE_WET 15000    // ADC value when wet - will need calibration
 
+// Soil Probe Registry - one entry per moisture/temperature probe pair
+#define MAX_SOIL_PROBES 8
+
+struct SoilProbeConfig {
+  uint8_t chip_address;      // ADS1115 I2C address, 0x48-0x4B
+  uint8_t moisture_channel;  // A0-A3
+  uint8_t temp_channel;      // A0-A3
+  int16_t moisture_dry;      // ADC value when dry
+  int16_t moisture_wet;      // ADC value when wet
+};
+
+extern SoilProbeConfig SOIL_PROBES[MAX_SOIL_PROBES];
+extern uint8_t SOIL_PROBE_COUNT;
+
 // NTC Thermistor Configuration
-extern const float R_FIXED;        // 10K series resistor
-extern const float BETA;           // B-constant for B3950 NTC
-extern const float T0;             // 25°C in Kelvin (298.15K = 25°C)
-extern const float R0;             // 10K at 25°C
-extern const float VCC;            // System voltage
+// constexpr so the soil temperature lookup table (soil_conversion.h) is
+// regenerated at compile time whenever one of these changes
+constexpr double R_FIXED = 10000.0;    // 10K series resistor
+constexpr double BETA = 3950.0;        // B-constant for B3950 NTC
+constexpr double T0 = 298.15;          // 25°C in Kelvin (298.15K = 25°C)
+constexpr double R0 = 10000.0;         // 10K at 25°C
+constexpr double VCC = 3.3;            // System voltage
+
+// ADS1115 Gain Settings (config register PGA bits)
+#define ADS1115_GAIN 0x0000  // ±6.144V range (187.5µV per bit)
+constexpr double ADS1115_VOLTS_PER_COUNT = 0.0001875;  // Must match ADS1115_GAIN
+
+// ADS1115 Scan Engine (non-blocking, one conversion in flight per chip)
+#define ADS1115_DATA_RATE 0x0080                // Config register DR bits: 128 SPS
+#define ADS1115_CONVERSION_TIME_US 8000         // 1/128 SPS = 7.8ms, rounded up
+#define ADS1115_CONVERSION_TIMEOUT_US 50000     // Give up on a channel after 50ms
 
-// ADS1115 Gain Settings
-#define ADS1115_GAIN GAIN_TWOTHIRDS  // ±6.144V range (187.5µV per bit)
+// Soil Channel Filter (raw ADC -> median-of-k -> oversample/decimate -> EMA)
+#define SOIL_FILTER_MEDIAN_SIZE 3    // Spike rejection window, odd, 1 = off (max 7)
+#define SOIL_FILTER_OVERSAMPLE 4     // Conversions averaged per channel per sweep
+#define SOIL_FILTER_EMA_ALPHA 64     // Weight of each new sample in 1/256 (256 = off)
 
 // WS2812B LED Configuration
 #define WS2812B_PIN 3
@@ -55,15 +115,98 @@ extern String MQTT_USER;          // Change from const char*
 extern String MQTT_PASSWORD;      // Change from const char*
 extern String MQTT_CLIENT_ID;     // Change from const char*
 extern String MQTT_TOPIC_PREFIX;  // Change from const char*
+#define MQTT_BUFFER_SIZE 1280      // PubSubClient packet buffer (default 256 is too small for the JSON)
+#define MQTT_TOPIC_MAX 96          // Longest topic, built once per connection
+#define MQTT_INDIVIDUAL_TOPICS 1   // 0 = publish only the combined JSON message
+#define MQTT_HEALTH_INTERVAL 300000 // Link-quality message on <prefix>/<device>/health (ms)
+
+// MQTT Reconnect (non-blocking state machine in mqtt_manager.cpp)
+#define MQTT_RECONNECT_MIN_MS 1000       // First retry delay after a failed attempt
+#define MQTT_RECONNECT_MAX_MS 60000      // Backoff doubles up to this
+#define MQTT_RECONNECT_JITTER_PCT 25     // Each delay is randomized by +/- this percent
+#define MQTT_DNS_TIMEOUT 6000            // Give up on a pending broker name lookup after this (ms)
+#define MQTT_TCP_CONNECT_TIMEOUT 5000    // Give up on a pending TCP connect after this (ms)
+#define MQTT_CONNACK_TIMEOUT 5000        // Give up waiting for CONNACK once CONNECT is sent (ms)
+#define MQTT_KEEPALIVE 60                // Seconds; sent in CONNECT, PubSubClient pings at this rate
+#define MQTT_SOCKET_TIMEOUT 2            // Seconds PubSubClient waits for the rest of a partly received packet
+
+// Telemetry Codec for the combined sensors message (telemetry_codec.h)
+#define TELEMETRY_CODEC_JSON 0           // Readable JSON on <prefix>/<device>/sensors
+#define TELEMETRY_CODEC_CBOR 1           // Compact CBOR, schema-versioned, on <prefix>/<device>/sensors/cbor
+#define TELEMETRY_CODEC TELEMETRY_CODEC_JSON
+
+// MQTT Outbound Queue (QoS1, mqtt_queue.h) - ~11 KB static with these values
+#define MQTT_DROP_OLDEST 0               // Full queue evicts the oldest message
+#define MQTT_DROP_NEWEST 1               // Full queue rejects the new message
+#define MQTT_DROP_COALESCE 2             // Newer message replaces an unsent one on its topic, else drop oldest
+#define MQTT_QUEUE_DROP_POLICY MQTT_DROP_COALESCE
+#define MQTT_QUEUE_DEPTH 8               // Messages held until acknowledged
+#define MQTT_QUEUE_PAYLOAD_MAX 1280      // Largest queued payload; JSON with 8 probes is ~1.1 KB
+#define MQTT_QUEUE_MAX_INFLIGHT 2        // Unacknowledged messages on the wire at once
+#define MQTT_QUEUE_ACK_TIMEOUT 10000     // Resend with DUP if no PUBACK after this (ms)
 
 // NTP Configuration
 extern const char* NTP_SERVER;
 extern const long GMT_OFFSET_SEC;
 extern const int DAYLIGHT_OFFSET_SEC;
+#define NTP_SYNC_TIMEOUT 10000           // Report a failed sync if no valid time arrives within this (ms)
+#define NTP_MIN_VALID_EPOCH 1700000000   // Clock values below this mean SNTP has not answered yet
 
 // Sensor Reading Intervals
 #define SENSOR_READ_INTERVAL 5000    // Read sensors every 5 seconds
 #define MQTT_PUBLISH_INTERVAL 30000  // Publish to MQTT every 30 seconds
+#define SENSOR_CACHE_MAX_AGE 15000   // Force a fresh read if the cached sample is older
+#define LOOP_DELAY_MS 100            // loop() pause while no sensor read is running
+#define LOOP_DELAY_SENSOR_BUSY_MS 2  // Shorter pause during a read, so each ADS1115 conversion is collected when it finishes
+
+// MQTT Command Channel (<prefix>/<device>/cmd, command_handler.h)
+#define COMMAND_MAX_LENGTH 63              // Longer payloads are rejected unparsed
+#define COMMAND_QUEUE_DEPTH 4              // Commands waiting for loop(); more are dropped
+#define COMMAND_SAMPLE_INTERVAL_MIN 1000   // Bounds for "sample <ms>"
+#define COMMAND_SAMPLE_INTERVAL_MAX 3600000
+#define COMMAND_PUBLISH_INTERVAL_MIN 5000  // Bounds for "publish <ms>"
+#define COMMAND_PUBLISH_INTERVAL_MAX 86400000
+#define BURST_DEFAULT_INTERVAL 1000        // Burst sampling period unless given (ms)
+#define BURST_MIN_INTERVAL 500             // Fastest burst. A full read is one sweep per chip, run in parallel:
+                                           // 4 slots x SOIL_FILTER_OVERSAMPLE conversions x ~8 ms ≈ 130-170 ms
+                                           // at LOOP_DELAY_SENSOR_BUSY_MS polling (AHT20's 80 ms overlaps it)
+#define BURST_MAX_DURATION 600             // Longest burst (s)
+
+// Memory Monitor (memory_monitor.h) - thresholds raise a warning flag
+#define MEMORY_CHECK_INTERVAL 5000          // Heap/stack sampling period (ms)
+#define MEMORY_MAX_TASKS 20                 // Tasks covered by the stack report
+#define MEMORY_WARN_FREE_HEAP 40000         // Bytes
+#define MEMORY_WARN_LARGEST_BLOCK 24576     // Bytes; a TLS handshake needs ~16 KB contiguous
+#define MEMORY_WARN_STACK_FREE 1024         // Bytes left on any task stack
+
+// Sample History (sensor_history.h) - static RAM, see the budget there
+#define HISTORY_MAX_PROBES 2         // Soil probes kept in RAM history (the onboard pair); the sample log keeps all
+#define HISTORY_RAW_SAMPLES (3600000UL / SENSOR_READ_INTERVAL)  // Last hour at the read interval
+#define HISTORY_MINUTE_SLOTS 360     // 6 hours of 1-minute rollups
+#define HISTORY_HOUR_SLOTS 168       // 7 days of 1-hour rollups
+#define HISTORY_RAM_BUDGET 40960     // Build fails if the history outgrows this
+
+// Sample Log (LittleFS store-and-forward, sample_log.h)
+#define SAMPLE_LOG_DIR "/log"
+#define SAMPLE_LOG_SEGMENT_RECORDS 256     // Records per segment file (~13 KB, every probe up to MAX_SOIL_PROBES)
+#define SAMPLE_LOG_MAX_SEGMENTS 52         // Oldest segment is dropped beyond this (~18 h at 5 s, ~680 KB)
+#define SAMPLE_LOG_FLUSH_RECORDS 12        // Buffer this many records in RAM between flash writes
+#define SAMPLE_LOG_REPLAY_BATCH 5          // Backlog records queued per replay step
+#define SAMPLE_LOG_REPLAY_WINDOW 4         // Replayed records awaiting their PUBACK (< MQTT_QUEUE_DEPTH, <= 32)
+#define SAMPLE_LOG_REPLAY_INTERVAL 250     // Minimum time between replay steps (ms)
+
+// Telemetry Reporting Mode
+#define REPORT_MODE_INTERVAL 0       // Publish every metric every MQTT_PUBLISH_INTERVAL
+#define REPORT_MODE_DEADBAND 1       // Publish a metric when it moves past its deadband
+#define REPORT_MODE REPORT_MODE_DEADBAND
+
+// Deadband Reporting (REPORT_MODE_DEADBAND) - 0 disables a deadband
+#define AIR_TEMP_DEADBAND 0.3              // °C
+#define AIR_HUMIDITY_DEADBAND 2.0          // %RH
+#define SOIL_MOISTURE_DEADBAND 1.0         // % moisture
+#define SOIL_TEMP_DEADBAND 0.3             // °C
+#define REPORT_RELATIVE_DEADBAND 0.0       // Fraction of the last reported value
+#define REPORT_HEARTBEAT_INTERVAL 600000   // Republish unchanged metrics every 10 minutes
 
 // OTA Configuration
 #define CURRENT_FIRMWARE_VERSION "1.0"
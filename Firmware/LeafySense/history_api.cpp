@@ -0,0 +1,234 @@
+#include "history_api.h"
+#include "config.h"
+#include "sensor_history.h"
+#include "sensor_manager.h"
+#include "ntp_time.h"
+#include <Arduino.h>
+
+// Longest line is a rollup: three arrays of up to "-327.68," per channel
+#define HISTORY_API_LINE_MAX (96 + HISTORY_CHANNELS * 3 * 8)
+
+enum HistoryAPISection : uint8_t {
+  HISTORY_SECTION_HEADER,
+  HISTORY_SECTION_CHANNELS,
+  HISTORY_SECTION_ENTRIES,
+  HISTORY_SECTION_DONE
+};
+
+// One response in progress. Handlers, fillers and disconnect callbacks all
+// run on the AsyncTCP task, so the slots need no locking.
+struct HistoryStream {
+  bool busy;
+  uint32_t generation;          // Tells a late disconnect from the slot's next user
+  HistoryTier tier;
+  HistoryAPISection section;
+  uint16_t item;                // Channel, or age of the next entry
+  uint16_t remaining;           // Entries still to send
+  bool sentEntry;
+  uint32_t lastTimestamp;       // Timestamp of the last entry sent
+  uint16_t length;              // Rendered bytes in line
+  uint16_t offset;              // Bytes of line already sent
+  char line[HISTORY_API_LINE_MAX];
+};
+
+static HistoryStream streams[HISTORY_API_STREAMS];
+
+static void releaseStream(uint8_t index, uint32_t generation) {
+  if (streams[index].busy && streams[index].generation == generation) {
+    streams[index].busy = false;
+  }
+}
+
+static const char* tierName(HistoryTier tier) {
+  switch (tier) {
+    case HISTORY_TIER_RAW:    return "raw";
+    case HISTORY_TIER_MINUTE: return "minute";
+    case HISTORY_TIER_HOUR:   return "hour";
+  }
+  return "raw";
+}
+
+// Raw entries follow the runtime read cadence ("sample" command)
+static unsigned long tierInterval(HistoryTier tier) {
+  switch (tier) {
+    case HISTORY_TIER_RAW:    return getSensorReadInterval();
+    case HISTORY_TIER_MINUTE: return HISTORY_MINUTE_MS;
+    case HISTORY_TIER_HOUR:   return HISTORY_HOUR_MS;
+  }
+  return getSensorReadInterval();
+}
+
+// Appends ,"<key>":[v,...] in fixed point; returns the new length
+static int appendValues(char* line, size_t size, int length, const char* key, const int16_t* values) {
+  if (length >= (int)size) return length;
+  length += snprintf(line + length, size - length, ",\"%s\":[", key);
+  for (uint8_t c = 0; c < HISTORY_CHANNELS && length < (int)size; c++) {
+    const char* separator = c > 0 ? "," : "";
+    if (values[c] == HISTORY_NO_DATA) {
+      length += snprintf(line + length, size - length, "%snull", separator);
+    } else {
+      length += snprintf(line + length, size - length, "%s%.2f", separator, values[c] / 100.0);
+    }
+  }
+  if (length < (int)size) length += snprintf(line + length, size - length, "]");
+  return length;
+}
+
+// Fetches the entry at stream.item, stepping past entries recorded since
+// the previous one was sent (they shift every age by one)
+static bool nextEntry(HistoryStream& stream, HistorySample& sample, HistoryRollup& rollup) {
+  while (true) {
+    uint32_t timestamp;
+    if (stream.tier == HISTORY_TIER_RAW) {
+      if (!getHistorySample(stream.item, sample)) return false;
+      timestamp = sample.timestamp;
+    } else {
+      if (!getHistoryRollup(stream.tier, stream.item, rollup)) return false;
+      timestamp = rollup.timestamp;
+    }
+    if (!stream.sentEntry || (int32_t)(timestamp - stream.lastTimestamp) < 0) {
+      stream.lastTimestamp = timestamp;
+      stream.sentEntry = true;
+      stream.item++;
+      return true;
+    }
+    stream.item++;
+  }
+}
+
+// Renders the next piece of the document into stream.line. Returns false
+// once the document is complete.
+static bool renderNext(HistoryStream& stream) {
+  char* line = stream.line;
+  const size_t size = sizeof(stream.line);
+  int length = 0;
+
+  while (length == 0) {
+    switch (stream.section) {
+      case HISTORY_SECTION_HEADER:
+        length = snprintf(line, size, "{\"tier\":\"%s\",\"interval_ms\":%lu,\"uptime_ms\":%lu,\"epoch\":%lu,\"channels\":[",
+                          tierName(stream.tier), tierInterval(stream.tier), millis(), (unsigned long)getEpochTime());
+        stream.section = HISTORY_SECTION_CHANNELS;
+        stream.item = 0;
+        break;
+
+      case HISTORY_SECTION_CHANNELS: {
+        if (stream.item >= HISTORY_CHANNELS) {
+          length = snprintf(line, size, "],\"entries\":[");
+          stream.section = HISTORY_SECTION_ENTRIES;
+          stream.item = 0;
+          break;
+        }
+        const char* separator = stream.item > 0 ? "," : "";
+        if (stream.item == REPORT_METRIC_AIR_TEMP) {
+          length = snprintf(line, size, "%s\"air_temperature\"", separator);
+        } else if (stream.item == REPORT_METRIC_AIR_HUMIDITY) {
+          length = snprintf(line, size, "%s\"air_humidity\"", separator);
+        } else {
+          unsigned probe = (stream.item - 2) / 2 + 1;
+          length = snprintf(line, size, "%s\"soil%u_%s\"", separator, probe,
+                            stream.item % 2 == 0 ? "moisture" : "temperature");
+        }
+        stream.item++;
+        break;
+      }
+
+      case HISTORY_SECTION_ENTRIES: {
+        HistorySample sample;
+        HistoryRollup rollup;
+        bool first = !stream.sentEntry;
+        if (stream.remaining == 0 || !nextEntry(stream, sample, rollup)) {
+          length = snprintf(line, size, "]}");
+          stream.section = HISTORY_SECTION_DONE;
+          break;
+        }
+        stream.remaining--;
+        if (stream.tier == HISTORY_TIER_RAW) {
+          length = snprintf(line, size, "%s{\"ms\":%lu", first ? "" : ",", (unsigned long)sample.timestamp);
+          length = appendValues(line, size, length, "values", sample.value);
+        } else {
+          length = snprintf(line, size, "%s{\"ms\":%lu,\"samples\":%u", first ? "" : ",",
+                            (unsigned long)rollup.timestamp, (unsigned)rollup.samples);
+          length = appendValues(line, size, length, "min", rollup.min);
+          length = appendValues(line, size, length, "mean", rollup.mean);
+          length = appendValues(line, size, length, "max", rollup.max);
+        }
+        if (length < (int)size) length += snprintf(line + length, size - length, "}");
+        break;
+      }
+
+      case HISTORY_SECTION_DONE:
+        return false;
+    }
+  }
+
+  // A truncated line would break the document; HISTORY_API_LINE_MAX covers
+  // the longest entry
+  stream.length = min<int>(length, size - 1);
+  stream.offset = 0;
+  return true;
+}
+
+void handleHistoryAPI(AsyncWebServerRequest* request) {
+  HistoryTier tier = HISTORY_TIER_RAW;
+  if (request->hasParam("tier")) {
+    const String& name = request->getParam("tier")->value();
+    if (name == "minute") {
+      tier = HISTORY_TIER_MINUTE;
+    } else if (name == "hour") {
+      tier = HISTORY_TIER_HOUR;
+    } else if (name != "raw") {
+      request->send(400, "application/json", "{\"error\":\"tier must be raw, minute or hour\"}");
+      return;
+    }
+  }
+  uint16_t limit = getHistoryCapacity(tier);
+  if (request->hasParam("limit")) {
+    long requested = request->getParam("limit")->value().toInt();
+    if (requested > 0 && requested < limit) limit = requested;
+  }
+
+  uint8_t index = 0;
+  while (index < HISTORY_API_STREAMS && streams[index].busy) index++;
+  if (index == HISTORY_API_STREAMS) {
+    AsyncWebServerResponse* response = request->beginResponse(503, "application/json", "{\"error\":\"busy\"}");
+    response->addHeader("Retry-After", "1");
+    request->send(response);
+    return;
+  }
+
+  HistoryStream& stream = streams[index];
+  stream.busy = true;
+  uint32_t generation = ++stream.generation;
+  stream.tier = tier;
+  stream.section = HISTORY_SECTION_HEADER;
+  stream.item = 0;
+  stream.remaining = limit;
+  stream.sentEntry = false;
+  stream.lastTimestamp = 0;
+  stream.length = 0;
+  stream.offset = 0;
+
+  // Frees the slot if the client goes away before the document is done
+  request->onDisconnect([index, generation]() { releaseStream(index, generation); });
+
+  AsyncWebServerResponse* response = request->beginChunkedResponse("application/json",
+    [index, generation](uint8_t* buffer, size_t maxLen, size_t) -> size_t {
+      HistoryStream& stream = streams[index];
+      if (!stream.busy || stream.generation != generation) return 0;
+
+      size_t written = 0;
+      while (written < maxLen) {
+        if (stream.offset == stream.length && !renderNext(stream)) break;
+        size_t chunk = min<size_t>(stream.length - stream.offset, maxLen - written);
+        memcpy(buffer + written, stream.line + stream.offset, chunk);
+        stream.offset += chunk;
+        written += chunk;
+      }
+
+      if (written == 0) releaseStream(index, generation);
+      return written;
+    });
+  response->addHeader("Cache-Control", "no-store");
+  request->send(response);
+}
\ No newline at end of file
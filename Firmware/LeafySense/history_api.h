@@ -0,0 +1,26 @@
+// history_api.h
+#ifndef HISTORY_API_H
+#define HISTORY_API_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+// GET /api/v1/history?tier=raw|minute|hour&limit=N - one tier of the RAM
+// sample history (sensor_history.h), newest first, as one JSON document
+// sent with chunked transfer encoding:
+//
+//   {"tier":"minute","interval_ms":60000,"uptime_ms":...,"epoch":...,
+//    "channels":["air_temperature","air_humidity","soil1_moisture","soil1_temperature",...],
+//    "entries":[{"ms":...,"samples":12,"min":[...],"mean":[...],"max":[...]},...]}
+//
+// Raw entries are {"ms":...,"values":[...]}. "ms" is the uptime the entry
+// was recorded at (the bucket start for rollups); a channel with no valid
+// reading is null. tier defaults to raw and limit to the whole tier.
+// Entries are read one at a time while the response is being sent, so
+// samples recorded meanwhile are skipped rather than sent twice; at most
+// HISTORY_API_STREAMS responses are in progress at once (503 beyond that).
+
+// Function declarations
+void handleHistoryAPI(AsyncWebServerRequest* request);
+
+#endif
\ No newline at end of file
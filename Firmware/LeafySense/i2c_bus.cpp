@@ -0,0 +1,216 @@
+#include "i2c_bus.h"
+#include "config.h"
+#include <Arduino.h>
+#include <Wire.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+// Every sensor driver goes through this module instead of touching Wire.
+// Transactions are serialized by a mutex, bounded by I2C_TIMEOUT_MS, timed,
+// and counted per device. Repeated failures trigger a bus recovery and put
+// the device on a short backoff so a wedged sensor costs nothing per loop.
+
+static SemaphoreHandle_t busMutex = nullptr;
+static I2CDeviceStats devices[I2C_MAX_DEVICES];
+static uint8_t deviceCount = 0;
+static uint32_t busRecoveries = 0;
+static unsigned long lastRecovery = 0;
+static bool recoveryDone = false;
+
+static I2CDeviceStats* statsFor(uint8_t address) {
+  for (uint8_t i = 0; i < deviceCount; i++) {
+    if (devices[i].address == address) return &devices[i];
+  }
+  if (deviceCount >= I2C_MAX_DEVICES) return nullptr;
+  
+  I2CDeviceStats& dev = devices[deviceCount++];
+  dev = {};
+  dev.address = address;
+  return &dev;
+}
+
+static bool isSuspended(const I2CDeviceStats* dev) {
+  return dev != nullptr &&
+         dev->consecutive_errors >= I2C_DEVICE_SUSPEND_THRESHOLD &&
+         millis() - dev->last_error_ms < I2C_DEVICE_BACKOFF_MS;
+}
+
+static bool beginTransaction(I2CDeviceStats* dev) {
+  if (isSuspended(dev)) {
+    return false;
+  }
+  return xSemaphoreTake(busMutex, pdMS_TO_TICKS(I2C_TIMEOUT_MS)) == pdTRUE;
+}
+
+static bool endTransaction(I2CDeviceStats* dev, bool ok, unsigned long startUs) {
+  uint32_t latency = micros() - startUs;
+  xSemaphoreGive(busMutex);
+  
+  if (dev == nullptr) {
+    return ok;
+  }
+  
+  dev->transactions++;
+  dev->last_latency_us = latency;
+  dev->total_latency_us += latency;
+  if (latency > dev->max_latency_us) dev->max_latency_us = latency;
+  
+  if (ok) {
+    dev->consecutive_errors = 0;
+    return true;
+  }
+  
+  dev->errors++;
+  dev->consecutive_errors++;
+  dev->last_error_ms = millis();
+  
+  if (dev->consecutive_errors == I2C_RECOVERY_ERROR_THRESHOLD) {
+    Serial.println("⚠️ I2C device 0x" + String(dev->address, HEX) + " not responding, recovering bus...");
+    recoverI2CBus();
+  }
+  return false;
+}
+
+// Clock SCL until a slave holding SDA low releases it, then issue a STOP.
+// Takes ~100µs and leaves Wire re-initialized.
+static bool clockOutStuckBus() {
+  pinMode(I2C_SDA_PIN, INPUT_PULLUP);
+  pinMode(I2C_SCL_PIN, OUTPUT_OPEN_DRAIN);
+  digitalWrite(I2C_SCL_PIN, HIGH);
+  delayMicroseconds(5);
+  
+  for (uint8_t i = 0; i < 9 && digitalRead(I2C_SDA_PIN) == LOW; i++) {
+    digitalWrite(I2C_SCL_PIN, LOW);
+    delayMicroseconds(5);
+    digitalWrite(I2C_SCL_PIN, HIGH);
+    delayMicroseconds(5);
+  }
+  
+  // STOP condition: SDA rises while SCL is high
+  pinMode(I2C_SDA_PIN, OUTPUT_OPEN_DRAIN);
+  digitalWrite(I2C_SDA_PIN, LOW);
+  delayMicroseconds(5);
+  digitalWrite(I2C_SDA_PIN, HIGH);
+  delayMicroseconds(5);
+  
+  pinMode(I2C_SDA_PIN, INPUT_PULLUP);
+  return digitalRead(I2C_SDA_PIN) == HIGH;
+}
+
+static void startWire() {
+  Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN, I2C_FREQUENCY);
+  Wire.setTimeOut(I2C_TIMEOUT_MS);
+}
+
+bool initI2CBus() {
+  Serial.println("🔌 Initializing I2C bus...");
+  
+  if (busMutex == nullptr) {
+    busMutex = xSemaphoreCreateMutex();
+  }
+  
+  // A reset in the middle of a read can leave a slave driving SDA low
+  pinMode(I2C_SDA_PIN, INPUT_PULLUP);
+  if (digitalRead(I2C_SDA_PIN) == LOW) {
+    Serial.println("⚠️ SDA held low at boot, clocking out the bus");
+    clockOutStuckBus();
+    busRecoveries++;
+  }
+  
+  startWire();
+  
+  Serial.println("✅ I2C bus ready: SDA->GPIO" + String(I2C_SDA_PIN) + ", SCL->GPIO" + String(I2C_SCL_PIN) +
+                 ", " + String(I2C_FREQUENCY / 1000) + " kHz, " + String(I2C_TIMEOUT_MS) + " ms timeout");
+  return true;
+}
+
+bool recoverI2CBus() {
+  if (recoveryDone && millis() - lastRecovery < I2C_RECOVERY_MIN_INTERVAL_MS) {
+    return false;
+  }
+  if (xSemaphoreTake(busMutex, pdMS_TO_TICKS(I2C_TIMEOUT_MS)) != pdTRUE) {
+    return false;
+  }
+  
+  Wire.end();
+  bool released = clockOutStuckBus();
+  startWire();
+  
+  xSemaphoreGive(busMutex);
+  
+  busRecoveries++;
+  lastRecovery = millis();
+  recoveryDone = true;
+  
+  if (released) {
+    Serial.println("✅ I2C bus recovered");
+  } else {
+    Serial.println("❌ I2C bus recovery failed - SDA still low");
+  }
+  return released;
+}
+
+bool i2cWrite(uint8_t address, const uint8_t* data, uint8_t len) {
+  I2CDeviceStats* dev = statsFor(address);
+  if (!beginTransaction(dev)) return false;
+  unsigned long start = micros();
+  
+  Wire.beginTransmission(address);
+  Wire.write(data, len);
+  bool ok = Wire.endTransmission() == 0;
+  
+  return endTransaction(dev, ok, start);
+}
+
+bool i2cRead(uint8_t address, uint8_t* data, uint8_t len) {
+  I2CDeviceStats* dev = statsFor(address);
+  if (!beginTransaction(dev)) return false;
+  unsigned long start = micros();
+  
+  bool ok = Wire.requestFrom(address, (size_t)len) == len;
+  for (uint8_t i = 0; ok && i < len; i++) {
+    data[i] = Wire.read();
+  }
+  
+  return endTransaction(dev, ok, start);
+}
+
+// Register-style access: write, repeated START, read
+bool i2cWriteRead(uint8_t address, const uint8_t* tx, uint8_t txLen, uint8_t* rx, uint8_t rxLen) {
+  I2CDeviceStats* dev = statsFor(address);
+  if (!beginTransaction(dev)) return false;
+  unsigned long start = micros();
+  
+  Wire.beginTransmission(address);
+  Wire.write(tx, txLen);
+  bool ok = Wire.endTransmission(false) == 0;
+  ok = ok && Wire.requestFrom(address, (size_t)rxLen) == rxLen;
+  for (uint8_t i = 0; ok && i < rxLen; i++) {
+    rx[i] = Wire.read();
+  }
+  
+  return endTransaction(dev, ok, start);
+}
+
+uint8_t getI2CDeviceCount() {
+  return deviceCount;
+}
+
+const I2CDeviceStats& getI2CDeviceStats(uint8_t index) {
+  return devices[index];
+}
+
+uint32_t getI2CBusRecoveries() {
+  return busRecoveries;
+}
+
+void printI2CBusStats() {
+  Serial.println("🔌 I2C Bus (" + String(I2C_FREQUENCY / 1000) + " kHz, " + String(busRecoveries) + " recoveries):");
+  for (uint8_t i = 0; i < deviceCount; i++) {
+    const I2CDeviceStats& dev = devices[i];
+    uint32_t avg = dev.transactions ? (uint32_t)(dev.total_latency_us / dev.transactions) : 0;
+    Serial.println("   0x" + String(dev.address, HEX) + ": " + String(dev.transactions) + " tx, " +
+                   String(dev.errors) + " errors, avg " + String(avg) + " µs, max " + String(dev.max_latency_us) + " µs" +
+                   (isSuspended(&dev) ? " (backing off)" : ""));
+  }
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+// i2c_bus.h
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <Arduino.h>
+
+// Per-device counters, one entry per I2C address that has been used
+struct I2CDeviceStats {
+  uint8_t address;
+  uint32_t transactions;
+  uint32_t errors;
+  uint16_t consecutive_errors;
+  uint32_t last_latency_us;
+  uint32_t max_latency_us;
+  uint64_t total_latency_us;
+  unsigned long last_error_ms;
+};
+
+// Function declarations
+bool initI2CBus();
+bool i2cWrite(uint8_t address, const uint8_t* data, uint8_t len);
+bool i2cRead(uint8_t address, uint8_t* data, uint8_t len);
+bool i2cWriteRead(uint8_t address, const uint8_t* tx, uint8_t txLen, uint8_t* rx, uint8_t rxLen);
+bool recoverI2CBus();
+uint8_t getI2CDeviceCount();
+const I2CDeviceStats& getI2CDeviceStats(uint8_t index);
+uint32_t getI2CBusRecoveries();
+void printI2CBusStats();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "memory_monitor.h"
+#include "config.h"
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static MemoryStats stats = {};
+static TaskStackInfo taskStacks[MEMORY_MAX_TASKS];
+static uint8_t taskStackCount = 0;
+static unsigned long lastMemoryCheck = 0;
+static uint32_t failuresAtLastCheck = 0;
+
+// Called by the heap allocator on every failed allocation, from whatever
+// task or context made the request; only counts
+static volatile uint32_t allocFailures = 0;
+static volatile uint32_t lastFailedSize = 0;
+static volatile uint32_t lastFailedCaps = 0;
+static const char* volatile lastFailedFunction = nullptr;  // Static string from the allocator
+
+static void onAllocFailed(size_t size, uint32_t caps, const char* function_name) {
+  allocFailures++;
+  lastFailedSize = size;
+  lastFailedCaps = caps;
+  lastFailedFunction = function_name;
+}
+
+// Stack high-water mark of every task. Needs the FreeRTOS trace facility;
+// without it only the loop task is covered.
+static void sampleTaskStacks() {
+#if configUSE_TRACE_FACILITY
+  static TaskStatus_t status[MEMORY_MAX_TASKS];
+  UBaseType_t count = uxTaskGetSystemState(status, MEMORY_MAX_TASKS, nullptr);
+  if (count == 0 && uxTaskGetNumberOfTasks() > MEMORY_MAX_TASKS) {
+    Serial.println("⚠️ More than " + String(MEMORY_MAX_TASKS) + " tasks, raise MEMORY_MAX_TASKS");
+  }
+  taskStackCount = count;
+  for (UBaseType_t i = 0; i < count; i++) {
+    strncpy(taskStacks[i].name, status[i].pcTaskName, sizeof(taskStacks[i].name) - 1);
+    taskStacks[i].name[sizeof(taskStacks[i].name) - 1] = '\0';
+    taskStacks[i].stack_free = status[i].usStackHighWaterMark;  // Bytes on ESP-IDF
+  }
+#else
+  taskStackCount = 1;
+  strncpy(taskStacks[0].name, pcTaskGetName(nullptr), sizeof(taskStacks[0].name) - 1);
+  taskStacks[0].name[sizeof(taskStacks[0].name) - 1] = '\0';
+  taskStacks[0].stack_free = stats.loop_stack_free;
+#endif
+}
+
+static void sampleMemory() {
+  stats.free_heap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  stats.min_free_heap = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+  stats.largest_free_block = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  if (stats.min_largest_block == 0 || stats.largest_free_block < stats.min_largest_block) {
+    stats.min_largest_block = stats.largest_free_block;
+  }
+  stats.alloc_failures = allocFailures;
+  stats.last_failed_size = lastFailedSize;
+  stats.last_failed_caps = lastFailedCaps;
+  stats.last_failed_function = lastFailedFunction;
+  stats.loop_stack_free = uxTaskGetStackHighWaterMark(nullptr);  // Called from loop()
+  sampleTaskStacks();
+  
+  uint8_t warnings = 0;
+  if (stats.free_heap < MEMORY_WARN_FREE_HEAP) warnings |= MEMORY_WARN_LOW_HEAP;
+  if (stats.largest_free_block < MEMORY_WARN_LARGEST_BLOCK) warnings |= MEMORY_WARN_FRAGMENTED;
+  for (uint8_t i = 0; i < taskStackCount; i++) {
+    if (taskStacks[i].stack_free < MEMORY_WARN_STACK_FREE) warnings |= MEMORY_WARN_STACK;
+  }
+  if (stats.alloc_failures != failuresAtLastCheck) warnings |= MEMORY_WARN_ALLOC_FAILED;
+  failuresAtLastCheck = stats.alloc_failures;
+  
+  // Log only newly raised warnings so a persistent condition does not flood
+  uint8_t raised = warnings & ~stats.warnings;
+  stats.warnings = warnings;
+  if (raised & MEMORY_WARN_LOW_HEAP) {
+    Serial.println("⚠️ Low heap: " + String(stats.free_heap) + " bytes free");
+  }
+  if (raised & MEMORY_WARN_FRAGMENTED) {
+    Serial.println("⚠️ Heap fragmented: largest free block " + String(stats.largest_free_block) + " bytes");
+  }
+  if (raised & MEMORY_WARN_STACK) {
+    for (uint8_t i = 0; i < taskStackCount; i++) {
+      if (taskStacks[i].stack_free < MEMORY_WARN_STACK_FREE) {
+        Serial.println("⚠️ Task " + String(taskStacks[i].name) + " stack nearly full: " +
+                       String(taskStacks[i].stack_free) + " bytes left");
+      }
+    }
+  }
+  if (raised & MEMORY_WARN_ALLOC_FAILED) {
+    Serial.printf("⚠️ Heap allocation failed (%lu bytes requested, caps 0x%lx, in %s)\n",
+                  (unsigned long)stats.last_failed_size, (unsigned long)stats.last_failed_caps,
+                  stats.last_failed_function ? stats.last_failed_function : "?");
+  }
+}
+
+void initMemoryMonitor() {
+  heap_caps_register_failed_alloc_callback(onAllocFailed);
+  sampleMemory();
+}
+
+// Periodic sample; cheap enough to run at MEMORY_CHECK_INTERVAL
+void handleMemoryMonitor() {
+  if (millis() - lastMemoryCheck < MEMORY_CHECK_INTERVAL) {
+    return;
+  }
+  lastMemoryCheck = millis();
+  sampleMemory();
+}
+
+const MemoryStats& getMemoryStats() {
+  return stats;
+}
+
+uint8_t getTaskStackCount() {
+  return taskStackCount;
+}
+
+const TaskStackInfo& getTaskStackInfo(uint8_t index) {
+  return taskStacks[index];
+}
+
+void printMemoryStats() {
+  Serial.println("💾 Heap: " + String(stats.free_heap) + " free, " + String(stats.min_free_heap) + " min, largest block " +
+                 String(stats.largest_free_block) + " (min " + String(stats.min_largest_block) + "), " +
+                 String(stats.alloc_failures) + " failed allocs");
+  String stacks = "🧵 Stack free:";
+  for (uint8_t i = 0; i < taskStackCount; i++) {
+    stacks += " " + String(taskStacks[i].name) + "=" + String(taskStacks[i].stack_free);
+  }
+  Serial.println(stacks);
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+// memory_monitor.h
+#ifndef MEMORY_MONITOR_H
+#define MEMORY_MONITOR_H
+
+#include <Arduino.h>
+
+// Warning bits, set while the matching threshold in config.h is crossed
+#define MEMORY_WARN_LOW_HEAP     0x01  // Free heap under MEMORY_WARN_FREE_HEAP
+#define MEMORY_WARN_FRAGMENTED   0x02  // Largest free block under MEMORY_WARN_LARGEST_BLOCK
+#define MEMORY_WARN_STACK        0x04  // Some task has less than MEMORY_WARN_STACK_FREE left
+#define MEMORY_WARN_ALLOC_FAILED 0x08  // An allocation failed since the last check
+
+struct MemoryStats {
+  uint32_t free_heap;
+  uint32_t min_free_heap;        // Lowest free heap since boot
+  uint32_t largest_free_block;   // Biggest single allocation that can succeed now
+  uint32_t min_largest_block;    // Lowest largest-block value seen since boot
+  uint32_t alloc_failures;       // Failed heap allocations since boot
+  uint32_t last_failed_size;     // Size of the most recent failed allocation
+  uint32_t last_failed_caps;     // MALLOC_CAP_* it asked for
+  const char* last_failed_function; // Allocator entry point that failed, nullptr if none yet
+  uint32_t loop_stack_free;      // Loop task stack never touched (bytes)
+  uint8_t warnings;              // MEMORY_WARN_* bits
+};
+
+// Stack high-water mark of one FreeRTOS task
+struct TaskStackInfo {
+  char name[16];
+  uint32_t stack_free;           // Bytes of stack never touched
+};
+
+// Function declarations
+void initMemoryMonitor();
+void handleMemoryMonitor();
+const MemoryStats& getMemoryStats();
+uint8_t getTaskStackCount();
+const TaskStackInfo& getTaskStackInfo(uint8_t index);
+void printMemoryStats();
+
+#endif
\ No newline at end of file
@@ -3,17 +3,131 @@
 #include "wifi_manager.h"
 #include "aht20_sensor.h"
 #include "ads1115_sensor.h"
+#include "report_policy.h"
+#include "sample_log.h"
+#include "memory_monitor.h"
+#include "mqtt_transport.h"
+#include "mqtt_queue.h"
+#include "telemetry_codec.h"
 #include "ntp_time.h"
-#include <ArduinoJson.h>
+#include "command_handler.h"
+#include "sensor_manager.h"
 #include <Arduino.h>
+#include <lwip/sockets.h>
+#include <lwip/dns.h>
+#include <esp_netif.h>
 
-// MQTT client objects
+// MQTT client objects. PubSubClient talks through the transport so QoS1
+// publishes and their PUBACKs can share its connection.
 WiFiClient wifiClient;
-PubSubClient mqttClient(wifiClient);
+MQTTTransport mqttTransport(wifiClient);
+PubSubClient mqttClient(mqttTransport);
 
 // Internal variables
 static unsigned long lastMQTTPublish = 0;
-static bool mqttConnected = false;
+static unsigned long lastHealthPublish = 0;
+
+// Connection state machine. checkMQTTConnection() advances it once per loop()
+// pass and never waits on the network: the broker name goes to lwIP's
+// asynchronous resolver, the TCP connect runs on a non-blocking socket, and
+// the transport writes CONNECT and collects the CONNACK as it arrives. Each
+// phase has its own deadline.
+enum MQTTConnectionState {
+    MQTT_STATE_DISCONNECTED,    // Waiting for the backoff to expire
+    MQTT_STATE_RESOLVING,       // Broker name lookup in progress
+    MQTT_STATE_TCP_CONNECTING,  // Non-blocking connect in progress
+    MQTT_STATE_AWAIT_CONNACK,   // CONNECT sent, waiting for the broker's answer
+    MQTT_STATE_CONNECTED
+};
+
+static MQTTConnectionState connectionState = MQTT_STATE_DISCONNECTED;
+static MQTTConnectionStats connectionStats = {0, 0, 0, 0, 0, MQTT_RECONNECT_MIN_MS, 0, 0};
+static int connectSocket = -1;
+static unsigned long nextAttemptAt = 0;
+static unsigned long attemptStartedAt = 0;   // Start of the current phase
+static unsigned long disconnectedAt = 0;
+static bool reconnecting = false;        // A previous connection was lost
+
+// Broker address. Kept for every reconnect until a TCP connect to it
+// fails, then looked up again on the next attempt.
+static IPAddress brokerIP;
+static bool brokerResolved = false;
+
+// Asynchronous lookup; the callback runs on the lwIP tcpip task
+enum BrokerLookupState : uint8_t {
+    LOOKUP_PENDING,
+    LOOKUP_DONE,
+    LOOKUP_FAILED
+};
+
+struct BrokerLookupRequest {
+    const char* host;
+    ip_addr_t address;     // Filled in at once if lwIP has the name cached
+    err_t result;
+    uint32_t generation;
+};
+
+static volatile uint8_t lookupState = LOOKUP_PENDING;
+static volatile uint32_t lookupAddress = 0;
+static volatile uint32_t lookupGeneration = 0;  // Tells a late answer from the current lookup
+
+// Topics are built once per connection into fixed buffers so the publish
+// path never formats or allocates
+static char deviceId[18];  // MAC address, "AA:BB:CC:DD:EE:FF"
+static uint8_t deviceMac[6];
+static char baseTopic[MQTT_TOPIC_MAX];
+static char sensorsTopic[MQTT_TOPIC_MAX];
+static char backlogTopic[MQTT_TOPIC_MAX];
+static char statusTopic[MQTT_TOPIC_MAX];
+static char commandTopic[MQTT_TOPIC_MAX];
+static char commandResultTopic[MQTT_TOPIC_MAX];
+static char infoTopic[MQTT_TOPIC_MAX];
+static char healthTopic[MQTT_TOPIC_MAX];
+static char airTempTopic[MQTT_TOPIC_MAX];
+static char airHumidityTopic[MQTT_TOPIC_MAX];
+static char soilMoistureTopics[MAX_SOIL_PROBES][MQTT_TOPIC_MAX];
+static char soilTempTopics[MAX_SOIL_PROBES][MQTT_TOPIC_MAX];
+
+// Serialized payloads go straight into this buffer
+static char payloadBuffer[MQTT_BUFFER_SIZE];
+
+static void buildTopic(char* topic, const char* subtopic) {
+    int len = snprintf(topic, MQTT_TOPIC_MAX, "%s/%s", baseTopic, subtopic);
+    if (len >= MQTT_TOPIC_MAX) {
+        Serial.println("⚠️ MQTT topic truncated, raise MQTT_TOPIC_MAX: " + String(topic));
+    }
+}
+
+// Called on every successful connect; the prefix can change from the portal
+static void buildMQTTTopics() {
+    WiFi.macAddress(deviceMac);
+    snprintf(deviceId, sizeof(deviceId), "%02X:%02X:%02X:%02X:%02X:%02X",
+             deviceMac[0], deviceMac[1], deviceMac[2], deviceMac[3], deviceMac[4], deviceMac[5]);
+    snprintf(baseTopic, sizeof(baseTopic), "%s/%s", MQTT_TOPIC_PREFIX.c_str(), deviceId);
+    
+#if TELEMETRY_CODEC == TELEMETRY_CODEC_CBOR
+    buildTopic(sensorsTopic, "sensors/cbor");  // Binary payload, kept apart from JSON subscribers
+    buildTopic(backlogTopic, "backlog/cbor");
+#else
+    buildTopic(sensorsTopic, "sensors");
+    buildTopic(backlogTopic, "backlog");
+#endif
+    buildTopic(statusTopic, "status");
+    buildTopic(commandTopic, "cmd");
+    buildTopic(commandResultTopic, "cmd/result");
+    buildTopic(infoTopic, "info");
+    buildTopic(healthTopic, "health");
+    buildTopic(airTempTopic, "air/temperature");
+    buildTopic(airHumidityTopic, "air/humidity");
+    
+    char subtopic[32];
+    for (uint8_t p = 0; p < MAX_SOIL_PROBES; p++) {
+        snprintf(subtopic, sizeof(subtopic), "soil/%u/moisture", p + 1);
+        buildTopic(soilMoistureTopics[p], subtopic);
+        snprintf(subtopic, sizeof(subtopic), "soil/%u/temperature", p + 1);
+        buildTopic(soilTempTopics[p], subtopic);
+    }
+}
 
 void initMQTT() {
     Serial.println("📡 Initializing MQTT client...");
@@ -21,44 +135,317 @@ void initMQTT() {
     // Use configured MQTT server
     mqttClient.setServer(MQTT_SERVER.c_str(), MQTT_PORT);
     mqttClient.setCallback(mqttCallback);
-    mqttClient.setKeepAlive(60);
+    mqttClient.setKeepAlive(MQTT_KEEPALIVE);
+    mqttClient.setSocketTimeout(MQTT_SOCKET_TIMEOUT);
+    mqttClient.setBufferSize(MQTT_BUFFER_SIZE);
+    buildMQTTTopics();
+    initMQTTQueue();
     Serial.println("✅ MQTT client initialized");
 }
 
+static void onBrokerLookup(const char*, const ip_addr_t* address, void* arg) {
+    if ((uint32_t)(uintptr_t)arg != lookupGeneration) return;  // That attempt already gave up
+    if (address != nullptr && IP_IS_V4(address)) {
+        lookupAddress = ip4_addr_get_u32(ip_2_ip4(address));
+        lookupState = LOOKUP_DONE;
+    } else {
+        lookupState = LOOKUP_FAILED;
+    }
+}
+
+// lwIP's DNS API may only be called from the tcpip task
+static esp_err_t startLookupOnTcpip(void* context) {
+    BrokerLookupRequest* request = (BrokerLookupRequest*)context;
+    request->result = dns_gethostbyname(request->host, &request->address, onBrokerLookup,
+                                        (void*)(uintptr_t)request->generation);
+    return ESP_OK;
+}
+
+static void brokerAddressFound() {
+    brokerResolved = true;
+    Serial.println("🌐 MQTT broker " + MQTT_SERVER + " resolved to " + brokerIP.toString());
+}
+
+// The cached address stopped answering; look the name up on the next attempt
+static void forgetBrokerAddress() {
+    brokerResolved = false;
+}
+
+static void closeConnectSocket() {
+    if (connectSocket >= 0) {
+        close(connectSocket);
+        connectSocket = -1;
+    }
+}
+
+// Schedules the next attempt after a jittered, exponentially growing delay
+static void attemptFailed(const char* reason) {
+    closeConnectSocket();
+    connectionState = MQTT_STATE_DISCONNECTED;
+    connectionStats.failures++;
+
+    uint32_t backoff = connectionStats.backoff_ms;
+    uint32_t jitter = backoff * MQTT_RECONNECT_JITTER_PCT / 100;
+    uint32_t delayMs = backoff - jitter + (jitter > 0 ? esp_random() % (2 * jitter + 1) : 0);
+    nextAttemptAt = millis() + delayMs;
+    connectionStats.backoff_ms = min<uint32_t>(backoff * 2, MQTT_RECONNECT_MAX_MS);
+
+    Serial.printf("⚠️ MQTT connect failed (%s), retry in %lu ms\n", reason, (unsigned long)delayMs);
+}
+
+// Device description, retained so a subscriber sees it as soon as it
+// subscribes. Sent once per session and again when the cadence changes.
+void publishDeviceInfo() {
+    DeviceInfo info;
+    memcpy(info.mac, deviceMac, sizeof(info.mac));
+    info.firmware = CURRENT_FIRMWARE_VERSION;
+    info.probes = getSensorSnapshot().soil.probe_count;
+    info.sample_interval_ms = getSensorReadInterval();
+    info.publish_interval_ms = getReportInterval();
+    info.report_mode = REPORT_MODE;
+    info.codec = TELEMETRY_CODEC;
+    size_t length = encodeDeviceInfoJSON(info, payloadBuffer, sizeof(payloadBuffer));
+    if (length > 0) mqttEnqueue(infoTopic, payloadBuffer, length, true);
+}
+
+// Link quality at MQTT_HEALTH_INTERVAL instead of with every sensor message
+static void publishHealth() {
+    const MQTTQueueStats& queue = getMQTTQueueStats();
+    HealthReport health;
+    health.wifi_rssi = WiFi.RSSI();
+    health.uptime_s = millis() / 1000;
+    health.mqtt_connects = connectionStats.connects;
+    health.mqtt_failures = connectionStats.failures;
+    health.reconnect_ms = connectionStats.last_reconnect_ms;
+    health.queue_dropped = queue.dropped;
+    health.retransmits = queue.retransmits;
+    size_t length = encodeHealthJSON(health, payloadBuffer, sizeof(payloadBuffer));
+    if (length > 0) mqttClient.publish(healthTopic, (const uint8_t*)payloadBuffer, length);
+    lastHealthPublish = millis();
+}
+
+static String mqttClientId() {
+    return MQTT_CLIENT_ID + "_" + String(deviceId);
+}
+
+// The broker accepted the CONNECT. PubSubClient::connect() takes over the
+// session without network I/O: the transport drops its CONNECT and replays
+// the CONNACK already received.
+static void finishMQTTConnect() {
+    String clientId = mqttClientId();
+    mqttTransport.handOverSession();
+    if (!mqttClient.connect(clientId.c_str(), nullptr, nullptr, statusTopic, 1, true, "offline")) {
+        mqttTransport.stop();
+        char reason[32];
+        snprintf(reason, sizeof(reason), "MQTT state %d", mqttClient.state());
+        attemptFailed(reason);
+        return;
+    }
+
+    connectionState = MQTT_STATE_CONNECTED;
+    connectionStats.connects++;
+    connectionStats.backoff_ms = MQTT_RECONNECT_MIN_MS;
+    mqttClient.subscribe(commandTopic);
+    mqttEnqueue(statusTopic, "online", 6, true);
+    publishDeviceInfo();
+    publishHealth();
+
+    Serial.println("✅ MQTT connected to " + MQTT_SERVER + ":" + String(MQTT_PORT) + " as " + clientId);
+    if (reconnecting) {
+        uint32_t elapsed = millis() - disconnectedAt;
+        connectionStats.last_reconnect_ms = elapsed;
+        if (elapsed > connectionStats.max_reconnect_ms) {
+            connectionStats.max_reconnect_ms = elapsed;
+        }
+        reconnecting = false;
+        Serial.println("   Reconnected after " + String(elapsed) + " ms");
+    }
+}
+
+// Writes CONNECT over the established TCP connection; the CONNACK is
+// collected by pollConnAck()
+static void sendMQTTConnect() {
+    // Topics first: the prefix can change from the portal and the will uses one
+    buildMQTTTopics();
+    String clientId = mqttClientId();
+
+    // The broker publishes the retained "offline" will if the session ends
+    // without a DISCONNECT (power loss, WiFi drop, crash)
+    bool credentials = MQTT_USER.length() > 0 && MQTT_PASSWORD.length() > 0;
+    if (!mqttTransport.sendConnect(clientId.c_str(),
+                                   credentials ? MQTT_USER.c_str() : nullptr,
+                                   credentials ? MQTT_PASSWORD.c_str() : nullptr,
+                                   statusTopic, "offline", true, MQTT_KEEPALIVE)) {
+        mqttTransport.stop();
+        attemptFailed("CONNECT not sent");
+        return;
+    }
+
+    attemptStartedAt = millis();
+    connectionState = MQTT_STATE_AWAIT_CONNACK;
+}
+
+// Checks for the broker's answer without waiting
+static void pollConnAck() {
+    int code = mqttTransport.pollConnAck();
+    if (code == MQTT_CONNACK_PENDING) {
+        if (millis() - attemptStartedAt >= MQTT_CONNACK_TIMEOUT) {
+            mqttTransport.stop();
+            attemptFailed("no CONNACK");
+        }
+        return;
+    }
+
+    if (code != 0) {
+        mqttTransport.stop();
+        char reason[32];
+        if (code == MQTT_CONNACK_LOST) {
+            snprintf(reason, sizeof(reason), "closed before CONNACK");
+        } else if (code == MQTT_CONNACK_MALFORMED) {
+            snprintf(reason, sizeof(reason), "bad CONNACK");
+        } else {
+            snprintf(reason, sizeof(reason), "CONNACK refused, code %d", code);
+        }
+        attemptFailed(reason);
+        return;
+    }
+
+    finishMQTTConnect();
+}
+
+// Opens a non-blocking socket to brokerIP; the connect completes in
+// pollConnectAttempt()
+static void openBrokerSocket() {
+    connectSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (connectSocket < 0) {
+        attemptFailed("no socket");
+        return;
+    }
+    fcntl(connectSocket, F_SETFL, fcntl(connectSocket, F_GETFL, 0) | O_NONBLOCK);
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(MQTT_PORT);
+    addr.sin_addr.s_addr = (uint32_t)brokerIP;
+
+    if (connect(connectSocket, (struct sockaddr*)&addr, sizeof(addr)) < 0 && errno != EINPROGRESS) {
+        forgetBrokerAddress();
+        attemptFailed("TCP connect refused");
+        return;
+    }
+
+    attemptStartedAt = millis();
+    connectionState = MQTT_STATE_TCP_CONNECTING;
+}
+
+// Uses the known broker address, or starts a lookup that
+// pollBrokerLookup() picks up. An IP literal needs no lookup.
+static void startConnectAttempt() {
+    connectionStats.attempts++;
+
+    if (brokerResolved || brokerIP.fromString(MQTT_SERVER.c_str())) {
+        brokerResolved = true;
+        openBrokerSocket();
+        return;
+    }
+
+    connectionStats.dns_lookups++;
+    BrokerLookupRequest request;
+    request.host = MQTT_SERVER.c_str();
+    request.result = ERR_ARG;
+    request.generation = ++lookupGeneration;
+    lookupState = LOOKUP_PENDING;
+    esp_netif_tcpip_exec(startLookupOnTcpip, &request);
+
+    if (request.result == ERR_OK && IP_IS_V4(&request.address)) {
+        brokerIP = IPAddress(ip4_addr_get_u32(ip_2_ip4(&request.address)));
+        brokerAddressFound();
+        openBrokerSocket();
+        return;
+    }
+    if (request.result != ERR_INPROGRESS) {
+        attemptFailed("DNS lookup failed");
+        return;
+    }
+
+    attemptStartedAt = millis();
+    connectionState = MQTT_STATE_RESOLVING;
+}
+
+static void pollBrokerLookup() {
+    if (lookupState == LOOKUP_PENDING) {
+        if (millis() - attemptStartedAt >= MQTT_DNS_TIMEOUT) {
+            lookupGeneration++;  // Ignore the answer if it still comes
+            attemptFailed("DNS lookup timed out");
+        }
+        return;
+    }
+    if (lookupState == LOOKUP_FAILED) {
+        attemptFailed("DNS lookup failed");
+        return;
+    }
+
+    brokerIP = IPAddress(lookupAddress);
+    brokerAddressFound();
+    openBrokerSocket();
+}
+
+// Checks the pending connect without waiting; on success the socket is
+// switched back to blocking mode, handed to wifiClient and CONNECT is sent
+static void pollConnectAttempt() {
+    fd_set writeSet;
+    FD_ZERO(&writeSet);
+    FD_SET(connectSocket, &writeSet);
+    struct timeval noWait = {0, 0};
+
+    int ready = select(connectSocket + 1, NULL, &writeSet, NULL, &noWait);
+    if (ready == 0) {
+        if (millis() - attemptStartedAt >= MQTT_TCP_CONNECT_TIMEOUT) {
+            forgetBrokerAddress();
+            attemptFailed("TCP connect timed out");
+        }
+        return;
+    }
+
+    int socketError = 0;
+    socklen_t errorLength = sizeof(socketError);
+    if (ready < 0 || getsockopt(connectSocket, SOL_SOCKET, SO_ERROR, &socketError, &errorLength) < 0 || socketError != 0) {
+        forgetBrokerAddress();
+        attemptFailed("TCP connect failed");
+        return;
+    }
+
+    fcntl(connectSocket, F_SETFL, fcntl(connectSocket, F_GETFL, 0) & ~O_NONBLOCK);
+    int noDelay = 1;
+    setsockopt(connectSocket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    wifiClient = WiFiClient(connectSocket);
+    connectSocket = -1;
+    sendMQTTConnect();
+}
+
+// Requests an attempt on the next state machine pass, skipping any pending
+// backoff (used at startup and when WiFi comes back). Never blocks.
 bool connectMQTT() {
     if (MQTT_SERVER.length() == 0) {
         Serial.println("⚠️ No MQTT server configured");
         return false;
     }
-    
-    Serial.print("🔗 Connecting to MQTT broker...");
-    
-    // Generate unique client ID
-    String clientId = MQTT_CLIENT_ID + "_" + String(WiFi.macAddress());
-    
-    bool connected = false;
-    if (MQTT_USER.length() > 0 && MQTT_PASSWORD.length() > 0) {
-        connected = mqttClient.connect(clientId.c_str(), MQTT_USER.c_str(), MQTT_PASSWORD.c_str());
-    } else {
-        connected = mqttClient.connect(clientId.c_str());
-    }
-    
-    if (connected) {
-        mqttConnected = true;
-        Serial.println(" SUCCESS");
-        Serial.println("   Server: " + MQTT_SERVER + ":" + String(MQTT_PORT));
-        Serial.println("   Client ID: " + clientId);
-        return true;
-    } else {
-        mqttConnected = false;
-        Serial.println(" FAILED");
-        Serial.println("   Error: " + String(mqttClient.state()));
-        return false;
+
+    if (connectionState == MQTT_STATE_DISCONNECTED) {
+        connectionStats.backoff_ms = MQTT_RECONNECT_MIN_MS;
+        nextAttemptAt = millis();
+        checkMQTTConnection();
     }
+    return isMQTTConnected();
 }
 
 void mqttLoop() {
     mqttClient.loop();
+    handleMQTTQueue(mqttClient.connected());
+    if (mqttClient.connected() && millis() - lastHealthPublish >= MQTT_HEALTH_INTERVAL) {
+        publishHealth();
+    }
 }
 
 bool isMQTTConnected() {
@@ -66,139 +453,255 @@ bool isMQTTConnected() {
 }
 
 void checkMQTTConnection() {
-    if (MQTT_SERVER.length() > 0 && !mqttClient.connected()) {
-        mqttConnected = false;
-        Serial.println("⚠️ MQTT connection lost, attempting to reconnect...");
-        connectMQTT();
+    if (MQTT_SERVER.length() == 0) return;
+
+    switch (connectionState) {
+        case MQTT_STATE_CONNECTED:
+            if (mqttClient.connected()) return;
+            Serial.println("⚠️ MQTT connection lost, reconnecting in the background");
+            connectionState = MQTT_STATE_DISCONNECTED;
+            connectionStats.disconnects++;
+            connectionStats.backoff_ms = MQTT_RECONNECT_MIN_MS;
+            disconnectedAt = millis();
+            nextAttemptAt = disconnectedAt;
+            reconnecting = true;
+            return;
+
+        case MQTT_STATE_DISCONNECTED:
+            if (WiFi.status() != WL_CONNECTED) return;
+            if ((long)(millis() - nextAttemptAt) < 0) return;
+            startConnectAttempt();
+            return;
+
+        case MQTT_STATE_RESOLVING:
+            pollBrokerLookup();
+            return;
+
+        case MQTT_STATE_TCP_CONNECTING:
+            pollConnectAttempt();
+            return;
+
+        case MQTT_STATE_AWAIT_CONNACK:
+            pollConnAck();
+            return;
+    }
+}
+
+const MQTTConnectionStats& getMQTTConnectionStats() {
+    return connectionStats;
+}
+
+void printMQTTConnectionStats() {
+    Serial.printf("🔗 MQTT link: %lu attempts, %lu failed, %lu connects, %lu drops, backoff %lu ms\n",
+                  (unsigned long)connectionStats.attempts, (unsigned long)connectionStats.failures,
+                  (unsigned long)connectionStats.connects, (unsigned long)connectionStats.disconnects,
+                  (unsigned long)connectionStats.backoff_ms);
+    if (connectionStats.max_reconnect_ms > 0) {
+        Serial.printf("   Time to reconnect: last %lu ms, max %lu ms\n",
+                      (unsigned long)connectionStats.last_reconnect_ms,
+                      (unsigned long)connectionStats.max_reconnect_ms);
     }
 }
 
+// Commands are only copied here; command_handler runs them from loop()
 void mqttCallback(char* topic, byte* payload, unsigned int length) {
-    Serial.print("📨 Message arrived [");
-    Serial.print(topic);
-    Serial.print("]: ");
-    
-    String message;
-    for (unsigned int i = 0; i < length; i++) {
-        message += (char)payload[i];
+    if (strcmp(topic, commandTopic) == 0) {
+        queueCommand(payload, length);
+        return;
+    }
+    Serial.print("📨 Message arrived on unexpected topic ");
+    Serial.println(topic);
+}
+
+// Answer to a command, sent at QoS0 so it never displaces telemetry in the queue
+void publishCommandResult(const char* result) {
+    if (mqttClient.connected()) {
+        mqttClient.publish(commandResultTopic, result);
     }
-    Serial.println(message);
 }
 
 bool shouldPublishMQTT() {
     return (millis() - lastMQTTPublish >= MQTT_PUBLISH_INTERVAL);
 }
-// Add this function to mqtt_manager.cpp (before publishSensorData function)
-void publishIndividualTopics(const AHT20_Data& ahtData, const ADS1115_Data& soilData, const String& deviceId) {
-    String baseTopic = MQTT_TOPIC_PREFIX + "/" + deviceId;
+static bool publishBuffer(const char* topic, const char* payload, size_t length) {
+    return mqttClient.publish(topic, (const uint8_t*)payload, length);
+}
+
+// Two decimals, same as the old String(float) formatting
+static bool publishFloat(const char* topic, float value) {
+    char text[16];
+    int len = snprintf(text, sizeof(text), "%.2f", value);
+    return publishBuffer(topic, text, len);
+}
+
+#if MQTT_INDIVIDUAL_TOPICS
+// Individual topics go out only for the metrics the report policy marked due
+static void publishIndividualTopics(const AHT20_Data& ahtData, const ADS1115_Data& soilData, const ReportDecision& decision) {
+    // Air temperature & humidity
+    if (decision.due[REPORT_METRIC_AIR_TEMP]) {
+        publishFloat(airTempTopic, ahtData.temperature);
+    }
+    if (decision.due[REPORT_METRIC_AIR_HUMIDITY]) {
+        publishFloat(airHumidityTopic, ahtData.humidity);
+    }
     
-    // Air temperature
-    if (ahtData.sensor_found) {
-        mqttClient.publish((baseTopic + "/air/temperature").c_str(), String(ahtData.temperature).c_str());
-        mqttClient.publish((baseTopic + "/air/humidity").c_str(), String(ahtData.humidity).c_str());
+    // Soil probes, numbered from 1 in registry order
+    for (uint8_t p = 0; p < soilData.probe_count; p++) {
+        const SoilSensorData& probe = soilData.probes[p];
+        if (!isSoilProbeValid(soilData, p)) continue;
+        
+        if (decision.due[REPORT_METRIC_SOIL_MOISTURE(p)]) {
+            publishFloat(soilMoistureTopics[p], probe.moisture_percentage);
+        }
+        if (decision.due[REPORT_METRIC_SOIL_TEMP(p)]) {
+            publishFloat(soilTempTopics[p], probe.temperature_celsius);
+        }
     }
+
+}
+#endif
+
+static int16_t toCenti(float value) {
+    return (int16_t)lroundf(value * 100.0f);
+}
+
+// Snapshot plus system stats in the codec's fixed-point form
+static void fillTelemetryFrame(TelemetryFrame& frame, const AHT20_Data& ahtData, const ADS1115_Data& soilData) {
+    memset(&frame, 0, sizeof(frame));
+    memcpy(frame.mac, deviceMac, sizeof(frame.mac));
+    frame.epoch = getEpochTime();
+    formatTimestamp(frame.timestamp, sizeof(frame.timestamp));
     
-    // Soil sensor 1
-    if (soilData.sensor1.sensor_working) {
-        mqttClient.publish((baseTopic + "/soil/1/moisture").c_str(), String(soilData.sensor1.moisture_percentage).c_str());
-        mqttClient.publish((baseTopic + "/soil/1/temperature").c_str(), String(soilData.sensor1.temperature_celsius).c_str());
+    // Air sensor data (AHT20)
+    if (isAirSampleValid(ahtData)) {
+        frame.air_valid = true;
+        frame.air_temperature_centi = toCenti(ahtData.temperature);
+        frame.air_humidity_centi = toCenti(ahtData.humidity);
     }
     
-    // Soil sensor 2
-    if (soilData.sensor2.sensor_working) {
-        mqttClient.publish((baseTopic + "/soil/2/moisture").c_str(), String(soilData.sensor2.moisture_percentage).c_str());
-        mqttClient.publish((baseTopic + "/soil/2/temperature").c_str(), String(soilData.sensor2.temperature_celsius).c_str());
+    // Soil sensor data, working probes only
+    for (uint8_t p = 0; p < soilData.probe_count; p++) {
+        const SoilSensorData& probe = soilData.probes[p];
+        if (!isSoilProbeValid(soilData, p)) continue;
+        TelemetryProbe& out = frame.probes[frame.probe_count++];
+        out.index = p;
+        out.moisture_centi = toCenti(probe.moisture_percentage);
+        out.temperature_centi = toCenti(probe.temperature_celsius);
+        out.moisture_raw = probe.raw_moisture;
+        out.temp_raw = probe.raw_temperature;
     }
     
-    // Device status
-    mqttClient.publish((baseTopic + "/status").c_str(), "online");
-    mqttClient.publish((baseTopic + "/wifi_rssi").c_str(), String(WiFi.RSSI()).c_str());
+    // System info
+    frame.wifi_rssi = WiFi.RSSI();
+    const MemoryStats& mem = getMemoryStats();
+    frame.free_heap = mem.free_heap;
+    frame.min_free_heap = mem.min_free_heap;
+    frame.largest_block = mem.largest_free_block;
+    frame.min_largest_block = mem.min_largest_block;
+    frame.alloc_failures = mem.alloc_failures;
+    frame.loop_stack_free = mem.loop_stack_free;
+    frame.memory_warnings = mem.warnings;
+    const MQTTQueueStats& queue = getMQTTQueueStats();
+    frame.queue_depth = queue.depth;
+    frame.delivered = queue.delivered;
+    frame.dropped = queue.dropped;
+    frame.retransmits = queue.retransmits;
+    frame.ack_ms = queue.last_ack_ms;
+    frame.ack_ms_max = queue.max_ack_ms;
 }
 
-void publishSensorData(const AHT20_Data& ahtData, const ADS1115_Data& soilData) {
-    if (MQTT_SERVER.length() == 0) return;
+// Queues the combined message (always complete) for QoS1 delivery and, unless
+// MQTT_INDIVIDUAL_TOPICS is 0, publishes the due individual topics at QoS0.
+// Returns true if the combined message was accepted by the queue.
+bool publishSensorData(const AHT20_Data& ahtData, const ADS1115_Data& soilData, const ReportDecision& decision) {
+    if (MQTT_SERVER.length() == 0) return false;
     
-    if (!mqttConnected) {
-        Serial.println("⚠️ MQTT not connected, attempting to reconnect...");
-        if (!connectMQTT()) {
-            Serial.println("❌ Cannot publish data - MQTT not connected");
-            return;
-        }
+    if (!isMQTTConnected()) {
+        Serial.println("❌ Cannot publish data - MQTT not connected");
+        return false;
     }
     
     Serial.println("📤 Publishing sensor data to MQTT...");
     
-    String timestamp = getTimestamp();
-    String deviceId = String(WiFi.macAddress());
-    
-    // Create JSON document with all sensor data
-    StaticJsonDocument<512> doc;
-    doc["device_id"] = deviceId;
-    doc["timestamp"] = timestamp;
+    TelemetryFrame frame;
+    fillTelemetryFrame(frame, ahtData, soilData);
     
-    // Air sensor data (AHT20)
-    if (ahtData.sensor_found && ahtData.last_error.isEmpty()) {
-        JsonObject air = doc.createNestedObject("air");
-        air["temperature"] = ahtData.temperature;
-        air["humidity"] = ahtData.humidity;
+    // Queue for the main topic; the queue delivers it at QoS1
+#if TELEMETRY_CODEC == TELEMETRY_CODEC_CBOR
+    size_t length = encodeTelemetryCBOR(frame, (uint8_t*)payloadBuffer, sizeof(payloadBuffer));
+#else
+    size_t length = encodeTelemetryJSON(frame, payloadBuffer, sizeof(payloadBuffer));
+#endif
+    bool published = length > 0 && mqttEnqueue(sensorsTopic, payloadBuffer, length, false);
+    if (published) {
+        Serial.println("✅ Data queued for MQTT (QoS1)");
+        Serial.print("   Topic: ");
+        Serial.println(sensorsTopic);
+#if TELEMETRY_CODEC == TELEMETRY_CODEC_CBOR
+        Serial.println("   CBOR: " + String(length) + " bytes");
+#else
+        Serial.print("   JSON: ");
+        Serial.println(payloadBuffer);
+#endif
+    } else {
+        Serial.println("❌ Failed to publish data to MQTT");
     }
     
-    // Soil sensor data
-    JsonObject soil = doc.createNestedObject("soil");
+#if MQTT_INDIVIDUAL_TOPICS
+    // Also publish individual topics for easier parsing
+    publishIndividualTopics(ahtData, soilData, decision);
+#endif
     
-    // Sensor 1
-    if (soilData.sensor1.sensor_working) {
-        JsonObject sensor1 = soil.createNestedObject("sensor1");
-        sensor1["moisture"] = soilData.sensor1.moisture_percentage;
-        sensor1["temperature"] = soilData.sensor1.temperature_celsius;
-        sensor1["moisture_raw"] = soilData.sensor1.raw_moisture;
-        sensor1["temp_raw"] = soilData.sensor1.raw_temperature;
-    }
+    lastMQTTPublish = millis();
+    return published;
+}
+
+// Backlog replay: one logged sample per message on <prefix>/<device>/backlog
+// (backlog/cbor with the CBOR codec), queued at QoS1. The frame carries the
+// record's sequence and the time it was taken; system stats and raw counts
+// are not logged and are left out. onDelivered gets the sequence on PUBACK.
+bool publishLoggedSample(const SampleLogRecord& record, MQTTDeliveredCallback onDelivered) {
+    TelemetryFrame frame;
+    memset(&frame, 0, sizeof(frame));
+    memcpy(frame.mac, deviceMac, sizeof(frame.mac));
+    frame.logged = true;
+    frame.sequence = record.sequence;
+    frame.epoch = record.epoch;
+    formatEpochTime(record.epoch, frame.timestamp, sizeof(frame.timestamp));
     
-    // Sensor 2
-    if (soilData.sensor2.sensor_working) {
-        JsonObject sensor2 = soil.createNestedObject("sensor2");
-        sensor2["moisture"] = soilData.sensor2.moisture_percentage;
-        sensor2["temperature"] = soilData.sensor2.temperature_celsius;
-        sensor2["moisture_raw"] = soilData.sensor2.raw_moisture;
-        sensor2["temp_raw"] = soilData.sensor2.raw_temperature;
+    if (record.value[REPORT_METRIC_AIR_TEMP] != HISTORY_NO_DATA) {
+        frame.air_valid = true;
+        frame.air_temperature_centi = record.value[REPORT_METRIC_AIR_TEMP];
+        frame.air_humidity_centi = record.value[REPORT_METRIC_AIR_HUMIDITY];
     }
     
-    // System info
-    doc["wifi_rssi"] = WiFi.RSSI();
-    doc["free_heap"] = ESP.getFreeHeap();
-    
-    // Publish to main topic
-    String topic = MQTT_TOPIC_PREFIX + "/" + deviceId + "/sensors";
-    String jsonOutput;
-    serializeJson(doc, jsonOutput);
-    
-    if (mqttClient.publish(topic.c_str(), jsonOutput.c_str())) {
-        Serial.println("✅ Data published to MQTT");
-        Serial.println("   Topic: " + topic);
-        Serial.println("   JSON: " + jsonOutput);
-    } else {
-        Serial.println("❌ Failed to publish data to MQTT");
+    for (uint8_t p = 0; p < MAX_SOIL_PROBES; p++) {
+        if (record.value[REPORT_METRIC_SOIL_MOISTURE(p)] == HISTORY_NO_DATA) continue;
+        TelemetryProbe& out = frame.probes[frame.probe_count++];
+        out.index = p;
+        out.moisture_centi = record.value[REPORT_METRIC_SOIL_MOISTURE(p)];
+        out.temperature_centi = record.value[REPORT_METRIC_SOIL_TEMP(p)];
     }
     
-    // Also publish individual topics for easier parsing
-    publishIndividualTopics(ahtData, soilData, deviceId);
-    
-    lastMQTTPublish = millis();
+#if TELEMETRY_CODEC == TELEMETRY_CODEC_CBOR
+    size_t length = encodeTelemetryCBOR(frame, (uint8_t*)payloadBuffer, sizeof(payloadBuffer));
+#else
+    size_t length = encodeTelemetryJSON(frame, payloadBuffer, sizeof(payloadBuffer));
+#endif
+    return length > 0 && mqttEnqueue(backlogTopic, payloadBuffer, length, false, onDelivered, record.sequence);
 }
 
-// Topic generation functions (simplified)
+// Topic generation functions, for callers outside the publish path
 String getTopic(const String& subtopic) {
-    String deviceId = String(WiFi.macAddress());
-    return MQTT_TOPIC_PREFIX + "/" + deviceId + "/" + subtopic;
+    return String(baseTopic) + "/" + subtopic;
 }
 
 String getAirTempTopic() {
-    return getTopic("air/temperature");
+    return String(airTempTopic);
 }
 
 String getAirHumidityTopic() {
-    return getTopic("air/humidity");
+    return String(airHumidityTopic);
 }
 
 String getSoilMoistureTopic(int sensorNum) {
@@ -210,5 +713,5 @@ String getSoilTempTopic(int sensorNum) {
 }
 
 String getStatusTopic() {
-    return getTopic("status");
+    return String(statusTopic);
 }
\ No newline at end of file
@@ -5,19 +5,40 @@
 #include <WiFi.h>
 #include <PubSubClient.h>
 #include <ArduinoJson.h>
+#include "mqtt_queue.h"
 
 // Forward declarations
 struct AHT20_Data;
 struct ADS1115_Data;
+struct ReportDecision;
+struct SampleLogRecord;
+
+// Reconnect counters. Times are in ms; time-to-reconnect runs from the moment
+// a lost connection is noticed until the broker accepts the next CONNECT.
+struct MQTTConnectionStats {
+    uint32_t attempts;            // Connection attempts started
+    uint32_t failures;            // Attempts that failed (DNS, TCP or MQTT)
+    uint32_t connects;            // Successful connections
+    uint32_t disconnects;         // Established connections that dropped
+    uint32_t dns_lookups;         // Broker name resolutions
+    uint32_t backoff_ms;          // Current backoff before jitter
+    uint32_t last_reconnect_ms;   // Most recent time-to-reconnect
+    uint32_t max_reconnect_ms;    // Longest time-to-reconnect
+};
 
 // Function declarations
 void initMQTT();
 bool connectMQTT();
-void publishSensorData(const AHT20_Data& ahtData, const ADS1115_Data& soilData);
+bool publishSensorData(const AHT20_Data& ahtData, const ADS1115_Data& soilData, const ReportDecision& decision);
+bool publishLoggedSample(const SampleLogRecord& record, MQTTDeliveredCallback onDelivered);
 void mqttLoop();
 bool isMQTTConnected();
 void checkMQTTConnection();
+const MQTTConnectionStats& getMQTTConnectionStats();
+void printMQTTConnectionStats();
 void mqttCallback(char* topic, byte* payload, unsigned int length);
+void publishCommandResult(const char* result);
+void publishDeviceInfo();
 bool shouldPublishMQTT();
 
 // Topic generators
@@ -0,0 +1,212 @@
+#include "mqtt_queue.h"
+#include "mqtt_transport.h"
+
+// Fixed-memory outbound queue delivered at QoS1. A message stays in its
+// slot from mqttEnqueue() until the broker's PUBACK; if the ack does not
+// arrive within MQTT_QUEUE_ACK_TIMEOUT, or the connection drops, it is
+// sent again with the DUP flag. A message with a delivery callback is
+// never coalesced or evicted; it only takes a free slot.
+
+enum MQTTSlotState : uint8_t {
+  SLOT_FREE,
+  SLOT_QUEUED,      // Waiting to be (re)sent
+  SLOT_IN_FLIGHT    // Sent, waiting for the PUBACK
+};
+
+struct MQTTQueueSlot {
+  MQTTSlotState state;
+  bool retained;
+  bool dup;                 // Already transmitted at least once
+  uint16_t packet_id;
+  uint16_t length;
+  uint32_t order;           // Enqueue order, for oldest-first delivery
+  MQTTDeliveredCallback on_delivered;
+  uint32_t context;
+  unsigned long first_sent_ms;
+  unsigned long last_sent_ms;
+  char topic[MQTT_TOPIC_MAX];
+  char payload[MQTT_QUEUE_PAYLOAD_MAX];
+};
+
+static MQTTQueueSlot slots[MQTT_QUEUE_DEPTH];
+static MQTTQueueStats stats = {};
+static uint32_t nextOrder = 0;
+static uint16_t nextPacketId = 1;
+static bool wasConnected = false;
+
+static uint16_t allocatePacketId() {
+  uint16_t id = nextPacketId++;
+  if (nextPacketId == 0) nextPacketId = 1;  // 0 is not a valid packet id
+  return id;
+}
+
+static void updateDepth() {
+  uint8_t depth = 0;
+  uint8_t inFlight = 0;
+  for (uint8_t i = 0; i < MQTT_QUEUE_DEPTH; i++) {
+    if (slots[i].state != SLOT_FREE) depth++;
+    if (slots[i].state == SLOT_IN_FLIGHT) inFlight++;
+  }
+  stats.depth = depth;
+  stats.in_flight = inFlight;
+  if (depth > stats.max_depth) stats.max_depth = depth;
+}
+
+// Oldest used slot, either among those not yet sent or among those the
+// drop policy may evict
+static MQTTQueueSlot* oldestSlot(bool queuedOnly) {
+  MQTTQueueSlot* oldest = nullptr;
+  for (uint8_t i = 0; i < MQTT_QUEUE_DEPTH; i++) {
+    MQTTQueueSlot& slot = slots[i];
+    if (slot.state == SLOT_FREE) continue;
+    if (queuedOnly && slot.state != SLOT_QUEUED) continue;
+    if (!queuedOnly && slot.on_delivered != nullptr) continue;
+    if (oldest == nullptr || (int32_t)(slot.order - oldest->order) < 0) oldest = &slot;
+  }
+  return oldest;
+}
+
+static MQTTQueueSlot* freeSlot() {
+  for (uint8_t i = 0; i < MQTT_QUEUE_DEPTH; i++) {
+    if (slots[i].state == SLOT_FREE) return &slots[i];
+  }
+  return nullptr;
+}
+
+static void onPubAck(uint16_t packetId) {
+  for (uint8_t i = 0; i < MQTT_QUEUE_DEPTH; i++) {
+    MQTTQueueSlot& slot = slots[i];
+    if (slot.state != SLOT_IN_FLIGHT || slot.packet_id != packetId) continue;
+    
+    uint32_t latency = millis() - slot.first_sent_ms;
+    stats.last_ack_ms = latency;
+    if (latency > stats.max_ack_ms) stats.max_ack_ms = latency;
+    stats.total_ack_ms += latency;
+    stats.delivered++;
+    slot.state = SLOT_FREE;
+    updateDepth();
+    if (slot.on_delivered != nullptr) slot.on_delivered(slot.context);
+    return;
+  }
+}
+
+void initMQTTQueue() {
+  mqttTransport.setPubAckCallback(onPubAck);
+}
+
+// Copies the message into the queue. Returns false if the drop policy
+// rejected it or it does not fit a slot; with onDelivered set, also when
+// no slot is free (nothing is counted as dropped, the caller retries).
+bool mqttEnqueue(const char* topic, const char* payload, size_t length, bool retained,
+                 MQTTDeliveredCallback onDelivered, uint32_t context) {
+  if (length > MQTT_QUEUE_PAYLOAD_MAX || strlen(topic) >= MQTT_TOPIC_MAX) {
+    stats.dropped++;
+    Serial.println("❌ MQTT message too large for the queue: " + String(topic));
+    return false;
+  }
+  
+  MQTTQueueSlot* slot = nullptr;
+  if (onDelivered != nullptr) {
+    slot = freeSlot();
+    if (slot == nullptr) return false;
+  }
+  
+#if MQTT_QUEUE_DROP_POLICY == MQTT_DROP_COALESCE
+  // A newer message replaces an unsent one on the same topic
+  for (uint8_t i = 0; i < MQTT_QUEUE_DEPTH && slot == nullptr; i++) {
+    if (slots[i].state == SLOT_QUEUED && !slots[i].dup && slots[i].on_delivered == nullptr &&
+        strcmp(slots[i].topic, topic) == 0) {
+      slot = &slots[i];
+      stats.coalesced++;
+    }
+  }
+#endif
+  
+  if (slot == nullptr) {
+    slot = freeSlot();
+  }
+  
+  if (slot == nullptr) {
+#if MQTT_QUEUE_DROP_POLICY == MQTT_DROP_NEWEST
+    stats.dropped++;
+    return false;
+#else
+    slot = oldestSlot(false);
+    stats.dropped++;
+    if (slot == nullptr) return false;  // Every slot waits on a delivery callback
+#endif
+  }
+  
+  slot->state = SLOT_QUEUED;
+  slot->retained = retained;
+  slot->dup = false;
+  slot->packet_id = allocatePacketId();
+  slot->length = length;
+  slot->order = nextOrder++;
+  slot->on_delivered = onDelivered;
+  slot->context = context;
+  strcpy(slot->topic, topic);
+  memcpy(slot->payload, payload, length);
+  
+  stats.enqueued++;
+  updateDepth();
+  return true;
+}
+
+static bool transmit(MQTTQueueSlot& slot) {
+  if (!mqttTransport.publishQoS1(slot.topic, (const uint8_t*)slot.payload, slot.length,
+                                 slot.packet_id, slot.dup, slot.retained)) {
+    return false;
+  }
+  if (slot.dup) {
+    stats.retransmits++;
+  } else {
+    slot.first_sent_ms = millis();
+  }
+  slot.dup = true;
+  slot.last_sent_ms = millis();
+  slot.state = SLOT_IN_FLIGHT;
+  return true;
+}
+
+// Called after every mqttClient.loop(). Resends unacknowledged messages and
+// keeps up to MQTT_QUEUE_MAX_INFLIGHT messages on the wire, oldest first.
+void handleMQTTQueue(bool connected) {
+  if (!connected) {
+    if (wasConnected) {
+      // The session is gone; everything unacknowledged goes out again
+      for (uint8_t i = 0; i < MQTT_QUEUE_DEPTH; i++) {
+        if (slots[i].state == SLOT_IN_FLIGHT) slots[i].state = SLOT_QUEUED;
+      }
+      updateDepth();
+    }
+    wasConnected = false;
+    return;
+  }
+  wasConnected = true;
+  
+  for (uint8_t i = 0; i < MQTT_QUEUE_DEPTH; i++) {
+    MQTTQueueSlot& slot = slots[i];
+    if (slot.state == SLOT_IN_FLIGHT && millis() - slot.last_sent_ms >= MQTT_QUEUE_ACK_TIMEOUT) {
+      transmit(slot);
+    }
+  }
+  
+  while (stats.in_flight < MQTT_QUEUE_MAX_INFLIGHT) {
+    MQTTQueueSlot* slot = oldestSlot(true);
+    if (slot == nullptr || !transmit(*slot)) break;
+    updateDepth();
+  }
+}
+
+const MQTTQueueStats& getMQTTQueueStats() {
+  return stats;
+}
+
+void printMQTTQueueStats() {
+  uint32_t avg = stats.delivered ? (uint32_t)(stats.total_ack_ms / stats.delivered) : 0;
+  Serial.println("📬 MQTT queue: " + String(stats.depth) + "/" + String(MQTT_QUEUE_DEPTH) + " (max " + String(stats.max_depth) +
+                 "), " + String(stats.delivered) + "/" + String(stats.enqueued) + " acked, " + String(stats.dropped) + " dropped, " +
+                 String(stats.coalesced) + " coalesced, " + String(stats.retransmits) + " retransmits, ack " + String(avg) +
+                 " ms avg / " + String(stats.max_ack_ms) + " ms max");
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+// mqtt_queue.h
+#ifndef MQTT_QUEUE_H
+#define MQTT_QUEUE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Delivery counters since boot
+struct MQTTQueueStats {
+  uint8_t depth;              // Messages waiting or awaiting their PUBACK
+  uint8_t max_depth;
+  uint8_t in_flight;          // Sent, PUBACK not yet received
+  uint32_t enqueued;
+  uint32_t delivered;         // Acknowledged by the broker
+  uint32_t dropped;           // Evicted or rejected by the drop policy
+  uint32_t coalesced;         // Replaced by a newer message on the same topic
+  uint32_t retransmits;
+  uint32_t last_ack_ms;       // First transmission to PUBACK
+  uint32_t max_ack_ms;
+  uint64_t total_ack_ms;      // For the average: total_ack_ms / delivered
+};
+
+// Called with the message's context once the broker has acknowledged it
+typedef void (*MQTTDeliveredCallback)(uint32_t context);
+
+// Function declarations
+void initMQTTQueue();
+bool mqttEnqueue(const char* topic, const char* payload, size_t length, bool retained,
+                 MQTTDeliveredCallback onDelivered = nullptr, uint32_t context = 0);
+void handleMQTTQueue(bool connected);
+const MQTTQueueStats& getMQTTQueueStats();
+void printMQTTQueueStats();
+
+#endif
\ No newline at end of file
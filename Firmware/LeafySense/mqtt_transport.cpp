@@ -0,0 +1,263 @@
+#include "mqtt_transport.h"
+
+#define MQTT_PACKET_CONNECT 0x10
+#define MQTT_PACKET_CONNACK 0x20
+#define MQTT_PACKET_PUBLISH 0x30
+#define MQTT_PACKET_PUBACK 0x40
+#define MQTT_FLAG_DUP 0x08
+#define MQTT_FLAG_QOS1 0x02
+#define MQTT_FLAG_RETAIN 0x01
+
+// CONNECT flags
+#define MQTT_CONNECT_CLEAN_SESSION 0x02
+#define MQTT_CONNECT_WILL 0x04
+#define MQTT_CONNECT_WILL_QOS1 0x08
+#define MQTT_CONNECT_WILL_RETAIN 0x20
+#define MQTT_CONNECT_PASSWORD 0x40
+#define MQTT_CONNECT_USER 0x80
+
+enum MQTTRxState {
+  RX_HEADER,
+  RX_LENGTH,
+  RX_BODY
+};
+
+MQTTTransport::MQTTTransport(WiFiClient& socket) : socket(socket), pubAckCallback(nullptr) {
+  resetParser();
+  resetHandshake();
+}
+
+void MQTTTransport::setPubAckCallback(MQTTPubAckCallback callback) {
+  pubAckCallback = callback;
+}
+
+void MQTTTransport::resetParser() {
+  rxState = RX_HEADER;
+  rxType = 0;
+  rxLengthShift = 0;
+  rxRemaining = 0;
+  rxBodyPos = 0;
+  rxPacketId = 0;
+}
+
+void MQTTTransport::resetHandshake() {
+  connAckLength = 0;
+  replayPos = 0;
+  replayLength = 0;
+  dropConnect = false;
+}
+
+// Follows the packet framing of everything PubSubClient reads. A PUBACK is
+// a 2-byte body holding the packet identifier.
+void MQTTTransport::scanByte(uint8_t b) {
+  switch (rxState) {
+    case RX_HEADER:
+      rxType = b & 0xF0;
+      rxRemaining = 0;
+      rxLengthShift = 0;
+      rxState = RX_LENGTH;
+      break;
+      
+    case RX_LENGTH:
+      rxRemaining |= (uint32_t)(b & 0x7F) << rxLengthShift;
+      rxLengthShift += 7;
+      if (b & 0x80) {
+        if (rxLengthShift > 21) resetParser();  // Malformed; resync on the next packet
+        break;
+      }
+      rxBodyPos = 0;
+      rxPacketId = 0;
+      rxState = (rxRemaining > 0) ? RX_BODY : RX_HEADER;
+      break;
+      
+    case RX_BODY:
+      if (rxBodyPos < 2) {
+        rxPacketId = (rxPacketId << 8) | b;
+      }
+      rxBodyPos++;
+      if (--rxRemaining == 0) {
+        if (rxType == MQTT_PACKET_PUBACK && rxBodyPos >= 2 && pubAckCallback != nullptr) {
+          pubAckCallback(rxPacketId);
+        }
+        rxState = RX_HEADER;
+      }
+      break;
+  }
+}
+
+// Writes one PUBLISH packet with QoS 1. The caller owns the packet id and
+// resends with dup set until the PUBACK arrives.
+bool MQTTTransport::publishQoS1(const char* topic, const uint8_t* payload, size_t length,
+                                uint16_t packetId, bool dup, bool retained) {
+  size_t topicLength = strlen(topic);
+  uint32_t remaining = 2 + topicLength + 2 + length;
+  
+  uint8_t header[9];
+  uint8_t pos = 0;
+  header[pos++] = MQTT_PACKET_PUBLISH | MQTT_FLAG_QOS1 | (dup ? MQTT_FLAG_DUP : 0) | (retained ? MQTT_FLAG_RETAIN : 0);
+  do {
+    uint8_t digit = remaining & 0x7F;
+    remaining >>= 7;
+    header[pos++] = digit | (remaining > 0 ? 0x80 : 0);
+  } while (remaining > 0 && pos < 5);
+  header[pos++] = topicLength >> 8;
+  header[pos++] = topicLength & 0xFF;
+  
+  uint8_t id[2] = {(uint8_t)(packetId >> 8), (uint8_t)(packetId & 0xFF)};
+  
+  return socket.write(header, pos) == pos &&
+         socket.write((const uint8_t*)topic, topicLength) == topicLength &&
+         socket.write(id, sizeof(id)) == sizeof(id) &&
+         (length == 0 || socket.write(payload, length) == length);
+}
+
+bool MQTTTransport::writeString(const char* text) {
+  size_t length = strlen(text);
+  uint8_t prefix[2] = {(uint8_t)(length >> 8), (uint8_t)(length & 0xFF)};
+  return socket.write(prefix, sizeof(prefix)) == sizeof(prefix) &&
+         (length == 0 || socket.write((const uint8_t*)text, length) == length);
+}
+
+// Writes an MQTT 3.1.1 CONNECT with a clean session and a QoS 1 will, the
+// same packet PubSubClient would build. user and password may be null.
+bool MQTTTransport::sendConnect(const char* clientId, const char* user, const char* password,
+                                const char* willTopic, const char* willMessage, bool willRetain, uint16_t keepAlive) {
+  resetParser();
+  resetHandshake();
+  
+  uint8_t flags = MQTT_CONNECT_CLEAN_SESSION | MQTT_CONNECT_WILL | MQTT_CONNECT_WILL_QOS1 |
+                  (willRetain ? MQTT_CONNECT_WILL_RETAIN : 0);
+  uint32_t remaining = 10 + 2 + strlen(clientId) + 2 + strlen(willTopic) + 2 + strlen(willMessage);
+  if (user != nullptr) {
+    flags |= MQTT_CONNECT_USER;
+    remaining += 2 + strlen(user);
+  }
+  if (password != nullptr) {
+    flags |= MQTT_CONNECT_PASSWORD;
+    remaining += 2 + strlen(password);
+  }
+  
+  uint8_t header[15];
+  uint8_t pos = 0;
+  header[pos++] = MQTT_PACKET_CONNECT;
+  do {
+    uint8_t digit = remaining & 0x7F;
+    remaining >>= 7;
+    header[pos++] = digit | (remaining > 0 ? 0x80 : 0);
+  } while (remaining > 0 && pos < 5);
+  const uint8_t variable[] = {0x00, 0x04, 'M', 'Q', 'T', 'T', 0x04, flags,
+                              (uint8_t)(keepAlive >> 8), (uint8_t)(keepAlive & 0xFF)};
+  memcpy(header + pos, variable, sizeof(variable));
+  pos += sizeof(variable);
+  
+  return socket.write(header, pos) == pos &&
+         writeString(clientId) && writeString(willTopic) && writeString(willMessage) &&
+         (user == nullptr || writeString(user)) &&
+         (password == nullptr || writeString(password));
+}
+
+// Reads whatever part of the CONNACK has arrived without waiting
+int MQTTTransport::pollConnAck() {
+  while (connAckLength < sizeof(connAck) && socket.available() > 0) {
+    int b = socket.read();
+    if (b < 0) break;
+    connAck[connAckLength++] = (uint8_t)b;
+  }
+  if (connAckLength < sizeof(connAck)) {
+    return socket.connected() ? MQTT_CONNACK_PENDING : MQTT_CONNACK_LOST;
+  }
+  if (connAck[0] != MQTT_PACKET_CONNACK || connAck[1] != 2) return MQTT_CONNACK_MALFORMED;
+  return connAck[3];
+}
+
+// Call after pollConnAck() returned 0, right before PubSubClient::connect()
+void MQTTTransport::handOverSession() {
+  resetParser();
+  dropConnect = true;
+  replayPos = 0;
+  replayLength = connAckLength;
+}
+
+int MQTTTransport::connect(IPAddress ip, uint16_t port) {
+  resetParser();
+  return socket.connect(ip, port);
+}
+
+int MQTTTransport::connect(const char* host, uint16_t port) {
+  resetParser();
+  return socket.connect(host, port);
+}
+
+int MQTTTransport::connect(IPAddress ip, uint16_t port, int32_t timeout) {
+  resetParser();
+  return socket.connect(ip, port, timeout);
+}
+
+int MQTTTransport::connect(const char* host, uint16_t port, int32_t timeout) {
+  resetParser();
+  return socket.connect(host, port, timeout);
+}
+
+size_t MQTTTransport::write(uint8_t b) {
+  return socket.write(b);
+}
+
+// PubSubClient writes each packet with a single write(), so the CONNECT it
+// sends after handOverSession() arrives here whole
+size_t MQTTTransport::write(const uint8_t* buf, size_t size) {
+  if (dropConnect && size > 0 && (buf[0] & 0xF0) == MQTT_PACKET_CONNECT) {
+    dropConnect = false;
+    return size;
+  }
+  return socket.write(buf, size);
+}
+
+// Replayed CONNACK bytes come first and bypass the PUBACK scanner
+int MQTTTransport::available() {
+  return (replayLength - replayPos) + socket.available();
+}
+
+int MQTTTransport::read() {
+  if (replayPos < replayLength) return connAck[replayPos++];
+  int b = socket.read();
+  if (b >= 0) scanByte((uint8_t)b);
+  return b;
+}
+
+int MQTTTransport::read(uint8_t* buf, size_t size) {
+  size_t replayed = 0;
+  while (replayed < size && replayPos < replayLength) {
+    buf[replayed++] = connAck[replayPos++];
+  }
+  if (replayed == size) return replayed;
+  
+  int count = socket.read(buf + replayed, size - replayed);
+  if (count < 0) return replayed > 0 ? (int)replayed : count;
+  for (int i = 0; i < count; i++) {
+    scanByte(buf[replayed + i]);
+  }
+  return replayed + count;
+}
+
+int MQTTTransport::peek() {
+  if (replayPos < replayLength) return connAck[replayPos];
+  return socket.peek();
+}
+
+void MQTTTransport::flush() {
+  socket.flush();
+}
+
+void MQTTTransport::stop() {
+  resetParser();
+  resetHandshake();
+  socket.stop();
+}
+
+uint8_t MQTTTransport::connected() {
+  return socket.connected();
+}
+
+MQTTTransport::operator bool() {
+  return (bool)socket;
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+// mqtt_transport.h
+#ifndef MQTT_TRANSPORT_H
+#define MQTT_TRANSPORT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+// Called with the packet identifier of every PUBACK the broker sends
+typedef void (*MQTTPubAckCallback)(uint16_t packetId);
+
+// pollConnAck() results besides the broker's return code (0 = accepted)
+#define MQTT_CONNACK_PENDING -1
+#define MQTT_CONNACK_LOST -2         // Connection closed before a CONNACK
+#define MQTT_CONNACK_MALFORMED -3    // First packet was not a CONNACK
+
+// Client that sits between PubSubClient and the WiFi socket. PubSubClient
+// only publishes at QoS0 and discards PUBACKs, so this layer writes QoS1
+// PUBLISH packets itself and watches the inbound stream for the acks.
+//
+// The handshake is split the same way so it never waits: sendConnect()
+// writes CONNECT and pollConnAck() collects the CONNACK as it arrives. Once
+// the broker accepts, handOverSession() lets PubSubClient::connect() run
+// without touching the network: its own CONNECT is dropped and the CONNACK
+// already received is replayed to it. Everything else passes straight
+// through.
+class MQTTTransport : public Client {
+public:
+  explicit MQTTTransport(WiFiClient& socket);
+  
+  bool publishQoS1(const char* topic, const uint8_t* payload, size_t length,
+                   uint16_t packetId, bool dup, bool retained);
+  void setPubAckCallback(MQTTPubAckCallback callback);
+  
+  bool sendConnect(const char* clientId, const char* user, const char* password,
+                   const char* willTopic, const char* willMessage, bool willRetain, uint16_t keepAlive);
+  int pollConnAck();
+  void handOverSession();
+  
+  int connect(IPAddress ip, uint16_t port) override;
+  int connect(const char* host, uint16_t port) override;
+  int connect(IPAddress ip, uint16_t port, int32_t timeout) override;
+  int connect(const char* host, uint16_t port, int32_t timeout) override;
+  size_t write(uint8_t b) override;
+  size_t write(const uint8_t* buf, size_t size) override;
+  int available() override;
+  int read() override;
+  int read(uint8_t* buf, size_t size) override;
+  int peek() override;
+  void flush() override;
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() override;
+  
+private:
+  void resetParser();
+  void resetHandshake();
+  void scanByte(uint8_t b);
+  bool writeString(const char* text);
+  
+  WiFiClient& socket;
+  MQTTPubAckCallback pubAckCallback;
+  
+  // Inbound packet framing: fixed header, remaining length, body
+  uint8_t rxState;
+  uint8_t rxType;
+  uint8_t rxLengthShift;
+  uint32_t rxRemaining;
+  uint32_t rxBodyPos;
+  uint16_t rxPacketId;
+  
+  // Handshake: the CONNACK as received, and how much of it has been
+  // replayed to PubSubClient
+  uint8_t connAck[4];
+  uint8_t connAckLength;
+  uint8_t replayPos;
+  uint8_t replayLength;
+  bool dropConnect;
+};
+
+extern MQTTTransport mqttTransport;
+
+#endif
\ No newline at end of file
@@ -3,45 +3,45 @@
 #include <Arduino.h>
 
 bool timeSynced = false;
+static bool syncPending = false;
+static unsigned long syncStartedAt = 0;
+static bool syncFailureReported = false;
 
+// Starts SNTP and returns; handleNTPSync() reports the result. Called on
+// every WiFi (re)connect, so it must not block the sampling loop.
 void initNTP() {
   Serial.println("⏰ Initializing NTP time synchronization...");
   
   configTime(GMT_OFFSET_SEC, DAYLIGHT_OFFSET_SEC, NTP_SERVER);
-  delay(1000);
-  
-  if (syncNTPTime()) {
-    Serial.println("✅ NTP time synchronized!");
-  } else {
-    Serial.println("❌ NTP time synchronization failed!");
-  }
+  syncPending = true;
+  syncFailureReported = false;
+  syncStartedAt = millis();
 }
 
+// True once the system clock holds a plausible wall-clock time
 bool syncNTPTime() {
-  Serial.print("🕒 Synchronizing time with NTP server...");
-  
-  int attempts = 0;
-  while (!time(nullptr) && attempts < 20) {
-    Serial.print(".");
-    delay(500);
-    attempts++;
-  }
-  
-  if (attempts >= 20) {
-    Serial.println(" FAILED");
-    timeSynced = false;
+  if (time(nullptr) < NTP_MIN_VALID_EPOCH) {
     return false;
   }
-  
-  Serial.println(" SUCCESS");
   timeSynced = true;
-  
-  DateTime currentTime = getCurrentTime();
-  Serial.println("   Current time: " + currentTime.timestamp);
-  
   return true;
 }
 
+void handleNTPSync() {
+  if (!syncPending) return;
+  
+  if (syncNTPTime()) {
+    syncPending = false;
+    Serial.println("✅ NTP time synchronized!");
+    DateTime currentTime = getCurrentTime();
+    Serial.println("   Current time: " + currentTime.timestamp);
+  } else if (!syncFailureReported && millis() - syncStartedAt >= NTP_SYNC_TIMEOUT) {
+    // SNTP keeps polling in the background, so a late answer still counts
+    syncFailureReported = true;
+    Serial.println("❌ NTP time synchronization failed!");
+  }
+}
+
 DateTime getCurrentTime() {
   DateTime dt;
   
@@ -73,6 +73,29 @@ String getTimestamp() {
   return getCurrentTime().timestamp;
 }
 
+// Same text as getTimestamp(), written into the caller's buffer
+size_t formatTimestamp(char* buffer, size_t size) {
+  return formatEpochTime(getEpochTime(), buffer, size);
+}
+
+// Local time of a stored Unix time, in the format of formatTimestamp();
+// 0 (taken before the clock was synced) gives the unsynchronized text
+size_t formatEpochTime(uint32_t epoch, char* buffer, size_t size) {
+  if (epoch == 0) {
+    return snprintf(buffer, size, "Time not synchronized");
+  }
+  
+  time_t t = epoch;
+  struct tm timeinfo;
+  localtime_r(&t, &timeinfo);
+  return strftime(buffer, size, "%Y-%m-%d %H:%M:%S", &timeinfo);
+}
+
+// Unix time, or 0 until NTP has synchronized
+uint32_t getEpochTime() {
+  return timeSynced ? (uint32_t)time(nullptr) : 0;
+}
+
 void printCurrentTime() {
   DateTime current = getCurrentTime();
   Serial.println("⏰ Current Time: " + current.timestamp);
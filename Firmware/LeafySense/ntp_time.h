@@ -17,8 +17,12 @@ struct DateTime {
 // Function declarations
 void initNTP();
 bool syncNTPTime();
+void handleNTPSync();
 DateTime getCurrentTime();
 String getTimestamp();
+size_t formatTimestamp(char* buffer, size_t size);
+size_t formatEpochTime(uint32_t epoch, char* buffer, size_t size);
+uint32_t getEpochTime();
 void printCurrentTime();
 
 #endif
\ No newline at end of file
@@ -0,0 +1,159 @@
+// Generated by Tools/asset_embed from web/portal.html - do not edit, run `make portal` in Tools/
+// 7942 bytes, 2308 gzipped
+#ifndef LEAFYSENSE_PORTAL_HTML_H
+#define LEAFYSENSE_PORTAL_HTML_H
+
+#include <Arduino.h>
+
+#define PORTAL_HTML_ETAG "\"f499bdcf\""
+#define PORTAL_HTML_GZ_LENGTH 2308
+
+const uint8_t PORTAL_HTML_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x59, 0xdd, 0x6e, 0x1b, 0xc7,
+  0x15, 0xbe, 0xcf, 0x53, 0x9c, 0xd2, 0x48, 0x49, 0x22, 0xd4, 0x52, 0x92, 0xa3, 0xd4, 0x11, 0x49,
+  0x15, 0x32, 0x65, 0xc5, 0x02, 0x24, 0x5b, 0x31, 0x15, 0x04, 0x45, 0x11, 0x08, 0xc3, 0xdd, 0x59,
+  0x72, 0xa2, 0xfd, 0xf3, 0xec, 0x2c, 0x25, 0x36, 0xf0, 0x65, 0x6f, 0x8a, 0xdc, 0xf5, 0x36, 0x41,
+  0x5f, 0xa1, 0xbd, 0xe8, 0x0b, 0xe4, 0x51, 0xfa, 0x04, 0x7d, 0x84, 0x9e, 0x33, 0xb3, 0xff, 0x5c,
+  0x52, 0x2b, 0xa1, 0x96, 0x6d, 0x71, 0x66, 0xce, 0xf9, 0xce, 0xef, 0x9c, 0x39, 0x33, 0x1c, 0xff,
+  0xee, 0xec, 0xfd, 0xf4, 0xe6, 0x4f, 0xd7, 0x6f, 0x60, 0xa9, 0x7c, 0xef, 0xe4, 0xb3, 0x71, 0xf6,
+  0x8b, 0x33, 0xe7, 0xe4, 0x33, 0xc0, 0x3f, 0x63, 0x25, 0x94, 0xc7, 0x4f, 0x66, 0x3e, 0x93, 0x0a,
+  0xbe, 0x61, 0xd2, 0xe1, 0x01, 0xcc, 0xb8, 0x4a, 0xa2, 0xf1, 0xd0, 0xac, 0x18, 0x2a, 0x9f, 0x2b,
+  0x06, 0x01, 0xf3, 0xf9, 0xa4, 0xb3, 0x12, 0xfc, 0x3e, 0x0a, 0xa5, 0xea, 0x80, 0x1d, 0x06, 0x8a,
+  0x07, 0x6a, 0xd2, 0xb9, 0x17, 0x8e, 0x5a, 0x4e, 0x1c, 0xbe, 0x12, 0x36, 0xdf, 0xd3, 0x83, 0x01,
+  0x88, 0x40, 0x28, 0xc1, 0xbc, 0xbd, 0xd8, 0x66, 0x1e, 0x9f, 0x1c, 0x74, 0x52, 0xa0, 0x58, 0xad,
+  0x33, 0x50, 0xfa, 0x33, 0x0f, 0x9d, 0x35, 0xfc, 0x04, 0x2e, 0x22, 0xed, 0xb9, 0xcc, 0x17, 0xde,
+  0xfa, 0x18, 0x4e, 0x25, 0xf2, 0x8d, 0x00, 0x35, 0x5a, 0x88, 0xe0, 0x18, 0xbe, 0xdc, 0x8f, 0x1e,
+  0x46, 0x30, 0x67, 0xf6, 0xdd, 0x42, 0x86, 0x49, 0xe0, 0x1c, 0xc3, 0x0b, 0x77, 0x9f, 0x7e, 0x46,
+  0xf0, 0x29, 0xc7, 0xb1, 0x48, 0x17, 0x26, 0x02, 0x2e, 0x11, 0xad, 0x4c, 0x7b, 0xbf, 0x14, 0x8a,
+  0x8f, 0x20, 0x62, 0x8e, 0x23, 0x82, 0xc5, 0x31, 0x1c, 0x1a, 0xb4, 0x10, 0x0d, 0x95, 0x7b, 0x92,
+  0x39, 0x22, 0x89, 0x8f, 0xe1, 0x40, 0x4f, 0x16, 0x68, 0x22, 0x88, 0x12, 0x85, 0x40, 0xda, 0x14,
+  0x5a, 0xde, 0xff, 0xbc, 0x04, 0x61, 0xa8, 0x33, 0xf5, 0x8e, 0xa2, 0x07, 0xd8, 0x27, 0xc4, 0x87,
+  0xbd, 0x58, 0xfc, 0x45, 0x13, 0xa4, 0xe8, 0x38, 0x55, 0x06, 0x9d, 0x27, 0x4a, 0x85, 0x41, 0x4d,
+  0xbd, 0x17, 0x5f, 0x4e, 0x4f, 0xcf, 0x8f, 0x90, 0xdf, 0x0e, 0xbd, 0x50, 0x6e, 0xaa, 0x7b, 0x50,
+  0x52, 0xf7, 0x18, 0x82, 0x30, 0xc0, 0xc5, 0x8a, 0x56, 0x99, 0x1a, 0x44, 0x08, 0x55, 0x97, 0x88,
+  0xc0, 0x0d, 0xeb, 0xe2, 0xf8, 0x57, 0xee, 0x1f, 0x5c, 0x77, 0x8b, 0x80, 0xdc, 0x1f, 0x47, 0x65,
+  0x03, 0x1b, 0x90, 0x63, 0x1e, 0xc4, 0xa1, 0xdc, 0x73, 0x18, 0x26, 0x45, 0x4d, 0x80, 0xfb, 0x35,
+  0xfd, 0x94, 0x05, 0x1c, 0xb5, 0x15, 0x90, 0x59, 0x79, 0x80, 0xc3, 0x38, 0xf4, 0x84, 0x03, 0x2f,
+  0x1c, 0xc7, 0x29, 0x0b, 0x56, 0x6c, 0xee, 0xf1, 0x7a, 0x5c, 0x52, 0x68, 0x74, 0xa0, 0xc7, 0xa2,
+  0x98, 0x1f, 0x43, 0xf6, 0xa9, 0xc2, 0xe9, 0x20, 0x5b, 0xae, 0xd3, 0xab, 0x92, 0x4a, 0xf3, 0x10,
+  0xc3, 0xe2, 0x57, 0xa4, 0x72, 0xce, 0xab, 0xe6, 0x2a, 0xa6, 0x92, 0x78, 0x2f, 0x0c, 0x3c, 0x4c,
+  0x30, 0xc4, 0x49, 0x63, 0xb5, 0x90, 0x9c, 0x07, 0x23, 0x93, 0xbb, 0xf7, 0x5c, 0x2c, 0x96, 0x8a,
+  0x42, 0xef, 0x39, 0x8d, 0xbc, 0xae, 0x5b, 0x65, 0x96, 0xdc, 0xd9, 0xc1, 0x3a, 0x1e, 0xa6, 0xfb,
+  0x64, 0x3c, 0x34, 0x5b, 0x75, 0x4c, 0x1b, 0x25, 0xdd, 0x42, 0x8e, 0x58, 0x81, 0xed, 0xb1, 0x38,
+  0x9e, 0x74, 0xf2, 0xac, 0xef, 0x14, 0x5b, 0x6a, 0xbc, 0x3c, 0x3c, 0xf9, 0xef, 0x3f, 0x7e, 0xfe,
+  0x17, 0x34, 0xed, 0x69, 0x5c, 0xcb, 0x09, 0x0b, 0x8e, 0x12, 0x62, 0x29, 0xb4, 0x25, 0x4c, 0x83,
+  0xfb, 0x12, 0x71, 0xff, 0xfe, 0x37, 0xb8, 0x14, 0x2b, 0x8e, 0x78, 0x44, 0x07, 0x67, 0x48, 0x87,
+  0xa8, 0x2f, 0x6b, 0xa4, 0x04, 0x28, 0x9c, 0x0c, 0xed, 0x4c, 0x83, 0x5d, 0x86, 0x8c, 0xbc, 0x0f,
+  0x66, 0x0e, 0x48, 0x82, 0x65, 0x59, 0xe3, 0x21, 0xd2, 0x96, 0x94, 0xaf, 0x0e, 0x8b, 0x79, 0x37,
+  0x94, 0xbe, 0x86, 0x44, 0x93, 0x5d, 0xb1, 0xe8, 0x00, 0xb3, 0x95, 0x08, 0x83, 0x49, 0x67, 0x18,
+  0xb3, 0x15, 0xef, 0x00, 0x16, 0xa8, 0x65, 0x88, 0xcb, 0xd7, 0xef, 0x67, 0x37, 0x0d, 0x8a, 0x7f,
+  0x2f, 0xce, 0x05, 0x4c, 0x35, 0x6b, 0x22, 0x19, 0x71, 0x36, 0x68, 0x6d, 0xb6, 0xbd, 0x5a, 0x47,
+  0x58, 0xe5, 0x14, 0x7f, 0xc0, 0x0a, 0x67, 0x2a, 0x5e, 0x1c, 0x0b, 0xa7, 0x03, 0x91, 0xc7, 0x6c,
+  0xbe, 0xc4, 0x20, 0x71, 0x39, 0xe9, 0x68, 0xbc, 0xd9, 0xec, 0xe2, 0xac, 0x83, 0x91, 0xfc, 0x98,
+  0x08, 0x0c, 0xe7, 0x0e, 0xb0, 0x08, 0x5d, 0x7b, 0x8f, 0xe9, 0x96, 0x01, 0x16, 0xe3, 0x4d, 0xd0,
+  0xeb, 0x7c, 0xad, 0x19, 0x78, 0xc3, 0xb4, 0x19, 0x66, 0x98, 0xb0, 0xe1, 0xe2, 0x1a, 0x7a, 0xef,
+  0x23, 0xb2, 0x8c, 0x79, 0xfd, 0xa7, 0x18, 0xa7, 0xd9, 0x2f, 0xae, 0x6b, 0xba, 0x20, 0xdc, 0xa9,
+  0xe3, 0x48, 0x1e, 0xc7, 0xd0, 0xe3, 0x7e, 0xa4, 0xd6, 0x30, 0x81, 0xb3, 0xb7, 0xd3, 0xeb, 0x7e,
+  0xa7, 0x25, 0xee, 0x82, 0x29, 0x7e, 0xcf, 0xd6, 0x35, 0xd8, 0x6f, 0xd2, 0xd9, 0xb6, 0xca, 0x25,
+  0xf3, 0x80, 0xab, 0x1a, 0xc6, 0x4c, 0x4f, 0xc2, 0x15, 0x8b, 0xef, 0xa0, 0xe7, 0x70, 0x97, 0x25,
+  0x1e, 0x6e, 0x9f, 0xc3, 0xa3, 0x23, 0x2b, 0xfb, 0xb7, 0xdf, 0x5a, 0x4b, 0x27, 0x88, 0x6b, 0xe8,
+  0x67, 0xef, 0x66, 0x98, 0xdc, 0x72, 0x85, 0x27, 0x49, 0x01, 0x9e, 0x1a, 0x53, 0x87, 0xdd, 0x88,
+  0xc5, 0x99, 0x3e, 0x02, 0xe1, 0x1d, 0x62, 0x3f, 0x21, 0x04, 0xe6, 0xe0, 0x24, 0xa6, 0xba, 0x2e,
+  0x05, 0xdc, 0x63, 0x92, 0xaf, 0xbe, 0xbd, 0xb9, 0xa9, 0x26, 0xf8, 0xf3, 0xd2, 0xc1, 0xff, 0xa8,
+  0x94, 0x31, 0xbf, 0xa6, 0x8b, 0x16, 0x90, 0x39, 0x86, 0x5b, 0x0b, 0x6b, 0x00, 0x07, 0x5f, 0x1f,
+  0x5a, 0x07, 0x5f, 0xbd, 0xb2, 0x0e, 0x2c, 0xac, 0xc4, 0x3b, 0x5d, 0x1e, 0x24, 0xfe, 0x9c, 0x10,
+  0x0b, 0x19, 0xd7, 0xba, 0x83, 0xd8, 0x94, 0x40, 0xf3, 0x25, 0xc7, 0x1f, 0xbc, 0x7a, 0xf5, 0xb2,
+  0x75, 0x30, 0x09, 0xf7, 0xbb, 0xb8, 0x59, 0x73, 0x9a, 0x27, 0x2a, 0xe8, 0x85, 0x99, 0x57, 0x3a,
+  0x4f, 0xd8, 0xb1, 0x5a, 0xe5, 0xe6, 0x5d, 0x6b, 0xd4, 0x4e, 0xd7, 0x5a, 0xc2, 0xd7, 0xb5, 0xbe,
+  0x09, 0x23, 0x61, 0x37, 0xe1, 0xea, 0x05, 0xb8, 0x96, 0xdc, 0x15, 0x0f, 0x3b, 0x53, 0x20, 0xed,
+  0x2e, 0x0c, 0x3c, 0x6e, 0x1b, 0x5f, 0xa8, 0xce, 0xc9, 0x0c, 0x4b, 0x23, 0xfc, 0x9e, 0xd2, 0x22,
+  0xe0, 0xb6, 0x1a, 0x0f, 0x0d, 0x51, 0xb9, 0xda, 0x52, 0x59, 0x7d, 0xe4, 0x44, 0xa0, 0x36, 0xa2,
+  0x6e, 0x4b, 0xac, 0x64, 0x18, 0x2c, 0xb2, 0x74, 0xbf, 0x38, 0x3b, 0xa6, 0x03, 0x4b, 0x4f, 0xe1,
+  0x5a, 0xc4, 0x02, 0x5d, 0xa9, 0x4d, 0x5a, 0x5f, 0x38, 0x9d, 0x13, 0x5c, 0xc5, 0xc9, 0x93, 0xf1,
+  0x5c, 0x36, 0xe3, 0x5c, 0x9d, 0x4e, 0xb3, 0x6a, 0xd3, 0x88, 0xe4, 0x33, 0x3b, 0x5d, 0xce, 0xb1,
+  0x9a, 0x4e, 0x8c, 0xd2, 0xc7, 0xb4, 0xd9, 0xb4, 0xa5, 0x88, 0x54, 0x41, 0x3b, 0x1c, 0xc2, 0x07,
+  0x1e, 0xa0, 0x77, 0x63, 0x18, 0xb2, 0x48, 0x0c, 0x57, 0x07, 0x43, 0x73, 0x1a, 0xc5, 0xc0, 0xf0,
+  0xaf, 0xe9, 0x2f, 0x46, 0xb0, 0x62, 0x5e, 0xc2, 0x71, 0x2c, 0x39, 0x1e, 0x56, 0x8a, 0x96, 0x28,
+  0x5e, 0x03, 0x08, 0x38, 0x25, 0x3f, 0x0e, 0xdf, 0xde, 0x5c, 0x5d, 0xe6, 0xa0, 0x6e, 0x12, 0xe8,
+  0xa3, 0x08, 0xb0, 0xbb, 0xf8, 0x10, 0xde, 0xf7, 0x34, 0xc8, 0x00, 0x3c, 0x36, 0xe7, 0xde, 0xc0,
+  0x60, 0x0d, 0xc0, 0xb4, 0x01, 0x7d, 0xf8, 0xa9, 0x62, 0x3f, 0x9e, 0x65, 0xb1, 0x02, 0x19, 0xde,
+  0x63, 0x71, 0xd5, 0x6c, 0xd8, 0xb3, 0x61, 0x9e, 0x2a, 0x82, 0xe9, 0x8f, 0x1a, 0x48, 0x75, 0x06,
+  0x4f, 0xc0, 0x09, 0xed, 0xc4, 0xc7, 0xce, 0xdb, 0xb2, 0x25, 0xc7, 0xca, 0xf4, 0xc6, 0xe3, 0x34,
+  0xea, 0x75, 0x8d, 0xe7, 0xba, 0x35, 0x56, 0x62, 0xb2, 0xc8, 0x82, 0xa9, 0xe9, 0xd7, 0x11, 0x40,
+  0x2b, 0x07, 0x5f, 0x40, 0xf7, 0xb8, 0x5b, 0xa5, 0x45, 0x5d, 0x52, 0x1d, 0xa6, 0xdc, 0xf3, 0x7a,
+  0x7d, 0x8b, 0x45, 0x11, 0x7a, 0x6c, 0xba, 0x14, 0x9e, 0xd3, 0x23, 0xa0, 0x46, 0xb5, 0x6c, 0xa4,
+  0x45, 0xd4, 0x3a, 0x73, 0x8d, 0x14, 0xe7, 0x6a, 0x6a, 0x68, 0xe7, 0x54, 0xa9, 0x84, 0x0b, 0xbd,
+  0xcc, 0x59, 0x9a, 0x43, 0x67, 0xe1, 0x3b, 0x63, 0xb7, 0x59, 0x28, 0x18, 0x3e, 0x6d, 0x66, 0x6e,
+  0x1e, 0x0d, 0xa9, 0x03, 0x3d, 0xcb, 0x1b, 0x90, 0x1e, 0x35, 0x1c, 0xcd, 0x01, 0x30, 0x6d, 0xe5,
+  0x76, 0xb7, 0xea, 0xf5, 0x6e, 0xa3, 0xe5, 0x59, 0x5f, 0x37, 0x81, 0x6e, 0xb5, 0xd3, 0xab, 0xf9,
+  0xb5, 0x9a, 0x1b, 0xdd, 0x1b, 0xe1, 0xf3, 0xee, 0xc0, 0xf4, 0x40, 0x4a, 0x6c, 0x78, 0x75, 0xc3,
+  0x23, 0x9a, 0x90, 0x09, 0x69, 0x85, 0x77, 0x75, 0x13, 0x1a, 0xd0, 0x4f, 0x85, 0x84, 0x1b, 0x3c,
+  0xb4, 0x39, 0x1e, 0x04, 0x89, 0xcc, 0x05, 0x11, 0xbf, 0x2a, 0xa6, 0x2d, 0x15, 0x9e, 0x8b, 0x07,
+  0xee, 0xf4, 0x0e, 0xfa, 0x94, 0x09, 0xf0, 0xdb, 0x3f, 0xa7, 0x75, 0x1b, 0xb7, 0x60, 0xbf, 0x4d,
+  0x7c, 0xe1, 0x08, 0xb5, 0x2e, 0x03, 0x2f, 0xd3, 0xb9, 0x3a, 0xea, 0xe7, 0x2d, 0x31, 0x4d, 0xa0,
+  0x10, 0xb1, 0xfb, 0x9f, 0x5f, 0xfe, 0x0a, 0xdf, 0x87, 0xf2, 0x0e, 0x7b, 0x45, 0x1a, 0x56, 0x9a,
+  0xef, 0x3a, 0xd8, 0x27, 0xe0, 0x5e, 0xcc, 0xdb, 0x79, 0xa4, 0x24, 0xe1, 0xd7, 0x9f, 0x51, 0xb3,
+  0x2f, 0x0a, 0xe5, 0xb9, 0x94, 0xa1, 0x1c, 0x64, 0xc1, 0xac, 0xcb, 0x68, 0x11, 0x9a, 0x38, 0x14,
+  0x5e, 0xbb, 0xd8, 0xcc, 0x90, 0xf2, 0x99, 0xc6, 0xea, 0xf4, 0xc6, 0xce, 0xb9, 0x67, 0x52, 0x2f,
+  0x92, 0xe1, 0x9c, 0xa3, 0xce, 0x50, 0x68, 0xa0, 0xa7, 0xe2, 0x26, 0x2d, 0x32, 0x6d, 0x35, 0xc5,
+  0x16, 0x4d, 0x77, 0x69, 0x4c, 0xee, 0x32, 0xbc, 0x46, 0x2c, 0x85, 0xf6, 0x2a, 0x14, 0x71, 0x9a,
+  0x5f, 0x66, 0xc9, 0x4f, 0x27, 0x5a, 0xe5, 0xc0, 0x53, 0xa5, 0x55, 0x13, 0xda, 0xac, 0x3e, 0x3d,
+  0x9b, 0x77, 0x26, 0xcd, 0xe3, 0x21, 0xab, 0x6b, 0x56, 0x4a, 0x26, 0x33, 0xbb, 0x33, 0x93, 0x9a,
+  0x33, 0x6a, 0x73, 0xa6, 0x6d, 0x56, 0xd7, 0x73, 0xa9, 0x9c, 0xd6, 0x3a, 0x1f, 0x9e, 0x9b, 0xd7,
+  0x35, 0x39, 0xfa, 0x5e, 0xf2, 0x01, 0x6f, 0x3b, 0xd9, 0x86, 0xbf, 0x17, 0xae, 0xb0, 0x24, 0x5e,
+  0x8b, 0xb4, 0xab, 0x9d, 0xd7, 0x7e, 0xdd, 0xd5, 0xf9, 0xc6, 0xd0, 0x94, 0xb6, 0xe9, 0x3f, 0xb8,
+  0xd3, 0x62, 0x7f, 0x14, 0xf7, 0x8e, 0x8a, 0x30, 0x11, 0x3d, 0x73, 0xe7, 0xbf, 0xe3, 0x0a, 0xfb,
+  0xb2, 0x3b, 0xf2, 0xcf, 0x94, 0x61, 0x6b, 0x86, 0x0d, 0x11, 0xb5, 0x98, 0xcc, 0xc3, 0xf4, 0x75,
+  0x28, 0x93, 0x9e, 0xec, 0x9c, 0xd2, 0x16, 0xc4, 0x0e, 0x27, 0xdf, 0x80, 0xe2, 0xd0, 0x6e, 0x63,
+  0xde, 0xe1, 0xd4, 0xc4, 0x88, 0xaf, 0x2c, 0x66, 0xec, 0x1c, 0xe8, 0x81, 0x0e, 0x55, 0xac, 0xfd,
+  0x99, 0x7e, 0x1c, 0xe6, 0x84, 0x4a, 0xb2, 0x20, 0x36, 0xf7, 0x5d, 0x43, 0xa1, 0x1e, 0x06, 0xc0,
+  0x56, 0x8b, 0x02, 0x69, 0xb5, 0xb8, 0x4d, 0xcc, 0xd2, 0x6f, 0xff, 0x8e, 0xbb, 0xed, 0x6d, 0x31,
+  0x66, 0x50, 0x07, 0x4a, 0xc7, 0x1f, 0x99, 0x41, 0x9f, 0x77, 0x1e, 0x5d, 0xba, 0x2d, 0xfd, 0x36,
+  0xe1, 0x09, 0x39, 0x8f, 0xa8, 0xad, 0x8f, 0x34, 0x70, 0x48, 0xfa, 0x90, 0x14, 0xd2, 0x73, 0x36,
+  0x8b, 0x98, 0x8d, 0xc7, 0x81, 0xd6, 0xc9, 0x10, 0x0c, 0x20, 0x5f, 0x75, 0x64, 0x88, 0x6d, 0x85,
+  0x63, 0xb2, 0xc7, 0x7c, 0x2e, 0xad, 0x4a, 0xae, 0x0d, 0xc6, 0x0e, 0xd6, 0x98, 0x54, 0x1a, 0xd7,
+  0x4d, 0x6b, 0xd2, 0xed, 0xd4, 0xbe, 0x83, 0x4b, 0x3c, 0xbe, 0x03, 0x7b, 0x9d, 0x69, 0xc8, 0xec,
+  0xbb, 0x5b, 0xf2, 0x91, 0x6f, 0x00, 0xf1, 0x17, 0x8e, 0x4a, 0x12, 0x69, 0xdd, 0x67, 0x0f, 0xa5,
+  0x75, 0x1c, 0x3d, 0x22, 0xcb, 0x6c, 0x0a, 0x9e, 0xe6, 0x76, 0x35, 0x5b, 0xb3, 0x49, 0x8d, 0x96,
+  0x0d, 0x06, 0xc5, 0xe6, 0xd4, 0x44, 0x64, 0x78, 0x9c, 0xbb, 0x20, 0xa6, 0x8e, 0x91, 0x1a, 0x8a,
+  0x44, 0xb1, 0x05, 0x27, 0xd2, 0xa6, 0xd2, 0x51, 0x70, 0x13, 0xf1, 0xad, 0x21, 0x2e, 0xd4, 0x1e,
+  0x90, 0xde, 0x35, 0x31, 0x64, 0x57, 0x9d, 0xae, 0x8d, 0x69, 0xd4, 0xa2, 0x80, 0x0a, 0xe1, 0xe2,
+  0xba, 0x62, 0x1a, 0x75, 0x2b, 0xb7, 0x2a, 0xbc, 0x15, 0x51, 0x6b, 0x38, 0x1d, 0x95, 0x8a, 0xa7,
+  0x4c, 0x8a, 0x6c, 0x77, 0x92, 0x5e, 0x77, 0x99, 0xf0, 0xb0, 0xb0, 0xc7, 0xd5, 0xc4, 0x62, 0x8a,
+  0x8a, 0x7e, 0xca, 0x95, 0x0f, 0x88, 0x96, 0x72, 0x48, 0xbb, 0x70, 0x8b, 0xef, 0x34, 0xbb, 0x76,
+  0x9b, 0xcc, 0x74, 0x69, 0xf2, 0x9c, 0x26, 0x23, 0xa7, 0x35, 0x50, 0x75, 0x77, 0xf5, 0x69, 0xe9,
+  0x5e, 0xe2, 0x7e, 0xbe, 0x95, 0xb8, 0x1f, 0xca, 0x75, 0x53, 0xd7, 0xb8, 0xe4, 0x2c, 0x9a, 0xe9,
+  0xa3, 0x1e, 0x69, 0x91, 0xcc, 0xf2, 0xf0, 0x0a, 0xf0, 0xc7, 0xbc, 0x99, 0x3c, 0x86, 0xee, 0xee,
+  0xf6, 0xf1, 0x5c, 0x72, 0x0e, 0x57, 0x1a, 0x9e, 0xbc, 0x89, 0x00, 0x2e, 0xce, 0xdc, 0x12, 0xac,
+  0xd6, 0x74, 0xbe, 0x56, 0xe8, 0xb7, 0x9e, 0x2f, 0x02, 0x63, 0x12, 0x12, 0xe0, 0xe7, 0xdb, 0x0a,
+  0x51, 0x1f, 0x39, 0x0b, 0x3d, 0x76, 0x47, 0xf0, 0x92, 0xc9, 0x05, 0x47, 0xbd, 0x5f, 0x7b, 0xa1,
+  0x7d, 0x97, 0x4a, 0xf4, 0xcc, 0xdc, 0xed, 0x9c, 0xe6, 0x76, 0x49, 0xdd, 0x20, 0xdc, 0x29, 0x99,
+  0x4e, 0x0e, 0xe2, 0x64, 0x1e, 0x92, 0xdf, 0xe6, 0x39, 0x70, 0x02, 0xfb, 0x2d, 0xaa, 0xeb, 0xb9,
+  0x4e, 0x03, 0x38, 0x25, 0x5e, 0xfd, 0x06, 0x12, 0xa7, 0xca, 0x56, 0xd1, 0xda, 0x15, 0xfd, 0x52,
+  0x9d, 0x57, 0xf4, 0xd4, 0x94, 0x77, 0x5a, 0x0a, 0xcb, 0x45, 0xdc, 0xa6, 0xd5, 0x23, 0x42, 0xed,
+  0x0a, 0xe2, 0xb7, 0xe8, 0xbf, 0x81, 0xf9, 0x48, 0x81, 0x28, 0xb9, 0x8c, 0x86, 0xdd, 0x74, 0x69,
+  0x33, 0x13, 0xda, 0x57, 0xf3, 0xfc, 0xfe, 0xb2, 0xe0, 0x2a, 0xbd, 0xbc, 0xbc, 0x5e, 0x5f, 0x38,
+  0x78, 0x2f, 0xcc, 0x6f, 0x41, 0xdd, 0x3e, 0x96, 0x57, 0xfd, 0xcc, 0xa0, 0xaf, 0x74, 0x78, 0x49,
+  0x32, 0xea, 0xf6, 0xdb, 0x5d, 0xaa, 0x92, 0x08, 0x5d, 0xc0, 0x4b, 0x97, 0xaa, 0xba, 0x1b, 0x5c,
+  0xae, 0xec, 0x65, 0xaf, 0x5b, 0xbb, 0x5d, 0x77, 0xfb, 0x1b, 0xbe, 0xb2, 0xd4, 0x12, 0x65, 0x63,
+  0x30, 0x22, 0xf4, 0x30, 0xde, 0x9f, 0x4e, 0x20, 0xfb, 0x6c, 0xfd, 0x18, 0x87, 0x41, 0xaf, 0xbf,
+  0x9d, 0xa5, 0x7a, 0xaf, 0x6b, 0xa0, 0xc3, 0xd8, 0xa3, 0x12, 0xfa, 0x18, 0x25, 0xe0, 0xe6, 0x46,
+  0xaf, 0x9d, 0xb3, 0xaa, 0xf7, 0xd5, 0xee, 0x1b, 0x8d, 0xe9, 0x6d, 0xbe, 0x64, 0x77, 0x37, 0x3b,
+  0xbd, 0x4f, 0xbb, 0x7d, 0x3a, 0x1c, 0x02, 0x3d, 0xcf, 0x38, 0xf4, 0xc4, 0xa0, 0x10, 0x2d, 0xc6,
+  0xda, 0x80, 0x15, 0xd7, 0x95, 0xa1, 0x9f, 0x3f, 0x4e, 0x98, 0xb7, 0xee, 0x11, 0xa0, 0xe1, 0x10,
+  0xd1, 0xb1, 0x80, 0x47, 0x20, 0xf7, 0x5c, 0x10, 0x31, 0x98, 0x67, 0xdb, 0xcd, 0x08, 0x91, 0x6e,
+  0xe6, 0x19, 0xf0, 0xb1, 0xd8, 0x18, 0xf0, 0xff, 0x67, 0x68, 0x0c, 0xe2, 0x76, 0x97, 0x9b, 0xcd,
+  0xa4, 0x5f, 0xf2, 0x27, 0xdb, 0xfd, 0x9f, 0xe9, 0xd5, 0xdc, 0x3b, 0x97, 0x76, 0xe5, 0x9f, 0xe9,
+  0x3d, 0x22, 0x7d, 0x61, 0xf9, 0x81, 0xb6, 0xe7, 0xfb, 0xf9, 0x8f, 0x58, 0xae, 0x2d, 0x44, 0x92,
+  0x82, 0xc7, 0xa9, 0x3a, 0xfd, 0x5d, 0x57, 0x1d, 0xaa, 0x36, 0xa4, 0x8f, 0xc5, 0x8d, 0x06, 0xb1,
+  0xc6, 0xfc, 0xa1, 0x0f, 0x0d, 0x93, 0x96, 0x16, 0xd4, 0xfc, 0x6a, 0xb1, 0xbd, 0xb3, 0xdf, 0x99,
+  0x6a, 0xd9, 0x0b, 0xd9, 0x46, 0xa2, 0x19, 0xd5, 0xad, 0x6c, 0x7d, 0xf4, 0x34, 0xd8, 0xe2, 0xb9,
+  0x6c, 0x1b, 0x70, 0x41, 0xf1, 0x9c, 0xbc, 0xfd, 0x4e, 0x57, 0x81, 0x72, 0xfa, 0x03, 0xbd, 0x8c,
+  0xad, 0xe1, 0x08, 0xe7, 0x50, 0x82, 0x13, 0xe7, 0xd4, 0x98, 0xdc, 0x17, 0x28, 0x5b, 0xa2, 0xcf,
+  0x7a, 0xf5, 0xe2, 0x31, 0x80, 0xa3, 0xfd, 0xfd, 0xfd, 0x92, 0xb4, 0xcd, 0xea, 0x32, 0x22, 0x71,
+  0x17, 0xe6, 0x9b, 0x64, 0x9d, 0xda, 0x39, 0x6d, 0x39, 0xcf, 0x47, 0xd9, 0x77, 0x66, 0xe9, 0x73,
+  0xdf, 0x78, 0x68, 0xbe, 0x2d, 0x1b, 0x0f, 0xcd, 0xd7, 0xdd, 0xff, 0x03, 0x68, 0xc3, 0x25, 0x33,
+  0x06, 0x1f, 0x00, 0x00,
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "report_policy.h"
+#include <Arduino.h>
+#include <math.h>
+
+ReportPolicy reportPolicies[METRIC_KIND_COUNT] = {
+  {AIR_TEMP_DEADBAND, REPORT_RELATIVE_DEADBAND, REPORT_HEARTBEAT_INTERVAL},
+  {AIR_HUMIDITY_DEADBAND, REPORT_RELATIVE_DEADBAND, REPORT_HEARTBEAT_INTERVAL},
+  {SOIL_MOISTURE_DEADBAND, REPORT_RELATIVE_DEADBAND, REPORT_HEARTBEAT_INTERVAL},
+  {SOIL_TEMP_DEADBAND, REPORT_RELATIVE_DEADBAND, REPORT_HEARTBEAT_INTERVAL},
+};
+
+// Last value that actually went out for each metric
+struct MetricState {
+  float last_reported;
+  unsigned long last_report_ms;
+  bool reported;
+};
+
+static MetricState metricStates[REPORT_METRIC_COUNT];
+static uint32_t lastEvaluatedVersion = 0;
+static unsigned long lastIntervalPublish = 0;
+#if REPORT_MODE == REPORT_MODE_DEADBAND
+static unsigned long reportInterval = REPORT_HEARTBEAT_INTERVAL;  // Changed at runtime by the "publish" command
+#else
+static unsigned long reportInterval = MQTT_PUBLISH_INTERVAL;
+#endif
+static bool fullReportPending = false;
+static uint32_t metricsPublished = 0;
+static uint32_t metricsSuppressed = 0;
+
+static ReportMetricKind kindOf(uint8_t metric) {
+  if (metric == REPORT_METRIC_AIR_TEMP) return METRIC_AIR_TEMP;
+  if (metric == REPORT_METRIC_AIR_HUMIDITY) return METRIC_AIR_HUMIDITY;
+  return (metric % 2 == 0) ? METRIC_SOIL_MOISTURE : METRIC_SOIL_TEMP;
+}
+
+// Current value of a metric, or false if its sensor has nothing valid
+static bool metricValue(const SensorSnapshot& snapshot, uint8_t metric, float& value) {
+  if (metric == REPORT_METRIC_AIR_TEMP || metric == REPORT_METRIC_AIR_HUMIDITY) {
+    if (!isAirSampleValid(snapshot.air)) return false;
+    value = (metric == REPORT_METRIC_AIR_TEMP) ? snapshot.air.temperature : snapshot.air.humidity;
+    return true;
+  }
+  
+  uint8_t probe = (metric - 2) / 2;
+  if (!isSoilProbeValid(snapshot.soil, probe)) return false;
+  value = (kindOf(metric) == METRIC_SOIL_MOISTURE) ? snapshot.soil.probes[probe].moisture_percentage
+                                                   : snapshot.soil.probes[probe].temperature_celsius;
+  return true;
+}
+
+static bool crossesDeadband(const ReportPolicy& policy, const MetricState& state, float value, unsigned long now) {
+  if (!state.reported) return true;
+  if (now - state.last_report_ms >= policy.heartbeat_ms) return true;
+  
+  float delta = fabsf(value - state.last_reported);
+  if (policy.abs_deadband > 0 && delta >= policy.abs_deadband) return true;
+  if (policy.rel_deadband > 0 && delta >= policy.rel_deadband * fabsf(state.last_reported)) return true;
+  return false;
+}
+
+// Decide what to publish. In interval mode everything is due every
+// report interval (MQTT_PUBLISH_INTERVAL unless changed at runtime). In deadband mode each new snapshot is checked as
+// soon as it lands, so a real change goes out within one sensor interval.
+// Taking a decision consumes the snapshot and any pending full report, so
+// call it only when the publish is about to be attempted.
+bool takeReportDecision(const SensorSnapshot& snapshot, ReportDecision& decision) {
+  decision.any = false;
+  for (uint8_t m = 0; m < REPORT_METRIC_COUNT; m++) {
+    decision.due[m] = false;
+  }
+  
+  unsigned long now = millis();
+  
+  // A burst or on-demand sample goes out complete, whatever the mode
+  if (fullReportPending) {
+    fullReportPending = false;
+    lastIntervalPublish = now;
+    lastEvaluatedVersion = snapshot.version;
+    for (uint8_t m = 0; m < REPORT_METRIC_COUNT; m++) {
+      decision.due[m] = true;
+    }
+    decision.any = true;
+    return true;
+  }
+  
+#if REPORT_MODE == REPORT_MODE_INTERVAL
+  if (now - lastIntervalPublish < reportInterval) {
+    return false;
+  }
+  lastIntervalPublish = now;
+  for (uint8_t m = 0; m < REPORT_METRIC_COUNT; m++) {
+    decision.due[m] = true;
+  }
+  decision.any = true;
+  return true;
+#else
+  if (snapshot.version == lastEvaluatedVersion) {
+    return false;
+  }
+  lastEvaluatedVersion = snapshot.version;
+  
+  for (uint8_t m = 0; m < REPORT_METRIC_COUNT; m++) {
+    float value;
+    if (!metricValue(snapshot, m, value)) continue;
+    
+    if (crossesDeadband(reportPolicies[kindOf(m)], metricStates[m], value, now)) {
+      decision.due[m] = true;
+      decision.any = true;
+    } else {
+      metricsSuppressed++;
+    }
+  }
+  return decision.any;
+#endif
+}
+
+// Record what went out; called only after the broker accepted the publish
+void markMetricsReported(const ReportDecision& decision, const SensorSnapshot& snapshot) {
+  unsigned long now = millis();
+  for (uint8_t m = 0; m < REPORT_METRIC_COUNT; m++) {
+    float value;
+    if (!decision.due[m] || !metricValue(snapshot, m, value)) continue;
+    
+    metricStates[m].last_reported = value;
+    metricStates[m].last_report_ms = now;
+    metricStates[m].reported = true;
+    metricsPublished++;
+  }
+}
+
+// Makes every metric due on the next decision
+void requestFullReport() {
+  fullReportPending = true;
+}
+
+// Interval mode: the publish period. Deadband mode: the heartbeat that
+// republishes unchanged metrics.
+void setReportInterval(unsigned long intervalMs) {
+  reportInterval = intervalMs;
+#if REPORT_MODE == REPORT_MODE_DEADBAND
+  for (uint8_t k = 0; k < METRIC_KIND_COUNT; k++) {
+    reportPolicies[k].heartbeat_ms = intervalMs;
+  }
+#endif
+}
+
+unsigned long getReportInterval() {
+  return reportInterval;
+}
+
+void printReportStats() {
+  uint32_t total = metricsPublished + metricsSuppressed;
+  Serial.println("📉 Reporting: " + String(metricsPublished) + " metrics published, " +
+                 String(metricsSuppressed) + " suppressed by deadband" +
+                 (total ? " (" + String(metricsSuppressed * 100 / total) + "% saved)" : ""));
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+// report_policy.h
+#ifndef REPORT_POLICY_H
+#define REPORT_POLICY_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "sensor_manager.h"
+
+// Reported metrics: air temperature, air humidity, then a moisture and a
+// temperature metric for every soil probe
+#define REPORT_METRIC_AIR_TEMP 0
+#define REPORT_METRIC_AIR_HUMIDITY 1
+#define REPORT_METRIC_SOIL_MOISTURE(p) (2 + (p) * 2)
+#define REPORT_METRIC_SOIL_TEMP(p) (3 + (p) * 2)
+#define REPORT_METRIC_COUNT (2 + MAX_SOIL_PROBES * 2)
+
+// Policy per kind of metric; every soil probe shares the soil policies
+enum ReportMetricKind {
+  METRIC_AIR_TEMP,
+  METRIC_AIR_HUMIDITY,
+  METRIC_SOIL_MOISTURE,
+  METRIC_SOIL_TEMP,
+  METRIC_KIND_COUNT
+};
+
+struct ReportPolicy {
+  float abs_deadband;          // Publish when |value - last| >= this (0 = off)
+  float rel_deadband;          // Publish when |value - last| >= this * |last| (0 = off)
+  unsigned long heartbeat_ms;  // Publish at least this often while unchanged
+};
+
+// Which metrics are due in this publish cycle
+struct ReportDecision {
+  bool due[REPORT_METRIC_COUNT];
+  bool any;
+};
+
+// Function declarations
+bool takeReportDecision(const SensorSnapshot& snapshot, ReportDecision& decision);
+void markMetricsReported(const ReportDecision& decision, const SensorSnapshot& snapshot);
+void requestFullReport();
+void setReportInterval(unsigned long intervalMs);
+unsigned long getReportInterval();
+void printReportStats();
+
+extern ReportPolicy reportPolicies[METRIC_KIND_COUNT];
+
+#endif
\ No newline at end of file
@@ -0,0 +1,379 @@
+#include "sample_log.h"
+#include "mqtt_manager.h"
+#include "ntp_time.h"
+#include <LittleFS.h>
+
+// Append-only store-and-forward log on LittleFS.
+//
+// Records live in numbered segment files of SAMPLE_LOG_SEGMENT_RECORDS
+// records each, written in batches of SAMPLE_LOG_FLUSH_RECORDS. Positions
+// are counted in records from the creation of the log, so segment = pos /
+// SAMPLE_LOG_SEGMENT_RECORDS. Segments are only ever appended to and then
+// deleted whole, which keeps flash wear spread across the partition.
+//
+// Replayed records go through the QoS1 queue. The replay cursor marks the
+// first record the broker has not acknowledged; records up to the send
+// position are queued, and a PUBACK moves the cursor once every record
+// before it is acknowledged too. Samples taken while MQTT is connected and
+// nothing is pending count as delivered by the live path. The cursor is
+// persisted on every flush and once the backlog is acknowledged, so a
+// reboot replays at most one flush worth of records twice.
+
+#define SAMPLE_LOG_CURSOR_FILE SAMPLE_LOG_DIR "/cursor"
+#define SAMPLE_LOG_FORMAT_FILE SAMPLE_LOG_DIR "/format"
+
+static bool logMounted = false;
+static uint32_t firstSegment = 0;       // Oldest segment still on flash
+static uint32_t flushedPosition = 0;    // Records written to flash
+static uint32_t writePosition = 0;      // Records appended, including buffered
+static uint32_t replayPosition = 0;     // First record not yet acknowledged
+static uint32_t sendPosition = 0;       // First record not yet queued for replay
+static uint32_t settledMask = 0;        // Bit n: replayPosition + n acknowledged or skipped
+static bool replayAdvanced = false;     // Acks moved the cursor since the last check
+static uint32_t savedReplayPosition = 0;
+static unsigned long lastReplayStep = 0;
+
+static_assert(SAMPLE_LOG_REPLAY_WINDOW <= 32 && SAMPLE_LOG_REPLAY_WINDOW < MQTT_QUEUE_DEPTH,
+              "The replay window must fit the settled mask and leave queue slots for live data");
+
+static SampleLogRecord writeBuffer[SAMPLE_LOG_FLUSH_RECORDS];
+static uint8_t bufferedRecords = 0;
+
+// Counters since boot
+static uint32_t recordsReplayed = 0;
+static uint32_t recordsDropped = 0;     // Lost to rotation before replay
+static uint32_t crcErrors = 0;
+static uint32_t writeErrors = 0;
+
+static void segmentPath(uint32_t segment, char* path, size_t size) {
+  snprintf(path, size, SAMPLE_LOG_DIR "/%08lu.seg", (unsigned long)segment);
+}
+
+// CRC-16/CCITT-FALSE
+static uint16_t crc16(const uint8_t* data, size_t len) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (uint8_t b = 0; b < 8; b++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+static uint16_t recordCRC(const SampleLogRecord& record) {
+  return crc16((const uint8_t*)&record, offsetof(SampleLogRecord, crc));
+}
+
+static void saveReplayCursor() {
+  if (replayPosition == savedReplayPosition) return;
+  File file = LittleFS.open(SAMPLE_LOG_CURSOR_FILE, "w");
+  if (!file) {
+    writeErrors++;
+    return;
+  }
+  file.write((const uint8_t*)&replayPosition, sizeof(replayPosition));
+  file.close();
+  savedReplayPosition = replayPosition;
+}
+
+// Moves the cursor forward, e.g. past records lost to rotation
+static void moveReplayCursor(uint32_t position) {
+  uint32_t shift = position - replayPosition;
+  settledMask = shift >= 32 ? 0 : settledMask >> shift;
+  replayPosition = position;
+  if (sendPosition < position) sendPosition = position;
+}
+
+// Marks a queued record as done and moves the cursor over every settled
+// record at its front. Records lost to rotation meanwhile are ignored.
+static void settleRecord(uint32_t position) {
+  if (position < replayPosition || position >= sendPosition) return;
+  settledMask |= 1UL << (position - replayPosition);
+  while (settledMask & 1) {
+    settledMask >>= 1;
+    replayPosition++;
+    replayAdvanced = true;
+  }
+}
+
+// PUBACK for a replayed record, from the MQTT queue
+static void onRecordDelivered(uint32_t position) {
+  if (position < replayPosition || position >= sendPosition) return;
+  recordsReplayed++;
+  settleRecord(position);
+}
+
+static void removeSegment(uint32_t segment) {
+  char path[32];
+  segmentPath(segment, path, sizeof(path));
+  LittleFS.remove(path);
+}
+
+// Drop segments the broker already has, then the oldest ones if the log is
+// over its size limit even though they were never delivered
+static void trimSegments() {
+  uint32_t delivered = min(replayPosition, flushedPosition);
+  while (firstSegment < delivered / SAMPLE_LOG_SEGMENT_RECORDS) {
+    removeSegment(firstSegment++);
+  }
+  
+  uint32_t writeSegment = flushedPosition / SAMPLE_LOG_SEGMENT_RECORDS;
+  while (writeSegment - firstSegment + 1 > SAMPLE_LOG_MAX_SEGMENTS) {
+    removeSegment(firstSegment++);
+    uint32_t oldest = firstSegment * SAMPLE_LOG_SEGMENT_RECORDS;
+    if (replayPosition < oldest) {
+      recordsDropped += oldest - replayPosition;
+      moveReplayCursor(oldest);
+    }
+  }
+}
+
+// Write buffered records out, splitting the batch at segment boundaries
+static void flushSampleLog() {
+  uint8_t written = 0;
+  while (written < bufferedRecords) {
+    uint32_t segment = flushedPosition / SAMPLE_LOG_SEGMENT_RECORDS;
+    uint32_t room = SAMPLE_LOG_SEGMENT_RECORDS - flushedPosition % SAMPLE_LOG_SEGMENT_RECORDS;
+    uint8_t count = min((uint32_t)(bufferedRecords - written), room);
+    
+    char path[32];
+    segmentPath(segment, path, sizeof(path));
+    File file = LittleFS.open(path, "a");
+    size_t bytes = count * sizeof(SampleLogRecord);
+    if (!file || file.write((const uint8_t*)&writeBuffer[written], bytes) != bytes) {
+      // Keep the rest buffered and try again on the next flush
+      if (file) file.close();
+      writeErrors++;
+      break;
+    }
+    file.close();
+    written += count;
+    flushedPosition += count;
+    trimSegments();
+  }
+  
+  if (written > 0) {
+    memmove(writeBuffer, writeBuffer + written, (bufferedRecords - written) * sizeof(SampleLogRecord));
+    bufferedRecords -= written;
+  }
+  saveReplayCursor();
+}
+
+// Segments written with another record layout cannot be read back; drop
+// them rather than replaying garbage
+static void checkLogFormat() {
+  uint32_t format = sizeof(SampleLogRecord);
+  uint32_t saved = 0;
+  File file = LittleFS.open(SAMPLE_LOG_FORMAT_FILE, "r");
+  if (file) {
+    if (file.read((uint8_t*)&saved, sizeof(saved)) != sizeof(saved)) saved = 0;
+    file.close();
+  }
+  if (saved == format) return;
+  
+  // Segment numbers are contiguous; collect the range before removing
+  bool anySegment = false;
+  uint32_t oldest = 0, newest = 0;
+  File dir = LittleFS.open(SAMPLE_LOG_DIR);
+  for (File entry = dir.openNextFile(); entry; entry = dir.openNextFile()) {
+    const char* name = entry.name();
+    const char* dot = strrchr(name, '.');
+    if (dot == nullptr || strcmp(dot, ".seg") != 0) continue;
+    uint32_t segment = strtoul(name, nullptr, 10);
+    if (!anySegment || segment < oldest) oldest = segment;
+    if (!anySegment || segment > newest) newest = segment;
+    anySegment = true;
+  }
+  dir.close();
+  for (uint32_t segment = oldest; anySegment && segment <= newest; segment++) {
+    removeSegment(segment);
+  }
+  LittleFS.remove(SAMPLE_LOG_CURSOR_FILE);
+  
+  file = LittleFS.open(SAMPLE_LOG_FORMAT_FILE, "w");
+  if (file) {
+    file.write((const uint8_t*)&format, sizeof(format));
+    file.close();
+  }
+  if (saved != 0) {
+    Serial.println("⚠️ Sample log record layout changed, old segments discarded");
+  }
+}
+
+bool initSampleLog() {
+  Serial.println("💽 Initializing sample log...");
+  
+  if (!LittleFS.begin(true)) {
+    Serial.println("❌ LittleFS mount failed, samples will not be persisted");
+    return false;
+  }
+  if (!LittleFS.exists(SAMPLE_LOG_DIR)) {
+    LittleFS.mkdir(SAMPLE_LOG_DIR);
+  }
+  checkLogFormat();
+  
+  // Find the oldest and newest segment files
+  bool anySegment = false;
+  uint32_t lastSegment = 0;
+  File dir = LittleFS.open(SAMPLE_LOG_DIR);
+  for (File entry = dir.openNextFile(); entry; entry = dir.openNextFile()) {
+    const char* name = entry.name();
+    const char* dot = strrchr(name, '.');
+    if (dot == nullptr || strcmp(dot, ".seg") != 0) continue;
+    uint32_t segment = strtoul(name, nullptr, 10);
+    if (!anySegment || segment < firstSegment) firstSegment = segment;
+    if (!anySegment || segment > lastSegment) lastSegment = segment;
+    anySegment = true;
+  }
+  dir.close();
+  
+  flushedPosition = firstSegment * SAMPLE_LOG_SEGMENT_RECORDS;
+  if (anySegment) {
+    char path[32];
+    segmentPath(lastSegment, path, sizeof(path));
+    File last = LittleFS.open(path, "r");
+    size_t size = last ? last.size() : 0;
+    if (last) last.close();
+    
+    if (size % sizeof(SampleLogRecord) != 0) {
+      // Torn write from a power loss; start clean in the next segment
+      flushedPosition = (lastSegment + 1) * SAMPLE_LOG_SEGMENT_RECORDS;
+    } else {
+      flushedPosition = lastSegment * SAMPLE_LOG_SEGMENT_RECORDS + size / sizeof(SampleLogRecord);
+    }
+  }
+  writePosition = flushedPosition;
+  
+  // Resume the replay where it stopped, within what is still on flash
+  replayPosition = firstSegment * SAMPLE_LOG_SEGMENT_RECORDS;
+  File cursor = LittleFS.open(SAMPLE_LOG_CURSOR_FILE, "r");
+  if (cursor) {
+    uint32_t saved;
+    if (cursor.read((uint8_t*)&saved, sizeof(saved)) == sizeof(saved) &&
+        saved >= replayPosition && saved <= flushedPosition) {
+      replayPosition = saved;
+    }
+    cursor.close();
+  }
+  sendPosition = replayPosition;
+  settledMask = 0;
+  savedReplayPosition = replayPosition;
+  logMounted = true;
+  
+  Serial.println("✅ Sample log ready: " + String(flushedPosition - replayPosition) + " records pending, " +
+                 String(LittleFS.usedBytes()) + "/" + String(LittleFS.totalBytes()) + " bytes used");
+  return true;
+}
+
+void appendSampleLog(const SensorSnapshot& snapshot, unsigned long timestamp) {
+  if (!logMounted) return;
+  
+  if (bufferedRecords >= SAMPLE_LOG_FLUSH_RECORDS) {
+    flushSampleLog();
+    if (bufferedRecords >= SAMPLE_LOG_FLUSH_RECORDS) return;  // Flash is failing
+  }
+  
+  SampleLogRecord& record = writeBuffer[bufferedRecords++];
+  memset(&record, 0, sizeof(record));  // Deterministic padding for the CRC
+  record.sequence = writePosition;
+  record.epoch = getEpochTime();
+  record.uptime_ms = timestamp;
+  snapshotToChannels(snapshot, timestamp, record.value, MAX_SOIL_PROBES);
+  record.crc = recordCRC(record);
+  
+  // With nothing pending and the broker up, the live path covers this sample
+  bool caughtUp = (replayPosition == writePosition);
+  writePosition++;
+  if (caughtUp && isMQTTConnected()) {
+    replayPosition = sendPosition = writePosition;
+  }
+  
+  if (bufferedRecords >= SAMPLE_LOG_FLUSH_RECORDS) {
+    flushSampleLog();
+  }
+}
+
+// Skips unreadable records. Only done with nothing in flight, since the
+// settled mask cannot span a whole segment.
+static void skipReplayTo(uint32_t position) {
+  if (sendPosition != replayPosition) return;
+  moveReplayCursor(position);
+  replayAdvanced = true;
+}
+
+// Queue the next few backlog records, oldest first, keeping at most
+// SAMPLE_LOG_REPLAY_WINDOW unacknowledged. Rate limited so live publishing
+// and the web server keep their share of the loop.
+static void replayStep() {
+  if (sendPosition >= writePosition || !isMQTTConnected()) return;
+  if (sendPosition - replayPosition >= SAMPLE_LOG_REPLAY_WINDOW) return;
+  if (millis() - lastReplayStep < SAMPLE_LOG_REPLAY_INTERVAL) return;
+  lastReplayStep = millis();
+  
+  // Backlog still sitting in RAM has to reach flash before it is read back
+  if (sendPosition >= flushedPosition) {
+    flushSampleLog();
+    if (sendPosition >= flushedPosition) return;
+  }
+  
+  uint32_t segment = sendPosition / SAMPLE_LOG_SEGMENT_RECORDS;
+  uint32_t offset = sendPosition % SAMPLE_LOG_SEGMENT_RECORDS;
+  uint32_t segmentEnd = min((segment + 1) * SAMPLE_LOG_SEGMENT_RECORDS, flushedPosition);
+  char path[32];
+  segmentPath(segment, path, sizeof(path));
+  File file = LittleFS.open(path, "r");
+  if (!file || !file.seek(offset * sizeof(SampleLogRecord))) {
+    // Segment is gone or short; skip to the next one
+    if (file) file.close();
+    skipReplayTo(segmentEnd);
+    return;
+  }
+  
+  for (uint8_t i = 0; i < SAMPLE_LOG_REPLAY_BATCH && sendPosition < segmentEnd; i++) {
+    if (sendPosition - replayPosition >= SAMPLE_LOG_REPLAY_WINDOW) break;
+    
+    SampleLogRecord record;
+    if (file.read((uint8_t*)&record, sizeof(record)) != sizeof(record)) {
+      skipReplayTo(segmentEnd);
+      break;
+    }
+    if (record.crc != recordCRC(record)) {
+      crcErrors++;
+      settleRecord(sendPosition++);
+      continue;
+    }
+    if (!publishLoggedSample(record, onRecordDelivered)) break;  // Queue full; try again on the next step
+    sendPosition++;
+  }
+  file.close();
+}
+
+// Called from loop(): drains the backlog and retires delivered segments
+void handleSampleLog() {
+  if (!logMounted) return;
+  
+  if (replayAdvanced) {
+    replayAdvanced = false;
+    trimSegments();
+    if (replayPosition >= flushedPosition) {
+      saveReplayCursor();
+      if (replayPosition >= writePosition) {
+        Serial.println("✅ Sample log backlog drained (" + String(recordsReplayed) + " records replayed)");
+      }
+    }
+  }
+  replayStep();
+}
+
+uint32_t getSampleLogBacklog() {
+  return writePosition - replayPosition;
+}
+
+void printSampleLogStats() {
+  if (!logMounted) return;
+  uint32_t segments = (flushedPosition / SAMPLE_LOG_SEGMENT_RECORDS) - firstSegment + 1;
+  Serial.println("💽 Sample log: " + String(getSampleLogBacklog()) + " pending, " + String(segments) + " segments, " +
+                 String(recordsReplayed) + " replayed, " + String(recordsDropped) + " dropped, " +
+                 String(crcErrors) + " CRC errors, " + String(writeErrors) + " write errors");
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+// sample_log.h
+#ifndef SAMPLE_LOG_H
+#define SAMPLE_LOG_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "sensor_history.h"
+
+// Every soil probe the firmware supports, whatever HISTORY_MAX_PROBES keeps
+#define SAMPLE_LOG_CHANNELS REPORT_METRIC_COUNT
+
+// One persisted sample. Records are fixed size and never rewritten, so a
+// record's position in the log is also its sequence number.
+struct SampleLogRecord {
+  uint32_t sequence;                   // Position in the log since it was created
+  uint32_t epoch;                      // Unix time, 0 if NTP had not synced yet
+  uint32_t uptime_ms;                  // millis() when the sample was taken
+  int16_t value[SAMPLE_LOG_CHANNELS];  // Same fixed-point layout as the history
+  uint16_t crc;                        // CRC-16/CCITT over the preceding bytes
+};
+
+// Function declarations
+bool initSampleLog();
+void appendSampleLog(const SensorSnapshot& snapshot, unsigned long timestamp);
+void handleSampleLog();
+uint32_t getSampleLogBacklog();
+void printSampleLogStats();
+
+#endif
\ No newline at end of file
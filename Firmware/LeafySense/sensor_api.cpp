@@ -0,0 +1,249 @@
+#include "sensor_api.h"
+#include "config.h"
+#include "sensor_manager.h"
+#include "sensor_status.h"
+#include "wifi_manager.h"
+#include "i2c_bus.h"
+#include "memory_monitor.h"
+#include "mqtt_queue.h"
+#include "mqtt_manager.h"
+#include "ntp_time.h"
+#include <Arduino.h>
+
+enum SensorAPISection : uint8_t {
+  API_SECTION_HEADER,
+  API_SECTION_AIR,
+  API_SECTION_SOIL,
+  API_SECTION_PROBES,
+  API_SECTION_WIFI,
+  API_SECTION_I2C,
+  API_SECTION_MQTT,
+  API_SECTION_MEMORY,
+  API_SECTION_STACKS,
+  API_SECTION_END,
+  API_SECTION_DONE
+};
+
+// One response in progress. Handlers, fillers and disconnect callbacks all
+// run on the AsyncTCP task, so the slots need no locking.
+struct SensorStream {
+  bool busy;
+  uint32_t generation;          // Tells a late disconnect from the slot's next user
+  SensorAPISection section;
+  uint8_t item;                 // Probe, device or task within a list section
+  uint16_t length;              // Rendered bytes in line
+  uint16_t offset;              // Bytes of line already sent
+  char line[SENSOR_API_LINE_MAX];
+  SensorSnapshot snapshot;
+};
+
+static SensorStream streams[SENSOR_API_STREAMS];
+
+static void releaseStream(uint8_t index, uint32_t generation) {
+  if (streams[index].busy && streams[index].generation == generation) {
+    streams[index].busy = false;
+  }
+}
+
+static const char* jsonBool(bool value) {
+  return value ? "true" : "false";
+}
+
+// Renders the next piece of the document into stream.line. Returns false
+// once the document is complete.
+static bool renderNext(SensorStream& stream) {
+  char* line = stream.line;
+  const size_t size = sizeof(stream.line);
+  int length = 0;
+
+  while (length == 0) {
+    switch (stream.section) {
+      case API_SECTION_HEADER: {
+        char timestamp[24];
+        formatTimestamp(timestamp, sizeof(timestamp));
+        length = snprintf(line, size, "{\"time\":\"%s\",\"epoch\":%lu,\"uptime_s\":%lu,",
+                          timestamp, (unsigned long)getEpochTime(), millis() / 1000);
+        stream.section = API_SECTION_AIR;
+        break;
+      }
+
+      case API_SECTION_AIR: {
+        const AHT20_Data& air = stream.snapshot.air;
+        if (isAirSampleValid(air)) {
+          length = snprintf(line, size, "\"air\":{\"ok\":true,\"temperature\":%.2f,\"humidity\":%.2f},",
+                            air.temperature, air.humidity);
+        } else {
+          SensorError error = (air.error == SENSOR_OK) ? SENSOR_ERR_STALE : air.error;
+          length = snprintf(line, size, "\"air\":{\"ok\":false,\"error\":\"%s\"},", sensorErrorString(error));
+        }
+        stream.section = API_SECTION_SOIL;
+        break;
+      }
+
+      case API_SECTION_SOIL: {
+        const ADS1115_Data& soil = stream.snapshot.soil;
+        if (soil.ads1115_found) {
+          length = snprintf(line, size, "\"soil\":{\"ok\":true,\"probes\":[");
+        } else {
+          length = snprintf(line, size, "\"soil\":{\"ok\":false,\"error\":\"%s\",\"probes\":[", sensorErrorString(soil.error));
+        }
+        stream.section = API_SECTION_PROBES;
+        stream.item = 0;
+        break;
+      }
+
+      case API_SECTION_PROBES: {
+        const ADS1115_Data& soil = stream.snapshot.soil;
+        if (!soil.ads1115_found || stream.item >= soil.probe_count) {
+          length = snprintf(line, size, "]},");
+          stream.section = API_SECTION_WIFI;
+          break;
+        }
+        const SoilSensorData& probe = soil.probes[stream.item];
+        const char* separator = stream.item > 0 ? "," : "";
+        if (isSoilProbeValid(soil, stream.item)) {
+          length = snprintf(line, size, "%s{\"probe\":%u,\"ok\":true,\"moisture\":%.2f,\"temperature\":%.2f}",
+                            separator, (unsigned)(stream.item + 1), probe.moisture_percentage, probe.temperature_celsius);
+        } else {
+          char errorText[SENSOR_ERROR_TEXT_MAX];
+          formatSensorError(errorText, sizeof(errorText), probe.sensor_working ? SENSOR_ERR_STALE : probe.error,
+                            probe.error_detail);
+          length = snprintf(line, size, "%s{\"probe\":%u,\"ok\":false,\"error\":\"%s\"}",
+                            separator, (unsigned)(stream.item + 1), errorText);
+        }
+        stream.item++;
+        break;
+      }
+
+      case API_SECTION_WIFI: {
+        const WiFiConnectionStats& link = getWiFiConnectionStats();
+        IPAddress ip = WiFi.localIP();
+        length = snprintf(line, size,
+                          "\"wifi\":{\"connected\":%s,\"rssi\":%d,\"ip\":\"%u.%u.%u.%u\",\"connects\":%lu,\"drops\":%lu,"
+                          "\"last_outage_ms\":%lu,\"max_outage_ms\":%lu,\"time_to_ip_ms\":%lu},\"i2c\":[",
+                          jsonBool(isWiFiConnected()), (int)WiFi.RSSI(), ip[0], ip[1], ip[2], ip[3],
+                          (unsigned long)link.connects, (unsigned long)link.disconnects,
+                          (unsigned long)link.last_outage_ms, (unsigned long)link.max_outage_ms,
+                          (unsigned long)link.last_time_to_ip_ms);
+        stream.section = API_SECTION_I2C;
+        stream.item = 0;
+        break;
+      }
+
+      case API_SECTION_I2C: {
+        if (stream.item >= getI2CDeviceCount()) {
+          length = snprintf(line, size, "],");
+          stream.section = API_SECTION_MQTT;
+          break;
+        }
+        const I2CDeviceStats& dev = getI2CDeviceStats(stream.item);
+        uint32_t avg = dev.transactions ? (uint32_t)(dev.total_latency_us / dev.transactions) : 0;
+        length = snprintf(line, size, "%s{\"address\":\"0x%02x\",\"errors\":%lu,\"transactions\":%lu,\"avg_us\":%lu}",
+                          stream.item > 0 ? "," : "", dev.address, (unsigned long)dev.errors,
+                          (unsigned long)dev.transactions, (unsigned long)avg);
+        stream.item++;
+        break;
+      }
+
+      case API_SECTION_MQTT: {
+        const MQTTQueueStats& queue = getMQTTQueueStats();
+        const MQTTConnectionStats& link = getMQTTConnectionStats();
+        uint32_t avgAck = queue.delivered ? (uint32_t)(queue.total_ack_ms / queue.delivered) : 0;
+        length = snprintf(line, size,
+                          "\"mqtt\":{\"queued\":%u,\"capacity\":%u,\"dropped\":%lu,\"retransmits\":%lu,\"ack_avg_ms\":%lu,"
+                          "\"ack_max_ms\":%lu,\"connects\":%lu,\"attempts\":%lu,\"failures\":%lu,"
+                          "\"last_reconnect_ms\":%lu,\"max_reconnect_ms\":%lu},",
+                          (unsigned)queue.depth, (unsigned)MQTT_QUEUE_DEPTH, (unsigned long)queue.dropped,
+                          (unsigned long)queue.retransmits, (unsigned long)avgAck, (unsigned long)queue.max_ack_ms,
+                          (unsigned long)link.connects, (unsigned long)link.attempts, (unsigned long)link.failures,
+                          (unsigned long)link.last_reconnect_ms, (unsigned long)link.max_reconnect_ms);
+        stream.section = API_SECTION_MEMORY;
+        break;
+      }
+
+      case API_SECTION_MEMORY: {
+        const MemoryStats& mem = getMemoryStats();
+        bool low = mem.warnings & (MEMORY_WARN_LOW_HEAP | MEMORY_WARN_FRAGMENTED);
+        length = snprintf(line, size,
+                          "\"memory\":{\"free_heap\":%lu,\"min_free_heap\":%lu,\"largest_block\":%lu,"
+                          "\"min_largest_block\":%lu,\"alloc_failures\":%lu,\"low\":%s},\"stacks\":[",
+                          (unsigned long)mem.free_heap, (unsigned long)mem.min_free_heap,
+                          (unsigned long)mem.largest_free_block, (unsigned long)mem.min_largest_block,
+                          (unsigned long)mem.alloc_failures, jsonBool(low));
+        stream.section = API_SECTION_STACKS;
+        stream.item = 0;
+        break;
+      }
+
+      case API_SECTION_STACKS: {
+        if (stream.item >= getTaskStackCount()) {
+          stream.section = API_SECTION_END;
+          break;
+        }
+        const TaskStackInfo& task = getTaskStackInfo(stream.item);
+        length = snprintf(line, size, "%s{\"task\":\"%s\",\"free\":%lu,\"low\":%s}",
+                          stream.item > 0 ? "," : "", task.name, (unsigned long)task.stack_free,
+                          jsonBool(task.stack_free < MEMORY_WARN_STACK_FREE));
+        stream.item++;
+        break;
+      }
+
+      case API_SECTION_END:
+        length = snprintf(line, size, "]}");
+        stream.section = API_SECTION_DONE;
+        break;
+
+      case API_SECTION_DONE:
+        return false;
+    }
+  }
+
+  // A truncated line would break the document; SENSOR_API_LINE_MAX covers
+  // the longest section
+  stream.length = min<int>(length, size - 1);
+  stream.offset = 0;
+  return true;
+}
+
+void handleSensorsAPI(AsyncWebServerRequest* request) {
+  uint8_t index = 0;
+  while (index < SENSOR_API_STREAMS && streams[index].busy) index++;
+  if (index == SENSOR_API_STREAMS) {
+    AsyncWebServerResponse* response = request->beginResponse(503, "application/json", "{\"error\":\"busy\"}");
+    response->addHeader("Retry-After", "1");
+    request->send(response);
+    return;
+  }
+
+  SensorStream& stream = streams[index];
+  stream.busy = true;
+  uint32_t generation = ++stream.generation;
+  stream.section = API_SECTION_HEADER;
+  stream.item = 0;
+  stream.length = 0;
+  stream.offset = 0;
+  copySensorSnapshot(stream.snapshot);
+
+  // Frees the slot if the client goes away before the document is done
+  request->onDisconnect([index, generation]() { releaseStream(index, generation); });
+
+  AsyncWebServerResponse* response = request->beginChunkedResponse("application/json",
+    [index, generation](uint8_t* buffer, size_t maxLen, size_t) -> size_t {
+      SensorStream& stream = streams[index];
+      if (!stream.busy || stream.generation != generation) return 0;
+
+      size_t written = 0;
+      while (written < maxLen) {
+        if (stream.offset == stream.length && !renderNext(stream)) break;
+        size_t chunk = min<size_t>(stream.length - stream.offset, maxLen - written);
+        memcpy(buffer + written, stream.line + stream.offset, chunk);
+        stream.offset += chunk;
+        written += chunk;
+      }
+
+      if (written == 0) releaseStream(index, generation);
+      return written;
+    });
+  response->addHeader("Cache-Control", "no-store");
+  request->send(response);
+}
\ No newline at end of file
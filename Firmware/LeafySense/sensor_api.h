@@ -0,0 +1,31 @@
+// sensor_api.h
+#ifndef SENSOR_API_H
+#define SENSOR_API_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+// GET /api/v1/sensors - the cached sample plus link, bus and memory health
+// as one JSON document, sent with chunked transfer encoding:
+//
+//   {"time":"...","epoch":...,"uptime_s":...,
+//    "air":{"ok":true,"temperature":21.34,"humidity":48.20},
+//    "soil":{"ok":true,"probes":[{"probe":1,"ok":true,"moisture":41.50,"temperature":18.75},...]},
+//    "wifi":{"connected":true,"rssi":-61,"ip":"...","connects":...,"drops":...,"last_outage_ms":...,"max_outage_ms":...,"time_to_ip_ms":...},
+//    "i2c":[{"address":"0x38","errors":0,"transactions":...,"avg_us":...},...],
+//    "mqtt":{"queued":...,"capacity":...,"dropped":...,"retransmits":...,"ack_avg_ms":...,"ack_max_ms":...,
+//            "connects":...,"attempts":...,"failures":...,"last_reconnect_ms":...,"max_reconnect_ms":...},
+//    "memory":{"free_heap":...,"min_free_heap":...,"largest_block":...,"min_largest_block":...,"alloc_failures":...,"low":false},
+//    "stacks":[{"task":"loopTask","free":...,"low":false},...]}
+//
+// A sensor that is not working has "ok":false and an "error" text instead
+// of values. The document is rendered one section at a time into a fixed
+// line buffer while the response is being sent, from a copy of the
+// snapshot taken when the request arrived; at most SENSOR_API_STREAMS
+// responses are in progress at once (503 beyond that). The pre-API path
+// GET /sensor-data serves the same document.
+
+// Function declarations
+void handleSensorsAPI(AsyncWebServerRequest* request);
+
+#endif
\ No newline at end of file
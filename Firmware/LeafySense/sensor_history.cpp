@@ -0,0 +1,205 @@
+#include "sensor_history.h"
+#include <Arduino.h>
+#include <math.h>
+
+// Ring bookkeeping; head is the next slot to write
+struct HistoryRing {
+  uint16_t head;
+  uint16_t count;
+};
+
+// Running min/sum/max for the bucket currently being filled
+struct HistoryAccumulator {
+  uint32_t bucket;                    // timestamp / bucket length
+  uint16_t samples;
+  bool open;
+  int32_t sum[HISTORY_CHANNELS];
+  uint16_t count[HISTORY_CHANNELS];
+  int16_t min[HISTORY_CHANNELS];
+  int16_t max[HISTORY_CHANNELS];
+};
+
+static HistorySample rawSamples[HISTORY_RAW_SAMPLES];
+static HistoryRollup minuteRollups[HISTORY_MINUTE_SLOTS];
+static HistoryRollup hourRollups[HISTORY_HOUR_SLOTS];
+static HistoryRing rawRing = {0, 0};
+static HistoryRing minuteRing = {0, 0};
+static HistoryRing hourRing = {0, 0};
+static HistoryAccumulator minuteBucket = {};
+static HistoryAccumulator hourBucket = {};
+// Guards the rings against the /api/v1/history reader on the AsyncTCP task
+static portMUX_TYPE historyLock = portMUX_INITIALIZER_UNLOCKED;
+
+static_assert(HISTORY_RAW_SAMPLES <= 65535 && HISTORY_MINUTE_SLOTS <= 65535 && HISTORY_HOUR_SLOTS <= 65535,
+              "History ring indices are 16-bit");
+static_assert(sizeof(rawSamples) + sizeof(minuteRollups) + sizeof(hourRollups) +
+              2 * sizeof(HistoryAccumulator) <= HISTORY_RAM_BUDGET,
+              "Sample history exceeds HISTORY_RAM_BUDGET");
+
+static uint16_t advanceRing(HistoryRing& ring, uint16_t capacity) {
+  uint16_t slot = ring.head;
+  ring.head = (ring.head + 1) % capacity;
+  if (ring.count < capacity) ring.count++;
+  return slot;
+}
+
+// Slot holding the entry `age` steps back from the newest
+static uint16_t ringSlot(const HistoryRing& ring, uint16_t capacity, uint16_t age) {
+  return (ring.head + capacity - 1 - age) % capacity;
+}
+
+static int16_t toCenti(float value) {
+  long centi = lroundf(value * 100.0f);
+  if (centi <= INT16_MIN) return INT16_MIN + 1;  // INT16_MIN is HISTORY_NO_DATA
+  if (centi > INT16_MAX) return INT16_MAX;
+  return (int16_t)centi;
+}
+
+// Samples that stopped updating count as missing rather than repeating
+static bool isFresh(unsigned long sampleTime, unsigned long now) {
+  return sampleTime != 0 && now - sampleTime <= SENSOR_CACHE_MAX_AGE;
+}
+
+// Fills the report metric layout for the first `probes` soil probes
+void snapshotToChannels(const SensorSnapshot& snapshot, unsigned long now, int16_t* values, uint8_t probes) {
+  for (uint8_t c = 0; c < 2 + probes * 2; c++) {
+    values[c] = HISTORY_NO_DATA;
+  }
+  
+  const AHT20_Data& air = snapshot.air;
+  if (air.sensor_found && air.error == SENSOR_OK && isFresh(air.timestamp, now)) {
+    values[REPORT_METRIC_AIR_TEMP] = toCenti(air.temperature);
+    values[REPORT_METRIC_AIR_HUMIDITY] = toCenti(air.humidity);
+  }
+  
+  const ADS1115_Data& soil = snapshot.soil;
+  if (!isFresh(soil.timestamp, now)) return;
+  for (uint8_t p = 0; p < probes && p < soil.probe_count; p++) {
+    if (!soil.probes[p].sensor_working) continue;
+    values[REPORT_METRIC_SOIL_MOISTURE(p)] = toCenti(soil.probes[p].moisture_percentage);
+    values[REPORT_METRIC_SOIL_TEMP(p)] = toCenti(soil.probes[p].temperature_celsius);
+  }
+}
+
+static void openBucket(HistoryAccumulator& acc, uint32_t bucket) {
+  acc.bucket = bucket;
+  acc.samples = 0;
+  acc.open = true;
+  for (uint8_t c = 0; c < HISTORY_CHANNELS; c++) {
+    acc.sum[c] = 0;
+    acc.count[c] = 0;
+    acc.min[c] = INT16_MAX;
+    acc.max[c] = INT16_MIN;
+  }
+}
+
+static void closeBucket(const HistoryAccumulator& acc, unsigned long bucketMs,
+                        HistoryRollup* rollups, HistoryRing& ring, uint16_t capacity) {
+  HistoryRollup& rollup = rollups[advanceRing(ring, capacity)];
+  rollup.timestamp = acc.bucket * bucketMs;
+  rollup.samples = acc.samples;
+  for (uint8_t c = 0; c < HISTORY_CHANNELS; c++) {
+    if (acc.count[c] == 0) {
+      rollup.min[c] = rollup.mean[c] = rollup.max[c] = HISTORY_NO_DATA;
+      continue;
+    }
+    rollup.min[c] = acc.min[c];
+    rollup.max[c] = acc.max[c];
+    rollup.mean[c] = (int16_t)(acc.sum[c] / (int32_t)acc.count[c]);
+  }
+}
+
+// Fold one sample into a tier, first closing the bucket if the sample
+// belongs to a later one
+static void accumulate(HistoryAccumulator& acc, unsigned long bucketMs, unsigned long timestamp,
+                       const int16_t* values, HistoryRollup* rollups, HistoryRing& ring, uint16_t capacity) {
+  uint32_t bucket = timestamp / bucketMs;
+  if (acc.open && acc.bucket != bucket) {
+    closeBucket(acc, bucketMs, rollups, ring, capacity);
+    acc.open = false;
+  }
+  if (!acc.open) {
+    openBucket(acc, bucket);
+  }
+  
+  if (acc.samples < UINT16_MAX) acc.samples++;
+  for (uint8_t c = 0; c < HISTORY_CHANNELS; c++) {
+    int16_t v = values[c];
+    if (v == HISTORY_NO_DATA || acc.count[c] == UINT16_MAX) continue;
+    acc.sum[c] += v;
+    acc.count[c]++;
+    if (v < acc.min[c]) acc.min[c] = v;
+    if (v > acc.max[c]) acc.max[c] = v;
+  }
+}
+
+// O(1): one raw slot write plus a constant amount of work per tier
+void appendSensorHistory(const SensorSnapshot& snapshot, unsigned long timestamp) {
+  int16_t values[HISTORY_CHANNELS];
+  snapshotToChannels(snapshot, timestamp, values, HISTORY_MAX_PROBES);
+  
+  portENTER_CRITICAL(&historyLock);
+  HistorySample& sample = rawSamples[advanceRing(rawRing, HISTORY_RAW_SAMPLES)];
+  sample.timestamp = timestamp;
+  memcpy(sample.value, values, sizeof(sample.value));
+  accumulate(minuteBucket, HISTORY_MINUTE_MS, timestamp, values,
+             minuteRollups, minuteRing, HISTORY_MINUTE_SLOTS);
+  accumulate(hourBucket, HISTORY_HOUR_MS, timestamp, values,
+             hourRollups, hourRing, HISTORY_HOUR_SLOTS);
+  portEXIT_CRITICAL(&historyLock);
+}
+
+uint16_t getHistoryCount(HistoryTier tier) {
+  switch (tier) {
+    case HISTORY_TIER_RAW:    return rawRing.count;
+    case HISTORY_TIER_MINUTE: return minuteRing.count;
+    case HISTORY_TIER_HOUR:   return hourRing.count;
+  }
+  return 0;
+}
+
+uint16_t getHistoryCapacity(HistoryTier tier) {
+  switch (tier) {
+    case HISTORY_TIER_RAW:    return HISTORY_RAW_SAMPLES;
+    case HISTORY_TIER_MINUTE: return HISTORY_MINUTE_SLOTS;
+    case HISTORY_TIER_HOUR:   return HISTORY_HOUR_SLOTS;
+  }
+  return 0;
+}
+
+// age 0 is the newest sample
+bool getHistorySample(uint16_t age, HistorySample& sample) {
+  portENTER_CRITICAL(&historyLock);
+  bool found = age < rawRing.count;
+  if (found) sample = rawSamples[ringSlot(rawRing, HISTORY_RAW_SAMPLES, age)];
+  portEXIT_CRITICAL(&historyLock);
+  return found;
+}
+
+// age 0 is the newest closed bucket; the bucket still filling is not returned
+bool getHistoryRollup(HistoryTier tier, uint16_t age, HistoryRollup& rollup) {
+  bool found = false;
+  portENTER_CRITICAL(&historyLock);
+  if (tier == HISTORY_TIER_MINUTE && age < minuteRing.count) {
+    rollup = minuteRollups[ringSlot(minuteRing, HISTORY_MINUTE_SLOTS, age)];
+    found = true;
+  } else if (tier == HISTORY_TIER_HOUR && age < hourRing.count) {
+    rollup = hourRollups[ringSlot(hourRing, HISTORY_HOUR_SLOTS, age)];
+    found = true;
+  }
+  portEXIT_CRITICAL(&historyLock);
+  return found;
+}
+
+size_t getHistoryMemoryUsage() {
+  return sizeof(rawSamples) + sizeof(minuteRollups) + sizeof(hourRollups) +
+         sizeof(minuteBucket) + sizeof(hourBucket);
+}
+
+void printSensorHistoryStats() {
+  Serial.println("🗃️ History: raw " + String(rawRing.count) + "/" + String(HISTORY_RAW_SAMPLES) +
+                 ", 1-min " + String(minuteRing.count) + "/" + String(HISTORY_MINUTE_SLOTS) +
+                 ", 1-h " + String(hourRing.count) + "/" + String(HISTORY_HOUR_SLOTS) +
+                 " (" + String(getHistoryMemoryUsage()) + " bytes)" +
+                 (SOIL_PROBE_COUNT > HISTORY_MAX_PROBES ? ", soil probes 1-" + String(HISTORY_MAX_PROBES) + " only" : ""));
+}
\ No newline at end of file
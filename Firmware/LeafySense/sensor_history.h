@@ -0,0 +1,59 @@
+// sensor_history.h
+#ifndef SENSOR_HISTORY_H
+#define SENSOR_HISTORY_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "sensor_manager.h"
+#include "report_policy.h"
+
+// Fixed-memory sample history in three tiers:
+//   raw     every sample at SENSOR_READ_INTERVAL
+//   minute  min/mean/max of each 1-minute bucket
+//   hour    min/mean/max of each 1-hour bucket
+// Channels use the report metric layout (REPORT_METRIC_*) for the first
+// HISTORY_MAX_PROBES probes only; probes beyond that are not kept in RAM
+// (the flash sample log records every probe). Values are fixed point:
+// centi-°C for temperatures, centi-% for humidity and moisture.
+//
+// RAM budget with the defaults (6 channels), all static:
+//   raw     720 x 16 B = 11,520 B   (1 hour)
+//   minute  360 x 44 B = 15,840 B   (6 hours)
+//   hour    168 x 44 B =  7,392 B   (7 days)
+//   open buckets        ~  100 B
+// about 34.9 KB, checked against HISTORY_RAM_BUDGET at compile time.
+#define HISTORY_CHANNELS (2 + HISTORY_MAX_PROBES * 2)
+#define HISTORY_NO_DATA INT16_MIN  // Channel had no valid reading
+#define HISTORY_MINUTE_MS 60000UL
+#define HISTORY_HOUR_MS 3600000UL
+
+enum HistoryTier {
+  HISTORY_TIER_RAW,
+  HISTORY_TIER_MINUTE,
+  HISTORY_TIER_HOUR
+};
+
+struct HistorySample {
+  uint32_t timestamp;                 // millis() when the sample was recorded
+  int16_t value[HISTORY_CHANNELS];
+};
+
+struct HistoryRollup {
+  uint32_t timestamp;                 // millis() at the start of the bucket
+  uint16_t samples;                   // Samples folded into the bucket
+  int16_t min[HISTORY_CHANNELS];      // HISTORY_NO_DATA if the channel had none
+  int16_t mean[HISTORY_CHANNELS];
+  int16_t max[HISTORY_CHANNELS];
+};
+
+// Function declarations
+void appendSensorHistory(const SensorSnapshot& snapshot, unsigned long timestamp);
+void snapshotToChannels(const SensorSnapshot& snapshot, unsigned long now, int16_t* values, uint8_t probes);
+uint16_t getHistoryCount(HistoryTier tier);
+uint16_t getHistoryCapacity(HistoryTier tier);
+bool getHistorySample(uint16_t age, HistorySample& sample);
+bool getHistoryRollup(HistoryTier tier, uint16_t age, HistoryRollup& rollup);
+size_t getHistoryMemoryUsage();
+void printSensorHistoryStats();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include "sensor_manager.h"
+#include "config.h"
+#include "sensor_history.h"
+#include "sample_log.h"
+#include "report_policy.h"
+#include <Arduino.h>
+
+static SensorSnapshot snapshot = {};
+// Guards snapshot writes against copySensorSnapshot() on other tasks
+static portMUX_TYPE snapshotLock = portMUX_INITIALIZER_UNLOCKED;
+static unsigned long lastSensorRead = 0;
+static unsigned long lastForcedRefresh = 0;  // Stale-cache refresh from getSensorSnapshot()
+static bool historyPending = false;  // Interval read started, not yet recorded
+static bool reportPending = false;   // Burst or on-demand read started, not yet reported
+static bool samplesChanged = false;  // A sample was replaced since the last version bump
+static unsigned long sensorReadInterval = SENSOR_READ_INTERVAL;
+
+// Burst mode: extra reads between the regular ones, each reported in full
+static bool burstActive = false;
+static unsigned long burstStartedAt = 0;
+static unsigned long burstDuration = 0;
+static unsigned long burstInterval = 0;
+static unsigned long lastBurstRead = 0;
+
+static void storeAirSample() {
+  AHT20_Data air = readAHT20();
+  portENTER_CRITICAL(&snapshotLock);
+  snapshot.air = air;
+  portEXIT_CRITICAL(&snapshotLock);
+  samplesChanged = true;
+}
+
+// Start both sensors if they are idle; already running reads are left alone.
+// A trigger that fails never finishes a measurement, so its error goes into
+// the snapshot right away.
+void requestSensorRefresh() {
+  if (!startAHT20Measurement() && !isAHT20Measuring()) {
+    storeAirSample();
+  }
+  startSoilSensorScan();
+}
+
+// The single sampling owner. Triggers reads every sensor read interval and
+// copies finished samples into the snapshot. Once both reads of an interval
+// have settled the snapshot is appended to the sample history and the
+// flash sample log. Burst and on-demand reads in between are reported in
+// full but not recorded, so the history keeps its regular spacing. Never
+// blocks.
+void handleSensorSampling() {
+  unsigned long now = millis();
+  
+  if (burstActive && now - burstStartedAt >= burstDuration) {
+    burstActive = false;
+    Serial.println("⏹️ Burst sampling finished");
+  }
+  
+  if (now - lastSensorRead >= sensorReadInterval) {
+    lastSensorRead = now;
+    Serial.println("\n--- Reading Sensors ---");
+    requestSensorRefresh();
+    historyPending = true;
+    reportPending = reportPending || burstActive;
+  } else if (burstActive && now - lastBurstRead >= burstInterval) {
+    lastBurstRead = now;
+    requestSensorRefresh();
+    reportPending = true;
+  }
+  
+  // Failed measurements land too, so an error replaces the last good values
+  if (handleAHT20()) {
+    storeAirSample();
+    if (!burstActive) printAHT20Data(snapshot.air);
+  }
+  
+  if (handleADS1115Scan()) {
+    ADS1115_Data soil = readAllSoilSensors();
+    portENTER_CRITICAL(&snapshotLock);
+    snapshot.soil = soil;
+    portEXIT_CRITICAL(&snapshotLock);
+    samplesChanged = true;
+    if (!burstActive) printADS1115Data(snapshot.soil);
+  }
+  
+  if (isAHT20Measuring() || isSoilSensorScanRunning()) return;
+  
+  // One version per settled read, so the report policy evaluates air and
+  // soil together instead of once per sensor
+  if (samplesChanged) {
+    portENTER_CRITICAL(&snapshotLock);
+    snapshot.version++;
+    portEXIT_CRITICAL(&snapshotLock);
+    samplesChanged = false;
+  }
+  
+  if (historyPending || reportPending) {
+    if (historyPending) {
+      unsigned long sampleTime = millis();
+      appendSensorHistory(snapshot, sampleTime);
+      appendSampleLog(snapshot, sampleTime);
+    }
+    if (reportPending) {
+      requestFullReport();
+    }
+    historyPending = false;
+    reportPending = false;
+  }
+}
+
+// Reads every sensor now and reports the result in full once it settles
+void requestImmediateSample() {
+  requestSensorRefresh();
+  reportPending = true;
+}
+
+// The raw history is sized for SENSOR_READ_INTERVAL, so a longer interval
+// stretches the hour it covers and a shorter one shrinks it
+void setSensorReadInterval(unsigned long intervalMs) {
+  sensorReadInterval = intervalMs;
+}
+
+unsigned long getSensorReadInterval() {
+  return sensorReadInterval;
+}
+
+void startSensorBurst(unsigned long durationMs, unsigned long intervalMs) {
+  burstActive = true;
+  burstStartedAt = millis();
+  burstDuration = durationMs;
+  burstInterval = intervalMs;
+  lastBurstRead = burstStartedAt - intervalMs;  // First burst read right away
+  Serial.println("⏺️ Burst sampling every " + String(intervalMs) + " ms for " + String(durationMs / 1000) + " s");
+}
+
+void stopSensorBurst() {
+  if (burstActive) {
+    burstActive = false;
+    Serial.println("⏹️ Burst sampling stopped");
+  }
+}
+
+bool isSensorBurstActive() {
+  return burstActive;
+}
+
+// True while a measurement or ADS1115 sweep is running; loop() then polls
+// fast enough to pick up each conversion as it completes
+bool isSensorReadInProgress() {
+  return isAHT20Measuring() || isSoilSensorScanRunning();
+}
+
+unsigned long getSampleAge(unsigned long timestamp) {
+  return millis() - timestamp;
+}
+
+// Live consumers drop samples older than SENSOR_CACHE_MAX_AGE (or two read
+// intervals, when the cadence was slowed past that) instead of repeating
+// them. Safe to call from any task.
+bool isSampleFresh(unsigned long timestamp) {
+  unsigned long maxAge = max<unsigned long>(SENSOR_CACHE_MAX_AGE, 2 * sensorReadInterval);
+  return timestamp != 0 && getSampleAge(timestamp) <= maxAge;
+}
+
+bool isAirSampleValid(const AHT20_Data& air) {
+  return air.sensor_found && air.error == SENSOR_OK && isSampleFresh(air.timestamp);
+}
+
+bool isSoilProbeValid(const ADS1115_Data& soil, uint8_t probe) {
+  return probe < soil.probe_count && soil.probes[probe].sensor_working && isSampleFresh(soil.timestamp);
+}
+
+// Consumers only ever read the cache. If the oldest sample has aged past
+// SENSOR_CACHE_MAX_AGE a fresh read is started for the next caller, at most
+// once per sensor read interval: a sensor that keeps failing never advances
+// its timestamp and would otherwise be retried on every loop() pass.
+const SensorSnapshot& getSensorSnapshot() {
+  // Pick up init status and errors that never produced a completed sample
+  if (snapshot.version == 0) {
+    AHT20_Data air = readAHT20();
+    ADS1115_Data soil = readAllSoilSensors();
+    portENTER_CRITICAL(&snapshotLock);
+    snapshot.air = air;
+    snapshot.soil = soil;
+    portEXIT_CRITICAL(&snapshotLock);
+  }
+  
+  if ((getSampleAge(snapshot.air.timestamp) > SENSOR_CACHE_MAX_AGE ||
+       getSampleAge(snapshot.soil.timestamp) > SENSOR_CACHE_MAX_AGE) &&
+      millis() - lastForcedRefresh >= sensorReadInterval) {
+    lastForcedRefresh = millis();
+    requestSensorRefresh();
+  }
+  
+  return snapshot;
+}
+
+// For readers outside the loop task (the async web server): a consistent
+// copy with no side effects, so it never starts a sensor read
+void copySensorSnapshot(SensorSnapshot& out) {
+  portENTER_CRITICAL(&snapshotLock);
+  out = snapshot;
+  portEXIT_CRITICAL(&snapshotLock);
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+// sensor_manager.h
+#ifndef SENSOR_MANAGER_H
+#define SENSOR_MANAGER_H
+
+#include <Arduino.h>
+#include "aht20_sensor.h"
+#include "ads1115_sensor.h"
+
+// Latest cached samples from every sensor. Written only by the sampling
+// owner (handleSensorSampling); MQTT reads it in place, the web server
+// (another task) through copySensorSnapshot().
+struct SensorSnapshot {
+  AHT20_Data air;
+  ADS1115_Data soil;
+  uint32_t version;  // Incremented once per settled read (both sensors idle) that replaced a sample
+};
+
+// Function declarations
+void handleSensorSampling();
+void requestSensorRefresh();
+const SensorSnapshot& getSensorSnapshot();
+void copySensorSnapshot(SensorSnapshot& out);
+unsigned long getSampleAge(unsigned long timestamp);
+bool isSampleFresh(unsigned long timestamp);
+bool isAirSampleValid(const AHT20_Data& air);
+bool isSoilProbeValid(const ADS1115_Data& soil, uint8_t probe);
+bool isSensorReadInProgress();
+
+// Runtime cadence (MQTT command channel)
+void requestImmediateSample();
+void setSensorReadInterval(unsigned long intervalMs);
+unsigned long getSensorReadInterval();
+void startSensorBurst(unsigned long durationMs, unsigned long intervalMs);
+void stopSensorBurst();
+bool isSensorBurstActive();
+
+#endif
\ No newline at end of file
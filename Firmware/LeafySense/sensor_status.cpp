@@ -0,0 +1,42 @@
+#include "sensor_status.h"
+
+const char* sensorErrorString(SensorError error) {
+  switch (error) {
+    case SENSOR_OK:                   return "OK";
+    case SENSOR_ERR_NOT_INITIALIZED:  return "Sensor not initialized";
+    case SENSOR_ERR_NOT_FOUND:        return "Device not found";
+    case SENSOR_ERR_TRIGGER_FAILED:   return "Failed to trigger measurement";
+    case SENSOR_ERR_READ_FAILED:      return "Failed to read data";
+    case SENSOR_ERR_TIMEOUT:          return "Measurement timed out";
+    case SENSOR_ERR_CRC_MISMATCH:     return "CRC mismatch";
+    case SENSOR_ERR_MOISTURE_CHANNEL: return "Failed to read moisture channel";
+    case SENSOR_ERR_TEMP_CHANNEL:     return "Failed to read temperature channel";
+    case SENSOR_ERR_INVALID_PROBE:    return "Invalid probe configuration";
+    case SENSOR_ERR_TOO_MANY_CHIPS:   return "Too many ADS1115 chips";
+    case SENSOR_ERR_STALE:            return "Sample too old";
+  }
+  return "Unknown error";
+}
+
+// Renders the code plus its detail byte, e.g. "Device not found (0x49)"
+size_t formatSensorError(char* buffer, size_t size, SensorError error, uint8_t detail) {
+  if (size == 0) return 0;
+  int written;
+  switch (error) {
+    case SENSOR_ERR_NOT_FOUND:
+      written = snprintf(buffer, size, "%s (0x%02X)", sensorErrorString(error), detail);
+      break;
+    case SENSOR_ERR_MOISTURE_CHANNEL:
+    case SENSOR_ERR_TEMP_CHANNEL:
+      written = snprintf(buffer, size, "%s %u", sensorErrorString(error), detail);
+      break;
+    default:
+      written = snprintf(buffer, size, "%s", sensorErrorString(error));
+      break;
+  }
+  if (written < 0) {
+    buffer[0] = '\0';
+    return 0;
+  }
+  return (size_t)written < size ? (size_t)written : size - 1;
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+// sensor_status.h
+#ifndef SENSOR_STATUS_H
+#define SENSOR_STATUS_H
+
+#include <Arduino.h>
+
+// Error codes carried by the sensor data structs. Text is only rendered
+// at the serial/web edge, so failure paths never touch the heap.
+enum SensorError : uint8_t {
+  SENSOR_OK = 0,
+  SENSOR_ERR_NOT_INITIALIZED,
+  SENSOR_ERR_NOT_FOUND,          // detail: I2C address
+  SENSOR_ERR_TRIGGER_FAILED,
+  SENSOR_ERR_READ_FAILED,
+  SENSOR_ERR_TIMEOUT,
+  SENSOR_ERR_CRC_MISMATCH,
+  SENSOR_ERR_MOISTURE_CHANNEL,   // detail: ADS1115 channel
+  SENSOR_ERR_TEMP_CHANNEL,       // detail: ADS1115 channel
+  SENSOR_ERR_INVALID_PROBE,
+  SENSOR_ERR_TOO_MANY_CHIPS,
+  SENSOR_ERR_STALE               // Last good sample is older than the live limit
+};
+
+// Longest text formatSensorError() produces, including the terminator
+#define SENSOR_ERROR_TEXT_MAX 48
+
+// Function declarations
+const char* sensorErrorString(SensorError error);
+size_t formatSensorError(char* buffer, size_t size, SensorError error, uint8_t detail);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "soil_conversion.h"
+
+// Generated at compile time from the constants in config.h, stored in flash
+static constexpr NTCTable ntcTable = buildNTCTable();
+
+// Soil temperature in hundredths of a degree Celsius, by linear
+// interpolation between table entries
+int16_t ntcCountsToCentiCelsius(int16_t counts) {
+  // Same validity window as the Beta equation: 0 < V < VCC
+  if (counts <= 0 || counts >= NTC_VCC_COUNTS) {
+    return NTC_TEMP_ERROR_CENTI;
+  }
+  
+  int32_t index = counts >> NTC_LUT_SHIFT;
+  int32_t frac = counts & (NTC_LUT_STEP - 1);
+  int32_t lo = ntcTable.centi[index];
+  int32_t hi = ntcTable.centi[index + 1];
+  
+  return (int16_t)(lo + (((hi - lo) * frac) >> NTC_LUT_SHIFT));
+}
+
+// Soil moisture in hundredths of a percent (0-10000), integer math only.
+// Capacitive probes read lower when wet, so the scale is inverted.
+uint16_t moistureCountsToCentiPercent(int32_t counts, int32_t dry, int32_t wet) {
+  int32_t inverted_value = dry - counts;
+  int32_t range = dry - wet;
+  
+  // Avoid division by zero
+  if (range <= 0) range = 1;
+  
+  if (inverted_value <= 0) return 0;
+  if (inverted_value >= range) return 10000;
+  
+  return (uint16_t)((inverted_value * 10000 + range / 2) / range);
+}
\ No newline at end of file
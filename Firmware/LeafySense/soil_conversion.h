@@ -0,0 +1,70 @@
+// soil_conversion.h
+#ifndef SOIL_CONVERSION_H
+#define SOIL_CONVERSION_H
+
+#include <stdint.h>
+#include "config.h"
+
+// Integer-only conversions for the soil channels. The ESP32-C6 has no FPU,
+// so the Beta-equation (divide, log, two reciprocals) is evaluated once per
+// table entry at compile time and the firmware only interpolates.
+
+#define NTC_LUT_SHIFT 6                     // One table entry every 64 counts (12mV)
+#define NTC_LUT_STEP (1 << NTC_LUT_SHIFT)
+#define NTC_TEMP_ERROR_CENTI (-10000)       // -100.00°C, same error value as before
+
+// Full-scale count for VCC at the configured gain
+constexpr int32_t NTC_VCC_COUNTS = (int32_t)(VCC / ADS1115_VOLTS_PER_COUNT);
+constexpr int32_t NTC_LUT_SIZE = (NTC_VCC_COUNTS >> NTC_LUT_SHIFT) + 2;
+
+// constexpr natural log: range-reduce by powers of two, then atanh series
+constexpr double ntcLn(double x) {
+  int k = 0;
+  while (x > 1.5) { x /= 2.0; k++; }
+  while (x < 0.75) { x *= 2.0; k--; }
+  double y = (x - 1.0) / (x + 1.0);
+  double y2 = y * y;
+  double term = y;
+  double sum = 0.0;
+  for (int n = 1; n < 41; n += 2) {
+    sum += term / n;
+    term *= y2;
+  }
+  return 2.0 * sum + k * 0.69314718055994530942;
+}
+
+// Reference Beta-equation in hundredths of a degree, for compile-time use
+constexpr double ntcCelsiusAtCounts(int32_t counts) {
+  double voltage = counts * ADS1115_VOLTS_PER_COUNT;
+  double r_ntc = (voltage * R_FIXED) / (VCC - voltage);
+  double invT = (1.0 / T0) + (1.0 / BETA) * ntcLn(r_ntc / R0);
+  return 1.0 / invT - 273.15;
+}
+
+constexpr int16_t ntcTableEntry(int32_t counts) {
+  // Table ends lie outside the divider's valid range; pin them just inside
+  if (counts < 1) counts = 1;
+  if (counts > NTC_VCC_COUNTS - 1) counts = NTC_VCC_COUNTS - 1;
+  double centi = ntcCelsiusAtCounts(counts) * 100.0;
+  if (centi > 32767.0) return 32767;
+  if (centi < -32767.0) return -32767;
+  return (int16_t)(centi >= 0 ? centi + 0.5 : centi - 0.5);
+}
+
+struct NTCTable {
+  int16_t centi[NTC_LUT_SIZE];
+};
+
+constexpr NTCTable buildNTCTable() {
+  NTCTable table = {};
+  for (int32_t i = 0; i < NTC_LUT_SIZE; i++) {
+    table.centi[i] = ntcTableEntry(i * NTC_LUT_STEP);
+  }
+  return table;
+}
+
+// Function declarations
+int16_t ntcCountsToCentiCelsius(int16_t counts);
+uint16_t moistureCountsToCentiPercent(int32_t counts, int32_t dry, int32_t wet);
+
+#endif
\ No newline at end of file
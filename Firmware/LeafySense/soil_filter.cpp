@@ -0,0 +1,85 @@
+#include "soil_filter.h"
+
+#if SOIL_FILTER_MEDIAN_SIZE < 1 || SOIL_FILTER_MEDIAN_SIZE > 7 || (SOIL_FILTER_MEDIAN_SIZE % 2) == 0
+#error "SOIL_FILTER_MEDIAN_SIZE must be an odd number between 1 and 7"
+#endif
+
+#if SOIL_FILTER_OVERSAMPLE < 1 || SOIL_FILTER_OVERSAMPLE > 64
+#error "SOIL_FILTER_OVERSAMPLE must be between 1 and 64"
+#endif
+
+#if SOIL_FILTER_EMA_ALPHA < 1 || SOIL_FILTER_EMA_ALPHA > 256
+#error "SOIL_FILTER_EMA_ALPHA must be between 1 and 256"
+#endif
+
+void resetSoilFilter(SoilChannelFilter& filter) {
+  for (uint8_t i = 0; i < SOIL_FILTER_MEDIAN_SIZE; i++) {
+    filter.window[i] = 0;
+  }
+  filter.windowHead = 0;
+  filter.windowCount = 0;
+  filter.oversampleSum = 0;
+  filter.oversampleCount = 0;
+  filter.ema_q8 = 0;
+  filter.ready = false;
+}
+
+// Median of the samples currently in the window (insertion sort, k <= 7)
+static int16_t windowMedian(const SoilChannelFilter& filter) {
+  int16_t sorted[SOIL_FILTER_MEDIAN_SIZE];
+  uint8_t n = filter.windowCount;
+  
+  for (uint8_t i = 0; i < n; i++) {
+    int16_t v = filter.window[i];
+    int8_t j = i - 1;
+    while (j >= 0 && sorted[j] > v) {
+      sorted[j + 1] = sorted[j];
+      j--;
+    }
+    sorted[j + 1] = v;
+  }
+  
+  return sorted[n / 2];
+}
+
+// Feed one raw conversion through the pipeline. Returns true when a new
+// decimated sample reached the EMA stage (every SOIL_FILTER_OVERSAMPLE calls).
+bool soilFilterAddSample(SoilChannelFilter& filter, int16_t raw) {
+  // Stage 1: median-of-k spike rejection
+  filter.window[filter.windowHead] = raw;
+  filter.windowHead = (filter.windowHead + 1) % SOIL_FILTER_MEDIAN_SIZE;
+  if (filter.windowCount < SOIL_FILTER_MEDIAN_SIZE) {
+    filter.windowCount++;
+  }
+  int16_t median = windowMedian(filter);
+  
+  // Stage 2: oversampling and decimation
+  filter.oversampleSum += median;
+  filter.oversampleCount++;
+  if (filter.oversampleCount < SOIL_FILTER_OVERSAMPLE) {
+    return false;
+  }
+  
+  int32_t decimated_q8 = (filter.oversampleSum * 256) / SOIL_FILTER_OVERSAMPLE;
+  filter.oversampleSum = 0;
+  filter.oversampleCount = 0;
+  
+  // Stage 3: IIR exponential moving average (first output primes the state)
+  if (!filter.ready) {
+    filter.ema_q8 = decimated_q8;
+    filter.ready = true;
+  } else {
+    int64_t delta = (int64_t)(decimated_q8 - filter.ema_q8) * SOIL_FILTER_EMA_ALPHA;
+    filter.ema_q8 += (int32_t)(delta / 256);
+  }
+  
+  return true;
+}
+
+// Latest smoothed value in ADC counts, rounded to the nearest count
+int16_t soilFilterValue(const SoilChannelFilter& filter) {
+  if (filter.ema_q8 >= 0) {
+    return (int16_t)((filter.ema_q8 + 128) / 256);
+  }
+  return (int16_t)((filter.ema_q8 - 128) / 256);
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+// soil_filter.h
+#ifndef SOIL_FILTER_H
+#define SOIL_FILTER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Per-channel filter state: raw ADC -> median-of-k -> oversample/decimate -> EMA
+// Everything lives in fixed-size arrays, nothing is allocated on the heap.
+struct SoilChannelFilter {
+  int16_t window[SOIL_FILTER_MEDIAN_SIZE];  // Ring buffer for spike rejection
+  uint8_t windowHead;
+  uint8_t windowCount;
+  int32_t oversampleSum;                    // Accumulated median outputs
+  uint8_t oversampleCount;
+  int32_t ema_q8;                           // EMA state, 8 fractional bits
+  bool ready;                               // At least one decimated output
+};
+
+// Function declarations
+void resetSoilFilter(SoilChannelFilter& filter);
+bool soilFilterAddSample(SoilChannelFilter& filter, int16_t raw);
+int16_t soilFilterValue(const SoilChannelFilter& filter);
+
+#endif
\ No newline at end of file
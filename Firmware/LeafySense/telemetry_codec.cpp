@@ -0,0 +1,259 @@
+#include "telemetry_codec.h"
+#include <stdio.h>
+#include <string.h>
+
+// Appends into a fixed buffer and remembers if anything did not fit
+struct CodecWriter {
+  uint8_t* buffer;
+  size_t size;
+  size_t length;
+  bool overflow;
+};
+
+static void put(CodecWriter& w, const void* data, size_t len) {
+  if (w.overflow || w.length + len > w.size) {
+    w.overflow = true;
+    return;
+  }
+  memcpy(w.buffer + w.length, data, len);
+  w.length += len;
+}
+
+static void putByte(CodecWriter& w, uint8_t b) {
+  put(w, &b, 1);
+}
+
+// ---- JSON ----------------------------------------------------------------
+// Same document shape and keys as the ArduinoJson payload it replaces;
+// fixed-point values are printed with two decimals.
+
+static void putText(CodecWriter& w, const char* text) {
+  put(w, text, strlen(text));
+}
+
+static void putUnsigned(CodecWriter& w, uint32_t value) {
+  char text[12];
+  int len = snprintf(text, sizeof(text), "%lu", (unsigned long)value);
+  put(w, text, len);
+}
+
+static void putSigned(CodecWriter& w, int32_t value) {
+  char text[12];
+  int len = snprintf(text, sizeof(text), "%ld", (long)value);
+  put(w, text, len);
+}
+
+static void putCenti(CodecWriter& w, int32_t centi) {
+  char text[16];
+  uint32_t magnitude = centi < 0 ? -centi : centi;
+  int len = snprintf(text, sizeof(text), "%s%lu.%02lu", centi < 0 ? "-" : "",
+                     (unsigned long)(magnitude / 100), (unsigned long)(magnitude % 100));
+  put(w, text, len);
+}
+
+// ,"key": with the comma left out for the first member of an object
+static void putKey(CodecWriter& w, const char* key, bool first = false) {
+  if (!first) putByte(w, ',');
+  putByte(w, '"');
+  putText(w, key);
+  putText(w, "\":");
+}
+
+size_t encodeTelemetryJSON(const TelemetryFrame& frame, char* buffer, size_t size) {
+  if (size == 0) return 0;
+  CodecWriter w = {(uint8_t*)buffer, size - 1, 0, false};  // Room for the terminator
+  
+  char mac[18];
+  snprintf(mac, sizeof(mac), "%02X:%02X:%02X:%02X:%02X:%02X",
+           frame.mac[0], frame.mac[1], frame.mac[2], frame.mac[3], frame.mac[4], frame.mac[5]);
+  
+  putByte(w, '{');
+  putKey(w, "device_id", true);
+  putByte(w, '"'); putText(w, mac); putByte(w, '"');
+  if (frame.logged) {
+    putKey(w, "seq"); putUnsigned(w, frame.sequence);
+  }
+  putKey(w, "timestamp");
+  putByte(w, '"'); putText(w, frame.timestamp); putByte(w, '"');
+  
+  if (frame.air_valid) {
+    putKey(w, "air");
+    putByte(w, '{');
+    putKey(w, "temperature", true); putCenti(w, frame.air_temperature_centi);
+    putKey(w, "humidity"); putCenti(w, frame.air_humidity_centi);
+    putByte(w, '}');
+  }
+  
+  putKey(w, "soil");
+  putByte(w, '{');
+  for (uint8_t i = 0; i < frame.probe_count; i++) {
+    const TelemetryProbe& probe = frame.probes[i];
+    char key[12];
+    snprintf(key, sizeof(key), "sensor%u", probe.index + 1);
+    putKey(w, key, i == 0);
+    putByte(w, '{');
+    putKey(w, "moisture", true); putCenti(w, probe.moisture_centi);
+    putKey(w, "temperature"); putCenti(w, probe.temperature_centi);
+    putKey(w, "moisture_raw"); putSigned(w, probe.moisture_raw);
+    putKey(w, "temp_raw"); putSigned(w, probe.temp_raw);
+    putByte(w, '}');
+  }
+  putByte(w, '}');
+  
+  // Logged samples have no system stats
+  if (!frame.logged) {
+    putKey(w, "wifi_rssi"); putSigned(w, frame.wifi_rssi);
+    putKey(w, "free_heap"); putUnsigned(w, frame.free_heap);
+    
+    putKey(w, "memory");
+    putByte(w, '{');
+    putKey(w, "min_free_heap", true); putUnsigned(w, frame.min_free_heap);
+    putKey(w, "largest_block"); putUnsigned(w, frame.largest_block);
+    putKey(w, "min_largest_block"); putUnsigned(w, frame.min_largest_block);
+    putKey(w, "alloc_failures"); putUnsigned(w, frame.alloc_failures);
+    putKey(w, "loop_stack_free"); putUnsigned(w, frame.loop_stack_free);
+    putKey(w, "warnings"); putUnsigned(w, frame.memory_warnings);
+    putByte(w, '}');
+    
+    putKey(w, "mqtt");
+    putByte(w, '{');
+    putKey(w, "queue_depth", true); putUnsigned(w, frame.queue_depth);
+    putKey(w, "delivered"); putUnsigned(w, frame.delivered);
+    putKey(w, "dropped"); putUnsigned(w, frame.dropped);
+    putKey(w, "retransmits"); putUnsigned(w, frame.retransmits);
+    putKey(w, "ack_ms"); putUnsigned(w, frame.ack_ms);
+    putKey(w, "ack_ms_max"); putUnsigned(w, frame.ack_ms_max);
+    putByte(w, '}');
+  }
+  putByte(w, '}');
+  
+  if (w.overflow) return 0;
+  buffer[w.length] = '\0';
+  return w.length;
+}
+
+// ---- CBOR (RFC 8949) -----------------------------------------------------
+
+#define CBOR_UNSIGNED 0
+#define CBOR_NEGATIVE 1
+#define CBOR_BYTES 2
+#define CBOR_ARRAY 4
+#define CBOR_MAP 5
+
+// Initial byte plus the shortest argument encoding
+static void cborHead(CodecWriter& w, uint8_t major, uint32_t value) {
+  uint8_t type = major << 5;
+  if (value < 24) {
+    putByte(w, type | value);
+  } else if (value <= 0xFF) {
+    putByte(w, type | 24);
+    putByte(w, value);
+  } else if (value <= 0xFFFF) {
+    uint8_t bytes[3] = {(uint8_t)(type | 25), (uint8_t)(value >> 8), (uint8_t)value};
+    put(w, bytes, sizeof(bytes));
+  } else {
+    uint8_t bytes[5] = {(uint8_t)(type | 26), (uint8_t)(value >> 24), (uint8_t)(value >> 16),
+                        (uint8_t)(value >> 8), (uint8_t)value};
+    put(w, bytes, sizeof(bytes));
+  }
+}
+
+static void cborInt(CodecWriter& w, int32_t value) {
+  if (value >= 0) {
+    cborHead(w, CBOR_UNSIGNED, value);
+  } else {
+    cborHead(w, CBOR_NEGATIVE, (uint32_t)(-1 - value));
+  }
+}
+
+size_t encodeTelemetryCBOR(const TelemetryFrame& frame, uint8_t* buffer, size_t size) {
+  CodecWriter w = {buffer, size, 0, false};
+  
+  uint8_t entries = 3 + (frame.epoch != 0) + frame.air_valid + (frame.logged ? 1 : 3);
+  cborHead(w, CBOR_MAP, entries);
+  
+  cborHead(w, CBOR_UNSIGNED, TELEMETRY_KEY_SCHEMA);
+  cborHead(w, CBOR_UNSIGNED, TELEMETRY_SCHEMA_VERSION);
+  
+  cborHead(w, CBOR_UNSIGNED, TELEMETRY_KEY_MAC);
+  cborHead(w, CBOR_BYTES, sizeof(frame.mac));
+  put(w, frame.mac, sizeof(frame.mac));
+  
+  if (frame.epoch != 0) {
+    cborHead(w, CBOR_UNSIGNED, TELEMETRY_KEY_EPOCH);
+    cborHead(w, CBOR_UNSIGNED, frame.epoch);
+  }
+  
+  if (frame.air_valid) {
+    cborHead(w, CBOR_UNSIGNED, TELEMETRY_KEY_AIR);
+    cborHead(w, CBOR_ARRAY, 2);
+    cborInt(w, frame.air_temperature_centi);
+    cborHead(w, CBOR_UNSIGNED, frame.air_humidity_centi);
+  }
+  
+  cborHead(w, CBOR_UNSIGNED, TELEMETRY_KEY_SOIL);
+  cborHead(w, CBOR_ARRAY, frame.probe_count);
+  for (uint8_t i = 0; i < frame.probe_count; i++) {
+    const TelemetryProbe& probe = frame.probes[i];
+    cborHead(w, CBOR_ARRAY, 5);
+    cborHead(w, CBOR_UNSIGNED, probe.index);
+    cborHead(w, CBOR_UNSIGNED, probe.moisture_centi);
+    cborInt(w, probe.temperature_centi);
+    cborInt(w, probe.moisture_raw);
+    cborInt(w, probe.temp_raw);
+  }
+  
+  if (frame.logged) {
+    cborHead(w, CBOR_UNSIGNED, TELEMETRY_KEY_SEQUENCE);
+    cborHead(w, CBOR_UNSIGNED, frame.sequence);
+  } else {
+    cborHead(w, CBOR_UNSIGNED, TELEMETRY_KEY_RSSI);
+    cborInt(w, frame.wifi_rssi);
+    
+    cborHead(w, CBOR_UNSIGNED, TELEMETRY_KEY_MEMORY);
+    cborHead(w, CBOR_ARRAY, 7);
+    cborHead(w, CBOR_UNSIGNED, frame.free_heap);
+    cborHead(w, CBOR_UNSIGNED, frame.min_free_heap);
+    cborHead(w, CBOR_UNSIGNED, frame.largest_block);
+    cborHead(w, CBOR_UNSIGNED, frame.min_largest_block);
+    cborHead(w, CBOR_UNSIGNED, frame.alloc_failures);
+    cborHead(w, CBOR_UNSIGNED, frame.loop_stack_free);
+    cborHead(w, CBOR_UNSIGNED, frame.memory_warnings);
+    
+    cborHead(w, CBOR_UNSIGNED, TELEMETRY_KEY_MQTT);
+    cborHead(w, CBOR_ARRAY, 6);
+    cborHead(w, CBOR_UNSIGNED, frame.queue_depth);
+    cborHead(w, CBOR_UNSIGNED, frame.delivered);
+    cborHead(w, CBOR_UNSIGNED, frame.dropped);
+    cborHead(w, CBOR_UNSIGNED, frame.retransmits);
+    cborHead(w, CBOR_UNSIGNED, frame.ack_ms);
+    cborHead(w, CBOR_UNSIGNED, frame.ack_ms_max);
+  }
+  
+  return w.overflow ? 0 : w.length;
+}
+
+// ---- Info and health -----------------------------------------------------
+
+size_t encodeDeviceInfoJSON(const DeviceInfo& info, char* buffer, size_t size) {
+  int length = snprintf(buffer, size,
+                        "{\"device_id\":\"%02X:%02X:%02X:%02X:%02X:%02X\",\"firmware\":\"%s\",\"probes\":%u,"
+                        "\"sample_interval_ms\":%lu,\"publish_interval_ms\":%lu,"
+                        "\"report_mode\":\"%s\",\"codec\":\"%s\",\"schema\":%u}",
+                        info.mac[0], info.mac[1], info.mac[2], info.mac[3], info.mac[4], info.mac[5],
+                        info.firmware, (unsigned)info.probes, (unsigned long)info.sample_interval_ms,
+                        (unsigned long)info.publish_interval_ms,
+                        info.report_mode == REPORT_MODE_DEADBAND ? "deadband" : "interval",
+                        info.codec == TELEMETRY_CODEC_CBOR ? "cbor" : "json", (unsigned)TELEMETRY_SCHEMA_VERSION);
+  return (length > 0 && (size_t)length < size) ? length : 0;
+}
+
+size_t encodeHealthJSON(const HealthReport& health, char* buffer, size_t size) {
+  int length = snprintf(buffer, size,
+                        "{\"wifi_rssi\":%d,\"uptime_s\":%lu,\"mqtt_connects\":%lu,\"mqtt_failures\":%lu,"
+                        "\"reconnect_ms\":%lu,\"queue_dropped\":%lu,\"retransmits\":%lu}",
+                        (int)health.wifi_rssi, (unsigned long)health.uptime_s, (unsigned long)health.mqtt_connects,
+                        (unsigned long)health.mqtt_failures, (unsigned long)health.reconnect_ms,
+                        (unsigned long)health.queue_dropped, (unsigned long)health.retransmits);
+  return (length > 0 && (size_t)length < size) ? length : 0;
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+// telemetry_codec.h
+#ifndef TELEMETRY_CODEC_H
+#define TELEMETRY_CODEC_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Everything the combined sensors message carries, already in fixed point.
+// Filled by mqtt_manager, encoded by either codec. Plain C++ so the host
+// tools (Tools/) can encode and decode the same frames.
+struct TelemetryProbe {
+  uint8_t index;                 // Registry position (JSON "sensorN" is index + 1)
+  uint16_t moisture_centi;       // centi-%
+  int16_t temperature_centi;     // centi-°C
+  int16_t moisture_raw;          // Filtered ADS1115 counts
+  int16_t temp_raw;
+};
+
+struct TelemetryFrame {
+  uint8_t mac[6];
+  uint32_t epoch;                // Unix time, 0 if the clock is not synced
+  char timestamp[24];            // Local time text, JSON codec only
+  bool air_valid;
+  int16_t air_temperature_centi;
+  uint16_t air_humidity_centi;
+  uint8_t probe_count;           // Working probes in probes[]
+  TelemetryProbe probes[MAX_SOIL_PROBES];
+  int8_t wifi_rssi;
+  // Memory block
+  uint32_t free_heap;
+  uint32_t min_free_heap;
+  uint32_t largest_block;
+  uint32_t min_largest_block;
+  uint32_t alloc_failures;
+  uint32_t loop_stack_free;
+  uint8_t memory_warnings;
+  // MQTT delivery block
+  uint8_t queue_depth;
+  uint32_t delivered;
+  uint32_t dropped;
+  uint32_t retransmits;
+  uint32_t ack_ms;
+  uint32_t ack_ms_max;
+  // Backlog replay (sample_log.h)
+  bool logged;                   // Replayed from the sample log: no RSSI, memory or MQTT block
+  uint32_t sequence;             // Sample log position, logged frames only
+};
+
+// CBOR layout, schema 1. Top level is a map with integer keys; nested
+// blocks are positional arrays whose order is fixed by the schema:
+//   0: schema version
+//   1: MAC address (6-byte byte string)
+//   2: epoch seconds (omitted while the clock is not synced)
+//   3: air    [temperature centi-°C, humidity centi-%] (omitted if invalid)
+//   4: soil   [[index, moisture centi-%, temperature centi-°C, moisture raw, temp raw], ...]
+//   5: WiFi RSSI (dBm)
+//   6: memory [free, min free, largest block, min largest block, failed allocs, loop stack free, warnings]
+//   7: mqtt   [queue depth, delivered, dropped, retransmits, ack ms, ack ms max]
+//   8: sample log sequence (logged frames only, which omit keys 5-7)
+// New fields are appended with new keys or at the end of an array; a
+// change to existing positions bumps the schema version.
+#define TELEMETRY_SCHEMA_VERSION 1
+
+enum TelemetryKey {
+  TELEMETRY_KEY_SCHEMA = 0,
+  TELEMETRY_KEY_MAC = 1,
+  TELEMETRY_KEY_EPOCH = 2,
+  TELEMETRY_KEY_AIR = 3,
+  TELEMETRY_KEY_SOIL = 4,
+  TELEMETRY_KEY_RSSI = 5,
+  TELEMETRY_KEY_MEMORY = 6,
+  TELEMETRY_KEY_MQTT = 7,
+  TELEMETRY_KEY_SEQUENCE = 8
+};
+
+// Retained <prefix>/<device>/info document, sent once per session and
+// again when the cadence changes
+struct DeviceInfo {
+  uint8_t mac[6];
+  const char* firmware;
+  uint8_t probes;
+  uint32_t sample_interval_ms;
+  uint32_t publish_interval_ms;  // Heartbeat in deadband mode
+  uint8_t report_mode;           // REPORT_MODE_*
+  uint8_t codec;                 // TELEMETRY_CODEC_*
+};
+
+// <prefix>/<device>/health document, every MQTT_HEALTH_INTERVAL
+struct HealthReport {
+  int8_t wifi_rssi;
+  uint32_t uptime_s;
+  uint32_t mqtt_connects;
+  uint32_t mqtt_failures;
+  uint32_t reconnect_ms;         // Last reconnect
+  uint32_t queue_dropped;
+  uint32_t retransmits;
+};
+
+// Function declarations. All return the encoded length, or 0 if the
+// buffer is too small. Info and health are always JSON.
+size_t encodeTelemetryJSON(const TelemetryFrame& frame, char* buffer, size_t size);
+size_t encodeTelemetryCBOR(const TelemetryFrame& frame, uint8_t* buffer, size_t size);
+size_t encodeDeviceInfoJSON(const DeviceInfo& info, char* buffer, size_t size);
+size_t encodeHealthJSON(const HealthReport& health, char* buffer, size_t size);
+
+#endif
\ No newline at end of file
@@ -1,184 +1,98 @@
 // wifi_manager.cpp
 #include "wifi_manager.h"
 #include "config.h"
-#include "aht20_sensor.h"
-#include "ads1115_sensor.h"
+#include "mqtt_manager.h"
 #include "ntp_time.h"
+#include "sensor_api.h"
+#include "history_api.h"
+#include "portal_html.h"
+#include <ArduinoJson.h>
 #include <Arduino.h>
 
-// Web server and DNS
-WebServer server(80);
+// Web server and DNS. Requests are handled on the AsyncTCP task as they
+// arrive, independent of the loop() cadence.
+AsyncWebServer server(WEB_SERVER_PORT);
 DNSServer dnsServer;
 Preferences preferences;
 
 WiFiConfig wifiConfig;
 
-const char* captivePortalHTML = R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-    <title>Smart Garden Setup</title>
-    <meta name="viewport" content="width=device-width, initial-scale=1">
-    <style>
-        body { font-family: Arial; margin: 40px; background: #f0f0f0; }
-        .container { background: white; padding: 20px; border-radius: 10px; }
-        input { width: 100%; padding: 10px; margin: 5px 0; box-sizing: border-box; }
-        button { background: #4CAF50; color: white; padding: 10px; border: none; width: 100%; margin: 10px 0; }
-        .info { background: #e6f7ff; padding: 10px; border-radius: 5px; margin: 10px 0; }
-        .sensor-data { background: #f9f9f9; padding: 15px; border-radius: 5px; margin: 10px 0; border: 1px solid #ddd; }
-        table { width: 100%; border-collapse: collapse; }
-        td { padding: 8px; border-bottom: 1px solid #eee; }
-        .status-online { color: green; font-weight: bold; }
-        .status-offline { color: red; font-weight: bold; }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <h2>🌱 Smart Garden Setup</h2>
-        
-        <div class="sensor-data">
-            <h3>📊 Live Sensor Data</h3>
-            <div id="sensorData">Loading sensor data...</div>
-        </div>
-        
-        <form action="/save" method="POST">
-            <h3>WiFi Configuration</h3>
-            <input type="text" name="ssid" placeholder="WiFi SSID" value="%SSID%" required>
-            <input type="password" name="password" placeholder="WiFi Password" required>
-            
-            <h3>Device Name</h3>
-            <input type="text" name="deviceName" placeholder="Device Name" value="%DEVICENAME%">
-            
-            <h3>MQTT Configuration (Optional)</h3>
-            <input type="text" name="mqttServer" placeholder="MQTT Server (e.g., 192.168.1.100)" value="%MQTT_SERVER%">
-            <input type="number" name="mqttPort" placeholder="MQTT Port (default: 1883)" value="%MQTT_PORT%">
-            <input type="text" name="mqttUser" placeholder="MQTT Username (optional)" value="%MQTT_USER%">
-            <input type="password" name="mqttPassword" placeholder="MQTT Password (optional)" value="%MQTT_PASSWORD%">
-            <input type="text" name="mqttTopic" placeholder="MQTT Topic Prefix" value="%MQTT_TOPIC%">
-            
-            <button type="submit">Save & Connect</button>
-        </form>
-        
-        <div class="info">
-            <strong>Device ID:</strong> %DEVICE_ID%<br>
-            <strong>MAC Address:</strong> %MAC_ADDRESS%
-        </div>
-    </div>
-    
-    <script>
-        function updateSensorData() {
-            fetch('/sensor-data')
-                .then(response => response.text())
-                .then(data => {
-                    document.getElementById('sensorData').innerHTML = data;
-                })
-                .catch(error => {
-                    document.getElementById('sensorData').innerHTML = 'Error loading sensor data';
-                });
-        }
-        
-        // Update sensor data every 5 seconds
-        setInterval(updateSensorData, 5000);
-        updateSensorData(); // Initial load
-    </script>
-</body>
-</html>
-)rawliteral";
-
-String formatHTMLWithValues(const String& html) {
-    String result = html;
-    result.replace("%SSID%", wifiConfig.ssid);
-    result.replace("%DEVICENAME%", wifiConfig.deviceName);
-    result.replace("%MQTT_SERVER%", wifiConfig.mqttServer);
-    result.replace("%MQTT_PORT%", String(wifiConfig.mqttPort));
-    result.replace("%MQTT_USER%", wifiConfig.mqttUser);
-    result.replace("%MQTT_PASSWORD%", wifiConfig.mqttPassword);
-    result.replace("%MQTT_TOPIC%", MQTT_TOPIC_PREFIX);
-    
-    String deviceId = String(WiFi.macAddress());
-    deviceId.replace(":", "");
-    result.replace("%DEVICE_ID%", deviceId);
-    result.replace("%MAC_ADDRESS%", WiFi.macAddress());
-    
-    return result;
+// Restart requested by /save, carried out from the loop task
+static volatile bool restartScheduled = false;
+static unsigned long restartAt = 0;
+
+// Portal page: static, gzipped in flash (portal_html.h, built from
+// web/portal.html). Saved settings are filled in client-side from
+// /api/v1/config, so a hit never copies or rewrites the document.
+static void sendPortalPage(AsyncWebServerRequest* request) {
+    if (request->hasHeader("If-None-Match") && request->header("If-None-Match") == PORTAL_HTML_ETAG) {
+        AsyncWebServerResponse* response = request->beginResponse(304, "text/html", "");
+        response->addHeader("ETag", PORTAL_HTML_ETAG);
+        request->send(response);
+        return;
+    }
+    
+    AsyncWebServerResponse* response = request->beginResponse(200, "text/html", PORTAL_HTML_GZ, PORTAL_HTML_GZ_LENGTH);
+    response->addHeader("Content-Encoding", "gzip");
+    response->addHeader("ETag", PORTAL_HTML_ETAG);
+    response->addHeader("Cache-Control", "no-cache");  // Revalidate, the 304 is cheap
+    request->send(response);
 }
 
-void handleRoot() {
-    String html = formatHTMLWithValues(captivePortalHTML);
-    server.send(200, "text/html", html);
+void handleRoot(AsyncWebServerRequest* request) {
+    sendPortalPage(request);
 }
 
-void handleSensorData() {
-    String html = "<table>";
+// The values the old template substituted into the page
+void handleConfig(AsyncWebServerRequest* request) {
+    StaticJsonDocument<768> doc;
+    doc["ssid"] = wifiConfig.ssid;
+    doc["deviceName"] = wifiConfig.deviceName;
+    doc["mqttServer"] = wifiConfig.mqttServer;
+    doc["mqttPort"] = wifiConfig.mqttPort;
+    doc["mqttUser"] = wifiConfig.mqttUser;
+    doc["mqttPassword"] = wifiConfig.mqttPassword;
+    doc["mqttTopic"] = MQTT_TOPIC_PREFIX;
+    doc["staticIP"] = wifiConfig.staticIP;
+    doc["gateway"] = wifiConfig.gateway;
+    doc["subnet"] = wifiConfig.subnet;
+    doc["dns"] = wifiConfig.dns;
     
-    // Add current time
-    DateTime currentTime = getCurrentTime();
-    html += "<tr><td><strong>Time:</strong></td><td>" + currentTime.timestamp + "</td></tr>";
-    
-    // Add AHT20 data
-    AHT20_Data ahtData = readAHT20();
-    if (ahtData.sensor_found && ahtData.last_error.isEmpty()) {
-        html += "<tr><td><strong>Air Temperature:</strong></td><td>" + String(ahtData.temperature, 1) + " °C</td></tr>";
-        html += "<tr><td><strong>Air Humidity:</strong></td><td>" + String(ahtData.humidity, 1) + " %</td></tr>";
-        html += "<tr><td><strong>Air Sensor:</strong></td><td class='status-online'>✅ Working</td></tr>";
-    } else {
-        html += "<tr><td><strong>Air Sensor:</strong></td><td class='status-offline'>❌ " + ahtData.last_error + "</td></tr>";
-    }
-    
-    // Add ADS1115 data
-    ADS1115_Data soilData = readAllSoilSensors();
-    if (soilData.ads1115_found) {
-        html += "<tr><td><strong>Soil Sensor:</strong></td><td class='status-online'>✅ Working</td></tr>";
-        
-        if (soilData.sensor1.sensor_working) {
-            html += "<tr><td><strong>Soil 1 Moisture:</strong></td><td>" + String(soilData.sensor1.moisture_percentage, 1) + " %</td></tr>";
-            html += "<tr><td><strong>Soil 1 Temperature:</strong></td><td>" + String(soilData.sensor1.temperature_celsius, 1) + " °C</td></tr>";
-        } else {
-            html += "<tr><td><strong>Soil Sensor 1:</strong></td><td class='status-offline'>❌ " + soilData.sensor1.last_error + "</td></tr>";
-        }
-        
-        if (soilData.sensor2.sensor_working) {
-            html += "<tr><td><strong>Soil 2 Moisture:</strong></td><td>" + String(soilData.sensor2.moisture_percentage, 1) + " %</td></tr>";
-            html += "<tr><td><strong>Soil 2 Temperature:</strong></td><td>" + String(soilData.sensor2.temperature_celsius, 1) + " °C</td></tr>";
-        } else {
-            html += "<tr><td><strong>Soil Sensor 2:</strong></td><td class='status-offline'>❌ " + soilData.sensor2.last_error + "</td></tr>";
-        }
-    } else {
-        html += "<tr><td><strong>Soil Sensor:</strong></td><td class='status-offline'>❌ " + soilData.last_error + "</td></tr>";
-    }
-    
-    // Add WiFi info
-    html += "<tr><td><strong>WiFi RSSI:</strong></td><td>" + String(WiFi.RSSI()) + " dBm</td></tr>";
-    if (WiFi.status() == WL_CONNECTED) {
-        html += "<tr><td><strong>IP Address:</strong></td><td>" + WiFi.localIP().toString() + "</td></tr>";
-    } else {
-        html += "<tr><td><strong>Network:</strong></td><td class='status-offline'>Captive Portal Mode</td></tr>";
-    }
-    
-    // Add memory info
-    html += "<tr><td><strong>Free Memory:</strong></td><td>" + String(ESP.getFreeHeap()) + " bytes</td></tr>";
-    
-    html += "</table>";
+    String mac = WiFi.macAddress();
+    doc["macAddress"] = mac;
+    mac.replace(":", "");
+    doc["deviceId"] = mac;
     
-    server.send(200, "text/html", html);
+    AsyncResponseStream* response = request->beginResponseStream("application/json");
+    response->addHeader("Cache-Control", "no-store");
+    serializeJson(doc, *response);
+    request->send(response);
 }
 
-void handleSave() {
+void handleSave(AsyncWebServerRequest* request) {
     // Get form data
-    wifiConfig.ssid = server.arg("ssid");
-    wifiConfig.password = server.arg("password");
-    wifiConfig.deviceName = server.arg("deviceName");
-    wifiConfig.mqttServer = server.arg("mqttServer");
-    wifiConfig.mqttPort = server.arg("mqttPort").toInt();
-    wifiConfig.mqttUser = server.arg("mqttUser");
-    wifiConfig.mqttPassword = server.arg("mqttPassword");
+    wifiConfig.ssid = request->arg("ssid");
+    wifiConfig.password = request->arg("password");
+    wifiConfig.deviceName = request->arg("deviceName");
+    wifiConfig.mqttServer = request->arg("mqttServer");
+    wifiConfig.mqttPort = request->arg("mqttPort").toInt();
+    wifiConfig.mqttUser = request->arg("mqttUser");
+    wifiConfig.mqttPassword = request->arg("mqttPassword");
+    wifiConfig.staticIP = request->arg("staticIP");
+    wifiConfig.gateway = request->arg("gateway");
+    wifiConfig.subnet = request->arg("subnet");
+    wifiConfig.dns = request->arg("dns");
+    
+    // The cached AP and lease belong to the old network
+    wifiConfig.channel = 0;
+    wifiConfig.leaseIP = 0;
     
     // Update global MQTT configuration
     updateMQTTConfigFromWiFiConfig(wifiConfig);
     
     // Save configuration
     if (saveWiFiConfig(wifiConfig)) {
-        server.send(200, "text/html", 
+        request->send(200, "text/html", 
             "<!DOCTYPE html>"
             "<html>"
             "<head>"
@@ -201,10 +115,11 @@ void handleSave() {
             "</html>"
             "<script>setTimeout(function(){ window.location.href = '/'; }, 5000);</script>"
         );
-        delay(2000);
-        ESP.restart();
+        // Restart from loop() once the response has had time to go out
+        restartAt = millis() + WEB_RESTART_DELAY;
+        restartScheduled = true;
     } else {
-        server.send(500, "text/html", 
+        request->send(500, "text/html", 
             "<div style='font-family: Arial; margin: 40px;'>"
             "<div style='background: white; padding: 20px; border-radius: 10px;'>"
             "<h2 style='color: red;'>❌ Error Saving Configuration!</h2>"
@@ -216,16 +131,19 @@ void handleSave() {
     }
 }
 
-void handleNotFound() {
-    server.send(200, "text/html", formatHTMLWithValues(captivePortalHTML));
+void handleNotFound(AsyncWebServerRequest* request) {
+    sendPortalPage(request);
 }
 
 void startWebServer() {
     Serial.println("🌐 Starting Web Server...");
     
     // Setup web server routes
-    server.on("/", handleRoot);
-    server.on("/sensor-data", handleSensorData);
+    server.on("/", HTTP_GET, handleRoot);
+    server.on("/api/v1/sensors", HTTP_GET, handleSensorsAPI);
+    server.on("/sensor-data", HTTP_GET, handleSensorsAPI);  // Pre-API path, kept for existing clients
+    server.on("/api/v1/history", HTTP_GET, handleHistoryAPI);
+    server.on("/api/v1/config", HTTP_GET, handleConfig);
     server.onNotFound(handleNotFound);
     
     server.begin();
@@ -254,6 +172,19 @@ bool loadWiFiConfig() {
     wifiConfig.mqttPort = preferences.getInt("mqttPort", 1883);
     wifiConfig.mqttUser = preferences.getString("mqttUser", "");
     wifiConfig.mqttPassword = preferences.getString("mqttPassword", "");
+    wifiConfig.staticIP = preferences.getString("staticIP", "");
+    wifiConfig.gateway = preferences.getString("gateway", "");
+    wifiConfig.subnet = preferences.getString("subnet", "");
+    wifiConfig.dns = preferences.getString("dns", "");
+    
+    wifiConfig.channel = preferences.getInt("channel", 0);
+    if (preferences.getBytes("bssid", wifiConfig.bssid, sizeof(wifiConfig.bssid)) != sizeof(wifiConfig.bssid)) {
+        wifiConfig.channel = 0;
+    }
+    wifiConfig.leaseIP = preferences.getUInt("leaseIP", 0);
+    wifiConfig.leaseGateway = preferences.getUInt("leaseGateway", 0);
+    wifiConfig.leaseSubnet = preferences.getUInt("leaseSubnet", 0);
+    wifiConfig.leaseDNS = preferences.getUInt("leaseDNS", 0);
     
     preferences.end();
     
@@ -275,6 +206,17 @@ bool saveWiFiConfig(const WiFiConfig& config) {
     preferences.putInt("mqttPort", config.mqttPort);
     preferences.putString("mqttUser", config.mqttUser);
     preferences.putString("mqttPassword", config.mqttPassword);
+    preferences.putString("staticIP", config.staticIP);
+    preferences.putString("gateway", config.gateway);
+    preferences.putString("subnet", config.subnet);
+    preferences.putString("dns", config.dns);
+    
+    preferences.putBytes("bssid", config.bssid, sizeof(config.bssid));
+    preferences.putInt("channel", config.channel);
+    preferences.putUInt("leaseIP", config.leaseIP);
+    preferences.putUInt("leaseGateway", config.leaseGateway);
+    preferences.putUInt("leaseSubnet", config.leaseSubnet);
+    preferences.putUInt("leaseDNS", config.leaseDNS);
     
     preferences.end();
     
@@ -282,58 +224,320 @@ bool saveWiFiConfig(const WiFiConfig& config) {
     Serial.println("   SSID: " + config.ssid);
     Serial.println("   Device Name: " + config.deviceName);
     Serial.println("   MQTT Server: " + config.mqttServer + ":" + String(config.mqttPort));
+    if (!config.staticIP.isEmpty()) {
+        Serial.println("   Static IP: " + config.staticIP);
+    }
     
     return true;
 }
 
+// Station link state, advanced from handleWiFiManagerLoop(). WiFi events
+// arrive on the WiFi driver's task and only set flags; every transition and
+// every service restart happens on the loop task.
+enum WiFiLinkState {
+    WIFI_STATE_IDLE,          // No saved network
+    WIFI_STATE_CONNECTING,    // Association/DHCP in progress
+    WIFI_STATE_CONNECTED,     // Got an IP
+    WIFI_STATE_BACKOFF,       // Waiting before the next attempt
+    WIFI_STATE_PORTAL         // Captive portal owns the radio
+};
+
+#define WIFI_EVENT_FLAG_GOT_IP 0x01
+#define WIFI_EVENT_FLAG_DISCONNECTED 0x02
+
+static WiFiLinkState linkState = WIFI_STATE_IDLE;
+static WiFiConnectionStats linkStats = {};
+static uint32_t pendingEvents = 0;           // WIFI_EVENT_FLAG_*, set by onWiFiEvent()
+static volatile uint8_t disconnectReason = 0;
+static volatile unsigned long gotIPAt = 0;
+static unsigned long bootStartedAt = 0;
+static unsigned long attemptStartedAt = 0;
+static unsigned long nextAttemptAt = 0;
+static unsigned long linkLostAt = 0;
+static bool everConnected = false;
+static bool fastAttempt = false;             // Current attempt joins the cached BSSID/channel
+static bool fastPathFailed = false;          // Cached AP did not work; scan until the next link
+static bool dhcpAttempt = false;             // Current attempt gets its address from DHCP
+static uint32_t fastTimeToIPTotal = 0;
+static uint32_t fullTimeToIPTotal = 0;
+
+// Runs on the WiFi event task: record what happened and return
+static void onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
+    switch (event) {
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            gotIPAt = millis();
+            __atomic_fetch_or(&pendingEvents, WIFI_EVENT_FLAG_GOT_IP, __ATOMIC_RELAXED);
+            break;
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            disconnectReason = info.wifi_sta_disconnected.reason;
+            __atomic_fetch_or(&pendingEvents, WIFI_EVENT_FLAG_DISCONNECTED, __ATOMIC_RELAXED);
+            break;
+        case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+            __atomic_fetch_or(&pendingEvents, WIFI_EVENT_FLAG_DISCONNECTED, __ATOMIC_RELAXED);
+            break;
+        default:
+            break;
+    }
+}
+
+// Static address from the portal, else the last DHCP lease on a fast join,
+// else DHCP
+static void applyIPConfig(bool reuseLease) {
+    IPAddress ip, gateway, subnet, dns;
+    dhcpAttempt = false;
+
+    if (!wifiConfig.staticIP.isEmpty() && ip.fromString(wifiConfig.staticIP.c_str())) {
+        gateway.fromString(wifiConfig.gateway.c_str());
+        if (!subnet.fromString(wifiConfig.subnet.c_str())) {
+            subnet = IPAddress(255, 255, 255, 0);
+        }
+        if (!dns.fromString(wifiConfig.dns.c_str())) {
+            dns = gateway;
+        }
+        WiFi.config(ip, gateway, subnet, dns);
+    } else if (reuseLease && wifiConfig.leaseIP != 0) {
+        WiFi.config(IPAddress(wifiConfig.leaseIP), IPAddress(wifiConfig.leaseGateway),
+                    IPAddress(wifiConfig.leaseSubnet), IPAddress(wifiConfig.leaseDNS));
+    } else {
+        // All zero turns the DHCP client back on
+        WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));
+        dhcpAttempt = true;
+    }
+}
+
+static void startConnectAttempt() {
+    linkState = WIFI_STATE_CONNECTING;
+    linkStats.attempts++;
+    attemptStartedAt = millis();
+
+    fastAttempt = WIFI_FAST_RECONNECT && wifiConfig.channel > 0 && !fastPathFailed;
+    applyIPConfig(fastAttempt && WIFI_REUSE_DHCP_LEASE);
+    if (fastAttempt) {
+        // No scan: straight to the AP that worked last time
+        WiFi.begin(wifiConfig.ssid.c_str(), wifiConfig.password.c_str(), wifiConfig.channel, wifiConfig.bssid);
+    } else {
+        WiFi.begin(wifiConfig.ssid.c_str(), wifiConfig.password.c_str());
+    }
+}
+
+// Remembers the AP, and the lease if DHCP handed one out, when they changed
+static void updateLinkCache() {
+    uint8_t* bssid = WiFi.BSSID();
+    int32_t channel = WiFi.channel();
+    bool apChanged = bssid && (channel != wifiConfig.channel || memcmp(bssid, wifiConfig.bssid, sizeof(wifiConfig.bssid)) != 0);
+    bool leaseChanged = dhcpAttempt && (uint32_t)WiFi.localIP() != wifiConfig.leaseIP;
+    if (!apChanged && !leaseChanged) return;
+
+    preferences.begin("wifi-config", false);
+    if (apChanged) {
+        memcpy(wifiConfig.bssid, bssid, sizeof(wifiConfig.bssid));
+        wifiConfig.channel = channel;
+        preferences.putBytes("bssid", wifiConfig.bssid, sizeof(wifiConfig.bssid));
+        preferences.putInt("channel", wifiConfig.channel);
+    }
+    if (leaseChanged) {
+        wifiConfig.leaseIP = WiFi.localIP();
+        wifiConfig.leaseGateway = WiFi.gatewayIP();
+        wifiConfig.leaseSubnet = WiFi.subnetMask();
+        wifiConfig.leaseDNS = WiFi.dnsIP(0);
+        preferences.putUInt("leaseIP", wifiConfig.leaseIP);
+        preferences.putUInt("leaseGateway", wifiConfig.leaseGateway);
+        preferences.putUInt("leaseSubnet", wifiConfig.leaseSubnet);
+        preferences.putUInt("leaseDNS", wifiConfig.leaseDNS);
+    }
+    preferences.end();
+
+    Serial.println("💾 Cached WiFi link: " + WiFi.BSSIDstr() + " on channel " + String(wifiConfig.channel) +
+                   (leaseChanged ? ", lease " + WiFi.localIP().toString() : String("")));
+}
+
+// Schedules the next attempt after a jittered, exponentially growing delay
+static void connectAttemptFailed(const char* reason) {
+    linkState = WIFI_STATE_BACKOFF;
+    linkStats.failures++;
+
+    // A stale cache is not a reason to back off: scan right away
+    if (fastAttempt) {
+        fastPathFailed = true;
+        linkStats.fast_fallbacks++;
+        nextAttemptAt = millis();
+        Serial.printf("⚠️ WiFi fast join failed (%s), falling back to a full scan\n", reason);
+        return;
+    }
+
+    uint32_t backoff = linkStats.backoff_ms;
+    uint32_t jitter = backoff * WIFI_RECONNECT_JITTER_PCT / 100;
+    uint32_t delayMs = backoff - jitter + (jitter > 0 ? esp_random() % (2 * jitter + 1) : 0);
+    nextAttemptAt = millis() + delayMs;
+    linkStats.backoff_ms = min<uint32_t>(backoff * 2, WIFI_RECONNECT_MAX_MS);
+
+    Serial.printf("⚠️ WiFi connect failed (%s), retry in %lu ms\n", reason, (unsigned long)delayMs);
+}
+
+// Got an IP: bring the network services up for this link
+static void linkUp() {
+    linkState = WIFI_STATE_CONNECTED;
+    linkStats.connects++;
+    linkStats.backoff_ms = WIFI_RECONNECT_MIN_MS;
+
+    uint32_t timeToIP = gotIPAt - attemptStartedAt;
+    linkStats.last_time_to_ip_ms = timeToIP;
+    if (fastAttempt) {
+        linkStats.fast_connects++;
+        fastTimeToIPTotal += timeToIP;
+        linkStats.fast_time_to_ip_ms = fastTimeToIPTotal / linkStats.fast_connects;
+    } else {
+        fullTimeToIPTotal += timeToIP;
+        linkStats.full_time_to_ip_ms = fullTimeToIPTotal / (linkStats.connects - linkStats.fast_connects);
+    }
+    fastPathFailed = false;
+    updateLinkCache();
+
+    if (everConnected) {
+        uint32_t outage = millis() - linkLostAt;
+        linkStats.last_outage_ms = outage;
+        linkStats.max_outage_ms = max(linkStats.max_outage_ms, outage);
+        Serial.printf("✅ WiFi reconnected after %lu ms\n", (unsigned long)outage);
+    } else {
+        Serial.println("✅ Connected to WiFi!");
+    }
+    Serial.println("   IP Address: " + WiFi.localIP().toString());
+    Serial.println("   RSSI: " + String(WiFi.RSSI()) + " dBm");
+    Serial.printf("   Time to IP: %lu ms (%s)\n", (unsigned long)timeToIP, fastAttempt ? "cached AP" : "full scan");
+
+    // Start mDNS for smartgarden.local (re-announced on every new link)
+    MDNS.end();
+    if (MDNS.begin("smartgarden")) {
+        Serial.println("✅ mDNS started: http://smartgarden.local");
+    } else {
+        Serial.println("❌ mDNS failed");
+    }
+
+    // Resynchronize the clock; returns immediately, handleNTPSync() finishes it
+    initNTP();
+
+    // START WEB SERVER IN NORMAL MODE (routes once, listener on every new link)
+    if (!everConnected) {
+        startWebServer();
+    } else {
+        server.end();
+        server.begin();
+    }
+
+    // Skip any MQTT backoff left over from the outage
+    if (MQTT_SERVER.length() > 0) {
+        connectMQTT();
+    }
+
+    everConnected = true;
+}
+
+static void linkLost() {
+    linkStats.disconnects++;
+    linkLostAt = millis();
+    Serial.printf("⚠️ WiFi connection lost (reason %u), reconnecting in the background\n", (unsigned)linkStats.last_reason);
+
+    // Retry right away; the backoff only grows if that attempt fails
+    linkState = WIFI_STATE_BACKOFF;
+    nextAttemptAt = linkLostAt;
+}
+
+static void handleWiFiConnection() {
+    uint32_t events = __atomic_exchange_n(&pendingEvents, 0, __ATOMIC_RELAXED);
+    if (events & WIFI_EVENT_FLAG_DISCONNECTED) {
+        linkStats.last_reason = disconnectReason;
+    }
+
+    switch (linkState) {
+        case WIFI_STATE_IDLE:
+        case WIFI_STATE_PORTAL:
+            return;
+
+        case WIFI_STATE_CONNECTED:
+            if (events & WIFI_EVENT_FLAG_DISCONNECTED) {
+                linkLost();
+            }
+            break;
+
+        case WIFI_STATE_CONNECTING:
+            if (events & WIFI_EVENT_FLAG_DISCONNECTED) {
+                char reason[16];
+                snprintf(reason, sizeof(reason), "reason %u", (unsigned)linkStats.last_reason);
+                connectAttemptFailed(reason);
+            } else if (!(events & WIFI_EVENT_FLAG_GOT_IP) &&
+                       millis() - attemptStartedAt >= (fastAttempt ? WIFI_FAST_CONNECT_TIMEOUT : WIFI_CONNECT_TIMEOUT)) {
+                WiFi.disconnect();
+                connectAttemptFailed("timeout");
+            }
+            break;
+
+        case WIFI_STATE_BACKOFF:
+            if ((long)(millis() - nextAttemptAt) >= 0) {
+                startConnectAttempt();
+            }
+            break;
+    }
+
+    if ((events & WIFI_EVENT_FLAG_GOT_IP) && linkState != WIFI_STATE_CONNECTED && WiFi.status() == WL_CONNECTED) {
+        linkUp();
+        return;
+    }
+
+    // Never reached the saved network since boot: fall back to the portal
+    if (!everConnected && millis() - bootStartedAt >= WIFI_BOOT_PORTAL_TIMEOUT) {
+        Serial.println("❌ Failed to connect to saved WiFi");
+        startCaptivePortal();
+    }
+}
+
+// Starts connecting to the saved network and returns; the link comes up
+// (or falls back to the captive portal) from handleWiFiManagerLoop()
 void setupWiFi() {
     Serial.println("📡 Starting WiFi Manager...");
     
     if (loadWiFiConfig() && !wifiConfig.ssid.isEmpty()) {
-        Serial.println("🔌 Attempting to connect to saved WiFi...");
+        Serial.println("🔌 Connecting to saved WiFi in the background...");
         Serial.println("   SSID: " + wifiConfig.ssid);
         Serial.println("   Device Name: " + wifiConfig.deviceName);
         
         WiFi.mode(WIFI_STA);
-        WiFi.begin(wifiConfig.ssid.c_str(), wifiConfig.password.c_str());
+        // Reconnects are paced by the state machine, not the driver
+        WiFi.setAutoReconnect(false);
+        WiFi.onEvent(onWiFiEvent);
         
-        int attempts = 0;
-        while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-            delay(500);
-            Serial.print(".");
-            attempts++;
-        }
-        
-        if (WiFi.status() == WL_CONNECTED) {
-            Serial.println("\n✅ Connected to WiFi!");
-            Serial.println("   IP Address: " + WiFi.localIP().toString());
-            Serial.println("   RSSI: " + String(WiFi.RSSI()) + " dBm");
-            
-            // Start mDNS for smartgarden.local
-            if (MDNS.begin("smartgarden")) {
-                Serial.println("✅ mDNS started: http://smartgarden.local");
-            } else {
-                Serial.println("❌ mDNS failed");
-            }
-            
-            // Initialize NTP if connected to WiFi
-            initNTP();
-            
-            // START WEB SERVER IN NORMAL MODE
-            startWebServer();
-            
-            return;
-        } else {
-            Serial.println("\n❌ Failed to connect to saved WiFi");
-        }
+        linkStats.backoff_ms = WIFI_RECONNECT_MIN_MS;
+        bootStartedAt = millis();
+        startConnectAttempt();
+        return;
     }
     
-    // If no saved config or connection failed, start captive portal
+    // No saved config, start captive portal
     startCaptivePortal();
 }
 
+bool isWiFiConnected() {
+    return linkState == WIFI_STATE_CONNECTED;
+}
+
+const WiFiConnectionStats& getWiFiConnectionStats() {
+    return linkStats;
+}
+
+void printWiFiConnectionStats() {
+    Serial.printf("📶 WiFi link: %lu attempts, %lu failed, %lu connects, %lu drops, last outage %lu ms, max %lu ms\n",
+                  (unsigned long)linkStats.attempts, (unsigned long)linkStats.failures,
+                  (unsigned long)linkStats.connects, (unsigned long)linkStats.disconnects,
+                  (unsigned long)linkStats.last_outage_ms, (unsigned long)linkStats.max_outage_ms);
+    Serial.printf("⏱️ WiFi time to IP: last %lu ms, cached AP avg %lu ms (%lu), full scan avg %lu ms (%lu), %lu fallbacks\n",
+                  (unsigned long)linkStats.last_time_to_ip_ms,
+                  (unsigned long)linkStats.fast_time_to_ip_ms, (unsigned long)linkStats.fast_connects,
+                  (unsigned long)linkStats.full_time_to_ip_ms, (unsigned long)(linkStats.connects - linkStats.fast_connects),
+                  (unsigned long)linkStats.fast_fallbacks);
+}
+
 void startCaptivePortal() {
     Serial.println("🌐 Starting Captive Portal...");
+    linkState = WIFI_STATE_PORTAL;
     
     // Generate unique AP name with MAC address
     String mac = WiFi.macAddress();
@@ -348,9 +552,12 @@ void startCaptivePortal() {
     dnsServer.start(53, "*", WiFi.softAPIP());
     
     // Setup web server routes
-    server.on("/", handleRoot);
+    server.on("/", HTTP_GET, handleRoot);
     server.on("/save", HTTP_POST, handleSave);
-    server.on("/sensor-data", handleSensorData);
+    server.on("/api/v1/sensors", HTTP_GET, handleSensorsAPI);
+    server.on("/sensor-data", HTTP_GET, handleSensorsAPI);  // Pre-API path, kept for existing clients
+    server.on("/api/v1/history", HTTP_GET, handleHistoryAPI);
+    server.on("/api/v1/config", HTTP_GET, handleConfig);
     server.onNotFound(handleNotFound);
     
     server.begin();
@@ -363,7 +570,7 @@ void startCaptivePortal() {
 }
 
 void stopCaptivePortal() {
-    server.stop();
+    server.end();
     dnsServer.stop();
     WiFi.softAPdisconnect(true);
     WiFi.mode(WIFI_STA);
@@ -374,8 +581,14 @@ bool isCaptivePortalRunning() {
 }
 
 void handleWiFiManagerLoop() {
-    // Always handle client requests, whether in captive portal or normal mode
-    server.handleClient();
+    // Advance the station link; never waits on the radio
+    handleWiFiConnection();
+    
+    // HTTP requests are served by the async server; only a restart after
+    // /save has to wait for the loop task
+    if (restartScheduled && (long)(millis() - restartAt) >= 0) {
+        ESP.restart();
+    }
     
     // Only process DNS in captive portal mode
     if (isCaptivePortalRunning()) {
@@ -3,7 +3,7 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
-#include <WebServer.h>
+#include <ESPAsyncWebServer.h>
 #include <DNSServer.h>
 #include <Preferences.h>
 #include <ESPmDNS.h> 
@@ -16,6 +16,35 @@ struct WiFiConfig {
     int mqttPort;
     String mqttUser;
     String mqttPassword;
+    String staticIP;              // Optional, empty = DHCP
+    String gateway;
+    String subnet;
+    String dns;
+    // Last successful link, used to skip the scan and DHCP on the next connect
+    uint8_t bssid[6];
+    int32_t channel;              // 0 = nothing cached
+    uint32_t leaseIP;             // Last DHCP lease, 0 = none
+    uint32_t leaseGateway;
+    uint32_t leaseSubnet;
+    uint32_t leaseDNS;
+};
+
+// Station link counters. An outage runs from the moment a lost link is
+// noticed until the next IP is assigned.
+struct WiFiConnectionStats {
+    uint32_t attempts;            // Association attempts started
+    uint32_t failures;            // Attempts that failed or timed out
+    uint32_t connects;            // Times an IP was obtained
+    uint32_t disconnects;         // Established links that dropped
+    uint32_t backoff_ms;          // Current backoff before jitter
+    uint8_t last_reason;          // Last disconnect reason from the driver
+    uint32_t last_outage_ms;      // Most recent outage
+    uint32_t max_outage_ms;       // Longest outage
+    uint32_t fast_connects;       // Links joined by cached BSSID/channel
+    uint32_t fast_fallbacks;      // Fast joins that failed over to a full scan
+    uint32_t last_time_to_ip_ms;  // Attempt start to IP for the most recent link
+    uint32_t fast_time_to_ip_ms;  // Average over fast joins
+    uint32_t full_time_to_ip_ms;  // Average over joins that scanned
 };
 
 // Function declarations only (no implementations)
@@ -24,6 +53,9 @@ void startCaptivePortal();
 void stopCaptivePortal();
 bool isCaptivePortalRunning();
 void handleWiFiManagerLoop();
+bool isWiFiConnected();
+const WiFiConnectionStats& getWiFiConnectionStats();
+void printWiFiConnectionStats();
 bool loadWiFiConfig();
 bool saveWiFiConfig(const WiFiConfig& config);
 void updateMQTTConfigFromWiFiConfig(const WiFiConfig& config);
@@ -31,13 +63,10 @@ bool testWiFiConnection(const String& ssid, const String& password);
 void startWebServer();
 
 // Web server handler declarations
-void handleRoot();
-void handleSensorData();
-void handleSave();
-void handleNotFound();
-
-// Helper function declarations
-String formatHTMLWithValues(const String& html);
+void handleRoot(AsyncWebServerRequest* request);
+void handleConfig(AsyncWebServerRequest* request);
+void handleSave(AsyncWebServerRequest* request);
+void handleNotFound(AsyncWebServerRequest* request);
 
 extern WiFiConfig wifiConfig;
 
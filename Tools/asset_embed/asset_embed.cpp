@@ -0,0 +1,88 @@
+// asset_embed.cpp - gzip a web asset into a firmware header
+//
+//   build/asset_embed ../Firmware/LeafySense/web/portal.html PORTAL_HTML > ../Firmware/LeafySense/portal_html.h
+//
+// (or `make portal`). The header holds <NAME>_GZ, the gzip stream the web
+// server sends as-is with Content-Encoding: gzip, <NAME>_GZ_LENGTH and
+// <NAME>_ETAG, a strong ETag derived from the compressed bytes. The gzip
+// header carries no timestamp, so the same input always gives the same
+// header and the same ETag.
+
+#include <zlib.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static bool readFile(const char* path, std::vector<uint8_t>& data) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return false;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) data.insert(data.end(), chunk, chunk + n);
+  fclose(f);
+  return true;
+}
+
+static bool gzipBuffer(const std::vector<uint8_t>& input, std::vector<uint8_t>& output) {
+  z_stream stream = {};
+  // windowBits 15 + 16 selects the gzip wrapper; mtime stays 0
+  if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+
+  output.resize(deflateBound(&stream, input.size()));
+  stream.next_in = const_cast<uint8_t*>(input.data());
+  stream.avail_in = input.size();
+  stream.next_out = output.data();
+  stream.avail_out = output.size();
+  int result = deflate(&stream, Z_FINISH);
+  output.resize(stream.total_out);
+  deflateEnd(&stream);
+  return result == Z_STREAM_END;
+}
+
+// FNV-1a, enough to tell two builds of a page apart
+static uint32_t fnv1a(const std::vector<uint8_t>& data) {
+  uint32_t hash = 2166136261u;
+  for (uint8_t b : data) {
+    hash ^= b;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: asset_embed <file> <SYMBOL> > header.h\n");
+    return 2;
+  }
+  const char* path = argv[1];
+  const char* symbol = argv[2];
+
+  std::vector<uint8_t> input, gz;
+  if (!readFile(path, input)) {
+    fprintf(stderr, "cannot read %s\n", path);
+    return 1;
+  }
+  if (!gzipBuffer(input, gz)) {
+    fprintf(stderr, "gzip failed\n");
+    return 1;
+  }
+
+  const char* name = strrchr(path, '/');
+  name = name ? name + 1 : path;
+  std::string guard = "LEAFYSENSE_" + std::string(symbol) + "_H";
+
+  printf("// Generated by Tools/asset_embed from web/%s - do not edit, run `make portal` in Tools/\n", name);
+  printf("// %zu bytes, %zu gzipped\n", input.size(), gz.size());
+  printf("#ifndef %s\n#define %s\n\n#include <Arduino.h>\n\n", guard.c_str(), guard.c_str());
+  printf("#define %s_ETAG \"\\\"%08x\\\"\"\n", symbol, fnv1a(gz));
+  printf("#define %s_GZ_LENGTH %zu\n\n", symbol, gz.size());
+  printf("const uint8_t %s_GZ[] PROGMEM = {", symbol);
+  for (size_t i = 0; i < gz.size(); i++) {
+    printf(i % 16 == 0 ? "\n  0x%02x," : " 0x%02x,", gz[i]);
+  }
+  printf("\n};\n\n#endif");
+  return 0;
+}
@@ -0,0 +1,163 @@
+// broker_standin.cpp - see broker_standin.h
+
+#include "broker_standin.h"
+
+#include <chrono>
+#include <cstring>
+
+uint64_t standInNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool topicMatches(const char* filter, const char* topic) {
+  while (*filter != '\0') {
+    if (*filter == '#') {
+      return true;
+    }
+    if (*filter == '+') {
+      while (*topic != '\0' && *topic != '/') topic++;
+      filter++;
+    } else {
+      if (*filter != *topic) return false;
+      filter++;
+      topic++;
+      continue;
+    }
+  }
+  return *topic == '\0';
+}
+
+BrokerStandIn::BrokerStandIn(size_t capacity)
+    : slots(capacity), head(0), tail(0), running(false), retainedTopics(0), available(true),
+      producerStats(), delivered(0), unrouted(0) {
+  latencyNs.reserve(1 << 20);
+}
+
+BrokerStandIn::~BrokerStandIn() {
+  stop();
+}
+
+void BrokerStandIn::subscribe(const char* filter, StandInHandler handler) {
+  subscriptions.push_back({filter, handler});
+}
+
+void BrokerStandIn::start() {
+  if (running.exchange(true)) return;
+  deliveryThread = std::thread(&BrokerStandIn::deliveryLoop, this);
+}
+
+void BrokerStandIn::stop() {
+  if (!running.exchange(false)) return;
+  deliveryThread.join();
+}
+
+bool BrokerStandIn::connect(const std::string& clientId, const char* willTopic, const char* willPayload) {
+  if (!available) {
+    producerStats.refused++;
+    return false;
+  }
+  Will& will = sessions[clientId];
+  will.topic = willTopic ? willTopic : "";
+  will.payload = willPayload ? willPayload : "";
+  producerStats.connects++;
+  return true;
+}
+
+void BrokerStandIn::disconnect(const std::string& clientId, bool clean) {
+  auto session = sessions.find(clientId);
+  if (session == sessions.end()) return;
+  if (!clean && !session->second.topic.empty()) {
+    producerStats.wills++;
+    publish(session->second.topic.c_str(), session->second.payload.data(), session->second.payload.size(), true);
+  }
+  sessions.erase(session);
+}
+
+// Wills of every session fire when the broker goes down, as they would on
+// keepalive expiry once it came back
+void BrokerStandIn::setAvailable(bool up) {
+  if (!up && available) {
+    std::vector<std::string> clients;
+    clients.reserve(sessions.size());
+    for (const auto& session : sessions) clients.push_back(session.first);
+    for (const auto& client : clients) disconnect(client, false);
+  }
+  available = up;
+}
+
+bool BrokerStandIn::publish(const char* topic, const void* payload, size_t length, bool retain) {
+  size_t topicLength = strlen(topic);
+  if (topicLength >= MQTT_TOPIC_MAX || length > MQTT_BUFFER_SIZE) {
+    producerStats.rejected++;
+    return false;
+  }
+
+  uint64_t slot = tail.load(std::memory_order_relaxed);
+  if (slot - head.load(std::memory_order_acquire) == slots.size()) {
+    producerStats.stalls++;
+    while (slot - head.load(std::memory_order_acquire) == slots.size()) {
+      std::this_thread::yield();
+    }
+  }
+
+  StandInMessage& message = slots[slot % slots.size()];
+  message.published_ns = standInNowNs();
+  message.topic_length = topicLength;
+  message.payload_length = length;
+  message.retained = retain;
+  memcpy(message.topic, topic, topicLength + 1);
+  memcpy(message.payload, payload, length);
+  tail.store(slot + 1, std::memory_order_release);
+
+  producerStats.published++;
+  producerStats.bytes += topicLength + length;
+  return true;
+}
+
+void BrokerStandIn::deliver(const StandInMessage& message) {
+  if (message.retained) {
+    std::string& stored = retained[std::string(message.topic, message.topic_length)];
+    stored.assign((const char*)message.payload, message.payload_length);
+    retainedTopics.store(retained.size(), std::memory_order_relaxed);
+  }
+
+  bool routed = false;
+  for (const Subscription& subscription : subscriptions) {
+    if (topicMatches(subscription.filter.c_str(), message.topic)) {
+      subscription.handler(message);
+      delivered.fetch_add(1, std::memory_order_relaxed);
+      routed = true;
+    }
+  }
+  if (!routed) {
+    unrouted.fetch_add(1, std::memory_order_relaxed);
+  }
+  latencyNs.push_back((uint32_t)std::min<uint64_t>(standInNowNs() - message.published_ns, UINT32_MAX));
+}
+
+void BrokerStandIn::deliveryLoop() {
+  for (;;) {
+    uint64_t next = head.load(std::memory_order_relaxed);
+    if (next == tail.load(std::memory_order_acquire)) {
+      if (!running.load(std::memory_order_acquire) && next == tail.load(std::memory_order_acquire)) {
+        return;
+      }
+      std::this_thread::yield();
+      continue;
+    }
+    deliver(slots[next % slots.size()]);
+    head.store(next + 1, std::memory_order_release);
+  }
+}
+
+BrokerStats BrokerStandIn::stats() const {
+  BrokerStats result = producerStats;
+  result.delivered = delivered.load(std::memory_order_relaxed);
+  result.unrouted = unrouted.load(std::memory_order_relaxed);
+  return result;
+}
+
+size_t BrokerStandIn::retainedCount() const {
+  return retainedTopics.load(std::memory_order_relaxed);
+}
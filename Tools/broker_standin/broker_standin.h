@@ -0,0 +1,108 @@
+// broker_standin.h - in-process MQTT broker stand-in for host load tests
+//
+// Routes PUBLISHes from one producer thread to subscribers on a delivery
+// thread, with MQTT topic filters (+ and #), retained messages and Last
+// Will. There is no socket or wire encoding: it stands in for a local
+// broker so a simulator and a collector can be driven against each other
+// at rates a real broker on the same box would distort.
+//
+// Messages are copied once into a fixed ring of slots sized from the
+// firmware's MQTT_TOPIC_MAX and MQTT_BUFFER_SIZE. Handlers receive a
+// reference to the slot itself, valid only for the duration of the call.
+// A full ring makes publish() wait, so a slow subscriber throttles the
+// producer the way TCP backpressure would.
+
+#ifndef LEAFYSENSE_BROKER_STANDIN_H
+#define LEAFYSENSE_BROKER_STANDIN_H
+
+#include "config.h"
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct StandInMessage {
+  uint64_t published_ns;        // steady_clock time publish() was called
+  uint16_t topic_length;
+  uint16_t payload_length;
+  bool retained;
+  char topic[MQTT_TOPIC_MAX];
+  uint8_t payload[MQTT_BUFFER_SIZE];
+};
+
+typedef std::function<void(const StandInMessage&)> StandInHandler;
+
+struct BrokerStats {
+  uint64_t published;           // Accepted by publish()
+  uint64_t delivered;           // Handler invocations
+  uint64_t unrouted;            // Matched no subscription
+  uint64_t rejected;            // Oversized topic or payload, or no session
+  uint64_t stalls;              // publish() calls that found the ring full
+  uint64_t bytes;               // Topic + payload bytes accepted
+  uint64_t wills;               // Last Wills published for unclean disconnects
+  uint64_t connects;
+  uint64_t refused;             // connect() while the broker was down
+};
+
+class BrokerStandIn {
+ public:
+  explicit BrokerStandIn(size_t capacity = 4096);
+  ~BrokerStandIn();
+
+  // Subscriptions are fixed before start()
+  void subscribe(const char* filter, StandInHandler handler);
+  void start();
+  void stop();                  // Delivers everything still queued first
+
+  // Session calls come from the producer thread only
+  bool connect(const std::string& clientId, const char* willTopic, const char* willPayload);
+  void disconnect(const std::string& clientId, bool clean);
+  void setAvailable(bool available);  // A down broker refuses connects and drops every session
+  bool publish(const char* topic, const void* payload, size_t length, bool retained);
+
+  BrokerStats stats() const;
+  size_t retainedCount() const;
+  // Publish-to-handler latency of every message, in ns. Read after stop().
+  const std::vector<uint32_t>& latencies() const { return latencyNs; }
+
+ private:
+  struct Subscription {
+    std::string filter;
+    StandInHandler handler;
+  };
+  struct Will {
+    std::string topic;
+    std::string payload;
+  };
+
+  void deliveryLoop();
+  void deliver(const StandInMessage& message);
+
+  std::vector<StandInMessage> slots;
+  std::atomic<uint64_t> head;   // Next slot the delivery thread reads
+  std::atomic<uint64_t> tail;   // Next slot the producer fills
+  std::atomic<bool> running;
+  std::thread deliveryThread;
+
+  std::vector<Subscription> subscriptions;
+  std::unordered_map<std::string, Will> sessions;
+  std::unordered_map<std::string, std::string> retained;  // Delivery thread only
+  std::atomic<size_t> retainedTopics;
+  bool available;
+
+  // Producer-side counters are plain, delivery-side ones atomic
+  BrokerStats producerStats;
+  std::atomic<uint64_t> delivered;
+  std::atomic<uint64_t> unrouted;
+  std::vector<uint32_t> latencyNs;
+};
+
+// MQTT topic filter match: '+' is one level, a trailing '#' any remainder
+bool topicMatches(const char* filter, const char* topic);
+
+uint64_t standInNowNs();
+
+#endif
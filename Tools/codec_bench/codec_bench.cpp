@@ -0,0 +1,130 @@
+// codec_bench.cpp - size and throughput comparison of the telemetry codecs
+//
+// Encodes representative sensors messages with both codecs from
+// telemetry_codec.cpp, checks that both round-trip through the host
+// decoders, and reports message sizes, projected daily traffic and host
+// encode/decode throughput.
+
+#include "telemetry_codec.h"
+#include "telemetry_decoder.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+// MQTT PUBLISH overhead at QoS1: fixed header (2-3 bytes), topic length
+// prefix, topic, packet identifier
+static size_t mqttPacketSize(const char* topic, size_t payload) {
+  size_t remaining = 2 + strlen(topic) + 2 + payload;
+  size_t lengthBytes = remaining < 128 ? 1 : remaining < 16384 ? 2 : 3;
+  return 1 + lengthBytes + remaining;
+}
+
+static TelemetryFrame sampleFrame(uint8_t probes) {
+  TelemetryFrame frame;
+  memset(&frame, 0, sizeof(frame));
+  const uint8_t mac[6] = {0x40, 0x4C, 0xCA, 0x5A, 0x1B, 0x3C};
+  memcpy(frame.mac, mac, sizeof(mac));
+  frame.epoch = 1760000000;
+  snprintf(frame.timestamp, sizeof(frame.timestamp), "2025-10-09 14:23:20");
+  frame.air_valid = true;
+  frame.air_temperature_centi = 2347;
+  frame.air_humidity_centi = 5812;
+  for (uint8_t p = 0; p < probes; p++) {
+    TelemetryProbe& probe = frame.probes[frame.probe_count++];
+    probe.index = p;
+    probe.moisture_centi = 4125 + p * 311;
+    probe.temperature_centi = 1862 - p * 47;
+    probe.moisture_raw = 20875 - p * 311;
+    probe.temp_raw = 8790 + p * 13;
+  }
+  frame.wifi_rssi = -67;
+  frame.free_heap = 187432;
+  frame.min_free_heap = 151208;
+  frame.largest_block = 110580;
+  frame.min_largest_block = 94196;
+  frame.loop_stack_free = 3912;
+  frame.queue_depth = 1;
+  frame.delivered = 4811;
+  frame.retransmits = 3;
+  frame.ack_ms = 42;
+  frame.ack_ms_max = 1874;
+  return frame;
+}
+
+static bool sameFrame(const TelemetryFrame& a, const TelemetryFrame& b) {
+  if (memcmp(a.mac, b.mac, 6) || a.epoch != b.epoch || a.air_valid != b.air_valid ||
+      a.air_temperature_centi != b.air_temperature_centi || a.air_humidity_centi != b.air_humidity_centi ||
+      a.probe_count != b.probe_count || a.wifi_rssi != b.wifi_rssi || a.free_heap != b.free_heap ||
+      a.min_free_heap != b.min_free_heap || a.largest_block != b.largest_block ||
+      a.min_largest_block != b.min_largest_block || a.alloc_failures != b.alloc_failures ||
+      a.loop_stack_free != b.loop_stack_free || a.memory_warnings != b.memory_warnings ||
+      a.queue_depth != b.queue_depth || a.delivered != b.delivered || a.dropped != b.dropped ||
+      a.retransmits != b.retransmits || a.ack_ms != b.ack_ms || a.ack_ms_max != b.ack_ms_max) {
+    return false;
+  }
+  for (uint8_t p = 0; p < a.probe_count; p++) {
+    const TelemetryProbe& x = a.probes[p];
+    const TelemetryProbe& y = b.probes[p];
+    if (x.index != y.index || x.moisture_centi != y.moisture_centi || x.temperature_centi != y.temperature_centi ||
+        x.moisture_raw != y.moisture_raw || x.temp_raw != y.temp_raw) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename Fn>
+static double nsPerCall(int rounds, Fn fn) {
+  volatile size_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; r++) sink = sink + fn();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / rounds;
+}
+
+static bool compare(uint8_t probes) {
+  TelemetryFrame frame = sampleFrame(probes);
+  char json[2048];
+  uint8_t cbor[1024];
+  size_t jsonSize = encodeTelemetryJSON(frame, json, sizeof(json));
+  size_t cborSize = encodeTelemetryCBOR(frame, cbor, sizeof(cbor));
+
+  TelemetryFrame decoded;
+  TelemetryDecodeResult result = decodeTelemetryCBOR(cbor, cborSize, decoded);
+  bool roundTrip = result.ok && sameFrame(frame, decoded);
+  TelemetryFrame decodedJson;
+  TelemetryDecodeResult jsonResult = decodeTelemetryJSON(json, jsonSize, decodedJson);
+  decodedJson.epoch = frame.epoch;  // Not carried by the JSON message
+  bool jsonRoundTrip = jsonResult.ok && sameFrame(frame, decodedJson);
+
+  const char* jsonTopic = "smartgarden/40:4C:CA:5A:1B:3C/sensors";
+  const char* cborTopic = "smartgarden/40:4C:CA:5A:1B:3C/sensors/cbor";
+  size_t jsonPacket = mqttPacketSize(jsonTopic, jsonSize);
+  size_t cborPacket = mqttPacketSize(cborTopic, cborSize);
+  double perDay = 86400000.0 / MQTT_PUBLISH_INTERVAL;
+
+  printf("%u soil probes\n", probes);
+  printf("  payload      JSON %5zu B   CBOR %4zu B   (%.1fx smaller)\n", jsonSize, cborSize, (double)jsonSize / cborSize);
+  printf("  MQTT packet  JSON %5zu B   CBOR %4zu B   (QoS1, topic included)\n", jsonPacket, cborPacket);
+  printf("  per day      JSON %5.1f KB  CBOR %4.1f KB  at one message every %d s\n",
+         jsonPacket * perDay / 1024, cborPacket * perDay / 1024, MQTT_PUBLISH_INTERVAL / 1000);
+  printf("  CBOR round trip: %s\n", roundTrip ? "OK" : result.ok ? "MISMATCH" : result.error.c_str());
+  printf("  JSON round trip: %s\n", jsonRoundTrip ? "OK" : jsonResult.ok ? "MISMATCH" : jsonResult.error.c_str());
+
+  const int rounds = 200000;
+  double tJson = nsPerCall(rounds, [&] { return encodeTelemetryJSON(frame, json, sizeof(json)); });
+  double tCbor = nsPerCall(rounds, [&] { return encodeTelemetryCBOR(frame, cbor, sizeof(cbor)); });
+  double tDecode = nsPerCall(rounds, [&] { return (size_t)decodeTelemetryCBOR(cbor, cborSize, decoded).ok; });
+  double tDecodeJson = nsPerCall(rounds, [&] { return (size_t)decodeTelemetryJSON(json, jsonSize, decoded).ok; });
+  printf("  host encode  JSON %7.0f ns/msg   CBOR %6.0f ns/msg  (%.1fx)\n", tJson, tCbor, tJson / tCbor);
+  printf("  host decode  JSON %7.0f ns/msg   CBOR %6.0f ns/msg  (%.1fx)\n\n", tDecodeJson, tDecode, tDecodeJson / tDecode);
+  return roundTrip && jsonRoundTrip;
+}
+
+int main() {
+  printf("Telemetry codec comparison, CBOR schema %d\n\n", TELEMETRY_SCHEMA_VERSION);
+  bool ok = compare(2);
+  ok = compare(MAX_SOIL_PROBES) && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,377 @@
+// fleet_collector.cpp - fleet ingestion service and its benchmarks
+//
+// Subscribes to <prefix>/+/sensors and <prefix>/+/sensors/cbor, decodes
+// each message in place with the host decoders (telemetry_decoder.h) and
+// appends it to the per-device columnar store (series_store.h). Backlog
+// replays on <prefix>/+/backlog and <prefix>/+/backlog/cbor are backfilled
+// into the same store.
+//
+//   fleet_collector bench [--devices N] [--messages M] [--codec json|cbor|mixed]
+//                         [--interval s] [--queries Q] [--store dir] [--keep]
+//                         [--backlog-pct P]
+//   fleet_collector query --store dir --device AA:BB:CC:DD:EE:FF [--channel c]
+//                         [--from unix] [--to unix] [--bucket s]
+//
+// bench drives a synthetic fleet through the in-process broker stand-in
+// (broker_standin.h). Decoding and storage run on the stand-in's delivery
+// thread, so the reported ingest rate is what one core sustains. With
+// --backlog-pct, that share of each device's messages is held back as if
+// sent during an outage and replayed on the backlog topic after the next
+// live message. Range queries are timed afterwards. query reads an existing store: raw samples
+// by default, or min/mean/max buckets with --bucket.
+//
+// JSON messages carry only the device's local time; --gmt-offset (seconds,
+// GMT_OFFSET_SEC on the device) converts it to Unix time.
+
+#include "broker_standin.h"
+#include "series_store.h"
+#include "telemetry_decoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <ftw.h>
+#include <random>
+#include <string>
+#include <vector>
+
+enum CodecMix { MIX_JSON, MIX_CBOR, MIX_BOTH };
+
+struct Options {
+  uint32_t devices = 2000;
+  uint32_t messages = 2000000;
+  CodecMix codec = MIX_JSON;
+  uint32_t interval_s = MQTT_PUBLISH_INTERVAL / 1000;
+  uint32_t queries = 2000;
+  uint32_t backlog_pct = 0;
+  const char* store = nullptr;
+  bool keep = false;
+  long gmt_offset = 0;
+  const char* prefix = "smartgarden";
+  const char* device = nullptr;
+  uint32_t channel = 0;
+  uint32_t from = 0;
+  uint32_t to = UINT32_MAX;
+  uint32_t bucket = 0;
+};
+
+struct IngestStats {
+  uint64_t messages = 0;
+  uint64_t stored = 0;
+  uint64_t decode_errors = 0;
+  uint64_t undated = 0;         // Backlog messages with no usable time, dropped
+  uint64_t first_ns = 0;
+  uint64_t last_ns = 0;
+  uint64_t first_cpu_ns = 0;
+  uint64_t last_cpu_ns = 0;
+};
+
+static Options options;
+
+static uint64_t threadCpuNs() {
+  timespec now;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  return (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+// "YYYY-MM-DD HH:MM:SS" as written by formatTimestamp(), read as UTC
+static bool parseTimestamp(const char* text, uint32_t& epoch) {
+  int year, month, day, hour, minute, second;
+  if (sscanf(text, "%4d-%2d-%2d %2d:%2d:%2d", &year, &month, &day, &hour, &minute, &second) != 6) return false;
+  // Days from civil (proleptic Gregorian)
+  year -= month <= 2;
+  int era = (year >= 0 ? year : year - 399) / 400;
+  int yearOfEra = year - era * 400;
+  int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  int64_t days = (int64_t)era * 146097 + dayOfEra - 719468;
+  epoch = (uint32_t)(days * 86400 + hour * 3600 + minute * 60 + second);
+  return true;
+}
+
+class Collector {
+ public:
+  Collector(BrokerStandIn& broker, SeriesStore& store) : store(store) {
+    char filter[MQTT_TOPIC_MAX];
+    snprintf(filter, sizeof(filter), "%s/+/sensors", options.prefix);
+    broker.subscribe(filter, [this](const StandInMessage& message) { ingest(message, false); });
+    snprintf(filter, sizeof(filter), "%s/+/sensors/cbor", options.prefix);
+    broker.subscribe(filter, [this](const StandInMessage& message) { ingest(message, true); });
+    snprintf(filter, sizeof(filter), "%s/+/backlog", options.prefix);
+    broker.subscribe(filter, [this](const StandInMessage& message) { ingest(message, false); });
+    snprintf(filter, sizeof(filter), "%s/+/backlog/cbor", options.prefix);
+    broker.subscribe(filter, [this](const StandInMessage& message) { ingest(message, true); });
+  }
+
+  const IngestStats& stats() const { return ingestStats; }
+
+ private:
+  // Runs on the delivery thread; the payload is read where the stand-in
+  // put it. Backlog messages are told apart by their sequence field.
+  void ingest(const StandInMessage& message, bool cbor) {
+    if (ingestStats.messages++ == 0) {
+      ingestStats.first_ns = standInNowNs();
+      ingestStats.first_cpu_ns = threadCpuNs();
+    }
+
+    TelemetryDecodeResult result = cbor ? decodeTelemetryCBOR(message.payload, message.payload_length, frame)
+                                        : decodeTelemetryJSON((const char*)message.payload, message.payload_length, frame);
+    uint32_t timestamp = frame.epoch;
+    bool dated = timestamp != 0;
+    if (result.ok && !dated) {
+      dated = parseTimestamp(frame.timestamp, timestamp);
+      if (dated) {
+        timestamp -= options.gmt_offset;
+      } else {
+        timestamp = (uint32_t)time(nullptr);
+      }
+    }
+    if (!result.ok) {
+      ingestStats.decode_errors++;
+    } else if (frame.logged) {
+      // Arrival time says nothing about when a logged sample was taken
+      if (!dated) {
+        ingestStats.undated++;
+      } else if (store.backfill(frame, timestamp)) {
+        ingestStats.stored++;
+      }
+    } else if (store.append(frame, timestamp)) {
+      ingestStats.stored++;
+    }
+
+    ingestStats.last_ns = standInNowNs();
+    ingestStats.last_cpu_ns = threadCpuNs();
+  }
+
+  SeriesStore& store;
+  TelemetryFrame frame;
+  IngestStats ingestStats;
+};
+
+static void fillFrame(TelemetryFrame& frame, uint32_t device, uint32_t epoch, std::mt19937& rng) {
+  memset(&frame, 0, sizeof(frame));
+  const uint8_t mac[6] = {0x40, 0x4C, 0xCA, (uint8_t)(device >> 16), (uint8_t)(device >> 8), (uint8_t)device};
+  memcpy(frame.mac, mac, sizeof(mac));
+  frame.epoch = epoch;
+  time_t local = epoch + options.gmt_offset;
+  strftime(frame.timestamp, sizeof(frame.timestamp), "%Y-%m-%d %H:%M:%S", gmtime(&local));
+  frame.air_valid = true;
+  frame.air_temperature_centi = 1800 + rng() % 800;
+  frame.air_humidity_centi = 4500 + rng() % 2000;
+  frame.probe_count = 2;
+  for (uint8_t p = 0; p < 2; p++) {
+    frame.probes[p].index = p;
+    frame.probes[p].moisture_centi = 3000 + rng() % 3000;
+    frame.probes[p].temperature_centi = 1500 + rng() % 500;
+    frame.probes[p].moisture_raw = 20000;
+    frame.probes[p].temp_raw = 8790;
+  }
+  frame.wifi_rssi = -60;
+  frame.free_heap = 187432;
+}
+
+static double percentile(std::vector<uint32_t>& values, double pct) {
+  if (values.empty()) return 0;
+  size_t rank = std::min(values.size() - 1, (size_t)(pct / 100.0 * values.size()));
+  std::nth_element(values.begin(), values.begin() + rank, values.end());
+  return values[rank];
+}
+
+template <typename Fn>
+static void timeQueries(const char* name, std::mt19937& rng, Fn query) {
+  std::vector<uint32_t> latency;
+  uint64_t points = 0;
+  for (uint32_t q = 0; q < options.queries; q++) {
+    uint64_t start = standInNowNs();
+    points += query(rng);
+    latency.push_back((uint32_t)(standInNowNs() - start));
+  }
+  printf("  %-28s p50 %7.1f us  p99 %7.1f us  max %7.1f us  %6.0f points/query\n", name,
+         percentile(latency, 50) / 1e3, percentile(latency, 99) / 1e3, percentile(latency, 100) / 1e3,
+         (double)points / options.queries);
+}
+
+static int removeEntry(const char* path, const struct stat*, int, struct FTW*) {
+  return remove(path);
+}
+
+static int runBench() {
+  char generated[] = "/tmp/leafysense_store.XXXXXX";
+  std::string directory = options.store ? options.store : mkdtemp(generated);
+  const uint32_t start = 1760000000;
+  uint32_t rounds = (options.messages + options.devices - 1) / options.devices;
+  uint64_t total = (uint64_t)rounds * options.devices;
+
+  printf("Ingesting %llu messages from %u devices (%s, one every %u s each) into %s\n",
+         (unsigned long long)total, options.devices,
+         options.codec == MIX_JSON ? "JSON" : options.codec == MIX_CBOR ? "CBOR" : "JSON + CBOR",
+         options.interval_s, directory.c_str());
+
+  {
+    SeriesStore store(directory);
+    BrokerStandIn broker(16384);
+    Collector collector(broker, store);
+    broker.start();
+
+    // Each round is one publish interval of the whole fleet, devices
+    // spread across it
+    std::mt19937 rng(1);
+    TelemetryFrame frame;
+    uint8_t payload[MQTT_BUFFER_SIZE];
+    char topic[MQTT_TOPIC_MAX + 32];
+    std::vector<std::vector<TelemetryFrame>> held(options.backlog_pct ? options.devices : 0);
+    std::vector<uint32_t> sequence(held.size());
+    auto publish = [&](const TelemetryFrame& message, bool cbor) {
+      const char* subtopic = message.logged ? (cbor ? "backlog/cbor" : "backlog") : (cbor ? "sensors/cbor" : "sensors");
+      size_t length = cbor ? encodeTelemetryCBOR(message, payload, sizeof(payload))
+                           : encodeTelemetryJSON(message, (char*)payload, sizeof(payload));
+      snprintf(topic, sizeof(topic), "%s/%02X:%02X:%02X:%02X:%02X:%02X/%s", options.prefix, message.mac[0],
+               message.mac[1], message.mac[2], message.mac[3], message.mac[4], message.mac[5], subtopic);
+      broker.publish(topic, payload, length, false);
+    };
+    for (uint32_t round = 0; round < rounds; round++) {
+      for (uint32_t d = 0; d < options.devices; d++) {
+        uint32_t epoch = start + round * options.interval_s + d % options.interval_s;
+        fillFrame(frame, d, epoch, rng);
+        bool cbor = options.codec == MIX_CBOR || (options.codec == MIX_BOTH && d % 2);
+        if (options.backlog_pct && rng() % 100 < options.backlog_pct) {
+          // Logged during an outage; replayed behind the next live message
+          frame.logged = true;
+          frame.sequence = sequence[d]++;
+          held[d].push_back(frame);
+          continue;
+        }
+        publish(frame, cbor);
+        if (options.backlog_pct) {
+          for (const TelemetryFrame& logged : held[d]) publish(logged, cbor);
+          held[d].clear();
+        }
+      }
+    }
+    broker.stop();
+    store.flush();
+
+    const IngestStats& ingest = collector.stats();
+    const StoreStats& stored = store.stats();
+    double wall = (ingest.last_ns - ingest.first_ns) / 1e9;
+    double cpu = (ingest.last_cpu_ns - ingest.first_cpu_ns) / 1e9;
+    printf("\nIngest: %llu stored, %llu decode errors, %llu out of order\n",
+           (unsigned long long)ingest.stored, (unsigned long long)ingest.decode_errors,
+           (unsigned long long)stored.out_of_order);
+    if (options.backlog_pct) {
+      printf("  backlog: %llu backfilled, %llu duplicates, %llu undated\n", (unsigned long long)stored.backfilled,
+             (unsigned long long)stored.duplicates, (unsigned long long)ingest.undated);
+    }
+    printf("  %.0f msg/s wall, %.0f msg/s per core (%.2f us CPU per message on the delivery thread)\n",
+           ingest.messages / wall, ingest.messages / cpu, cpu * 1e6 / ingest.messages);
+    printf("  producer stalls on a full ring: %llu\n",
+           (unsigned long long)broker.stats().stalls);
+    printf("Store: %u devices, %llu raw rows, %llu rollup rows, %.1f MB mapped\n", stored.devices,
+           (unsigned long long)stored.rows, (unsigned long long)stored.rollups, stored.mapped_bytes / 1e6);
+
+    uint32_t span = rounds * options.interval_s;
+    auto randomMac = [](std::mt19937& rng, uint8_t* mac) {
+      uint32_t device = rng() % options.devices;
+      const uint8_t bytes[6] = {0x40, 0x4C, 0xCA, (uint8_t)(device >> 16), (uint8_t)(device >> 8), (uint8_t)device};
+      memcpy(mac, bytes, 6);
+    };
+    std::vector<SeriesPoint> raw;
+    std::vector<RollupPoint> rollups;
+    printf("\nQueries (%u each, random device and channel over %.1f h of data):\n", options.queries, span / 3600.0);
+    timeQueries("raw, 1 h window", rng, [&](std::mt19937& r) {
+      uint8_t mac[6];
+      randomMac(r, mac);
+      uint32_t from = start + r() % std::max<uint32_t>(span > 3600 ? span - 3600 : 1, 1);
+      return store.queryRaw(mac, from, from + 3600, r() % 6, raw);
+    });
+    timeQueries("1-minute rollups, 6 h window", rng, [&](std::mt19937& r) {
+      uint8_t mac[6];
+      randomMac(r, mac);
+      uint32_t from = start + r() % std::max<uint32_t>(span > 21600 ? span - 21600 : 1, 1);
+      return store.queryRollup(mac, STORE_TIER_MINUTE, from, from + 21600, r() % 6, rollups);
+    });
+    timeQueries("15-min buckets, everything", rng, [&](std::mt19937& r) {
+      uint8_t mac[6];
+      randomMac(r, mac);
+      return store.queryDownsampled(mac, start, start + span, r() % 6, 900, rollups);
+    });
+    timeQueries("1-hour rollups, everything", rng, [&](std::mt19937& r) {
+      uint8_t mac[6];
+      randomMac(r, mac);
+      return store.queryRollup(mac, STORE_TIER_HOUR, start, start + span, r() % 6, rollups);
+    });
+  }
+
+  if (!options.keep && options.store == nullptr) {
+    nftw(directory.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+  }
+  return 0;
+}
+
+static int runQuery() {
+  uint8_t mac[6];
+  unsigned int bytes[6];
+  if (options.store == nullptr || options.device == nullptr ||
+      sscanf(options.device, "%2x:%2x:%2x:%2x:%2x:%2x", &bytes[0], &bytes[1], &bytes[2], &bytes[3], &bytes[4], &bytes[5]) != 6 ||
+      options.channel >= STORE_CHANNELS) {
+    fprintf(stderr, "query needs --store, --device AA:BB:CC:DD:EE:FF and a channel below %d\n", STORE_CHANNELS);
+    return 2;
+  }
+  for (int i = 0; i < 6; i++) mac[i] = (uint8_t)bytes[i];
+
+  SeriesStore store(options.store);
+  if (options.bucket == 0) {
+    std::vector<SeriesPoint> points;
+    store.queryRaw(mac, options.from, options.to, options.channel, points);
+    for (const SeriesPoint& point : points) printf("%u %.2f\n", point.timestamp, point.value / 100.0);
+  } else {
+    std::vector<RollupPoint> points;
+    store.queryDownsampled(mac, options.from, options.to, options.channel, options.bucket, points);
+    for (const RollupPoint& point : points) {
+      printf("%u %u %.2f %.2f %.2f\n", point.timestamp, point.samples, point.min / 100.0, point.mean / 100.0,
+             point.max / 100.0);
+    }
+  }
+  return 0;
+}
+
+static bool parseOptions(int argc, char** argv) {
+  for (int i = 2; i < argc; i++) {
+    const char* name = argv[i];
+    if (strcmp(name, "--keep") == 0) {
+      options.keep = true;
+      continue;
+    }
+    if (i + 1 >= argc) return false;
+    const char* value = argv[++i];
+    uint32_t number = (uint32_t)strtoul(value, nullptr, 10);
+    if (strcmp(name, "--devices") == 0) options.devices = std::max<uint32_t>(number, 1);
+    else if (strcmp(name, "--messages") == 0) options.messages = number;
+    else if (strcmp(name, "--codec") == 0) options.codec = strcmp(value, "cbor") == 0 ? MIX_CBOR : strcmp(value, "mixed") == 0 ? MIX_BOTH : MIX_JSON;
+    else if (strcmp(name, "--interval") == 0) options.interval_s = std::max<uint32_t>(number, 1);
+    else if (strcmp(name, "--queries") == 0) options.queries = std::max<uint32_t>(number, 1);
+    else if (strcmp(name, "--backlog-pct") == 0) options.backlog_pct = std::min<uint32_t>(number, 99);
+    else if (strcmp(name, "--store") == 0) options.store = value;
+    else if (strcmp(name, "--gmt-offset") == 0) options.gmt_offset = strtol(value, nullptr, 10);
+    else if (strcmp(name, "--prefix") == 0) options.prefix = value;
+    else if (strcmp(name, "--device") == 0) options.device = value;
+    else if (strcmp(name, "--channel") == 0) options.channel = number;
+    else if (strcmp(name, "--from") == 0) options.from = number;
+    else if (strcmp(name, "--to") == 0) options.to = number;
+    else if (strcmp(name, "--bucket") == 0) options.bucket = number;
+    else return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  const char* mode = argc > 1 ? argv[1] : "";
+  if (!parseOptions(argc, argv) || (strcmp(mode, "bench") != 0 && strcmp(mode, "query") != 0)) {
+    fprintf(stderr, "usage: fleet_collector bench|query [options] (see the top of fleet_collector.cpp)\n");
+    return 2;
+  }
+  return strcmp(mode, "bench") == 0 ? runBench() : runQuery();
+}
@@ -0,0 +1,505 @@
+// fleet_sim.cpp - simulates a fleet of LeafySense devices for load tests
+//
+// Every virtual device publishes what the firmware publishes, on the same
+// topics: the combined sensors message encoded by telemetry_codec.cpp, the
+// individual air/soil topics (MQTT_INDIVIDUAL_TOPICS), and the retained
+// status/info plus health messages of a session, info and health built by
+// telemetry_codec.cpp as well. Sessions register the firmware's "offline"
+// Last Will and reconnect with its jittered exponential backoff
+// (MQTT_RECONNECT_* in config.h).
+//
+// --report picks the firmware's reporting mode, REPORT_MODE by default. In
+// deadband mode a device reads its sensors every --sample ms and publishes
+// only when a metric moved past its deadband or its heartbeat is due; the
+// combined message is then complete and only the due individual topics go
+// out. In interval mode everything is published every --interval ms.
+//
+// Traffic goes to the in-process broker stand-in (broker_standin.h). The
+// clock is simulated, so by default the fleet runs as fast as the stand-in
+// delivers; --realtime paces it to the wall clock instead. Disconnect
+// storms drop a share of the fleet at fixed intervals, optionally with a
+// broker outage, and the reconnect waves that follow are reported.
+//
+// Not simulated: the store-and-forward backlog replay after an outage,
+// QoS1 acknowledgements and the command channel.
+
+#include "broker_standin.h"
+#include "telemetry_codec.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Options {
+  uint32_t devices = 1000;
+  uint8_t report_mode = REPORT_MODE;
+  uint32_t interval_ms = MQTT_PUBLISH_INTERVAL;  // Interval mode
+  uint32_t sample_ms = SENSOR_READ_INTERVAL;     // Deadband mode
+  uint32_t jitter_pct = 10;           // Publish interval +/- this percent
+  uint32_t duration_s = 3600;         // Simulated time
+  uint32_t probes = 2;
+  bool cbor = false;
+  bool individual = MQTT_INDIVIDUAL_TOPICS;
+  uint32_t storm_every_s = 900;       // 0 = no storms
+  uint32_t storm_pct = 30;            // Share of online devices dropped per storm
+  uint32_t outage_s = 0;              // Broker refuses connects this long after a storm
+  bool realtime = false;
+  const char* prefix = "smartgarden";
+  uint32_t seed = 1;
+};
+
+enum EventKind : uint8_t { EVENT_PUBLISH, EVENT_HEALTH, EVENT_RECONNECT, EVENT_STORM, EVENT_BROKER_UP };
+
+struct Event {
+  uint64_t at_ms;
+  uint32_t device;
+  EventKind kind;
+  uint32_t session;                   // Stale events of an old session are ignored
+  bool operator>(const Event& other) const { return at_ms > other.at_ms; }
+};
+
+// Metric layout of report_policy.h: air temperature, air humidity, then
+// moisture and temperature for every soil probe
+#define SIM_METRICS (2 + 2 * MAX_SOIL_PROBES)
+
+struct VirtualDevice {
+  uint8_t mac[6];
+  char id[18];
+  char base[MQTT_TOPIC_MAX];
+  bool online;
+  uint32_t session;
+  uint32_t backoff_ms;
+  uint64_t dropped_at_ms;
+  float air_temperature;
+  float air_humidity;
+  float moisture[MAX_SOIL_PROBES];
+  float soil_temperature[MAX_SOIL_PROBES];
+  uint32_t delivered;
+  // Deadband state, as metricStates in report_policy.cpp
+  float reported_value[SIM_METRICS];
+  uint64_t reported_at_ms[SIM_METRICS];
+  bool reported[SIM_METRICS];
+};
+
+struct Counters {
+  uint64_t sensors = 0;
+  uint64_t individual = 0;
+  uint64_t presence = 0;              // status + info
+  uint64_t health = 0;
+  uint64_t metrics_published = 0;
+  uint64_t metrics_suppressed = 0;
+  uint64_t received = 0;              // Seen by the fleet-wide subscriber
+  uint64_t drops = 0;
+  uint64_t attempts = 0;
+  uint64_t failures = 0;
+  uint64_t storms = 0;
+  std::vector<uint32_t> reconnect_ms;
+  std::vector<uint32_t> connects_per_second;  // Indexed by simulated second
+};
+
+static Options options;
+static std::vector<VirtualDevice> fleet;
+static std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+static std::mt19937 rng;
+static Counters counters;
+static uint8_t payload[MQTT_BUFFER_SIZE];
+
+static uint32_t jittered(uint32_t value, uint32_t pct) {
+  uint32_t jitter = (uint32_t)((uint64_t)value * pct / 100);
+  if (jitter == 0) return value;
+  return value - jitter + rng() % (2 * jitter + 1);
+}
+
+static float drift(float value, float step, float low, float high) {
+  std::uniform_real_distribution<float> delta(-step, step);
+  return std::min(high, std::max(low, value + delta(rng)));
+}
+
+static void schedule(uint64_t at_ms, uint32_t device, EventKind kind) {
+  events.push({at_ms, device, kind, device < fleet.size() ? fleet[device].session : 0});
+}
+
+static void publishTopic(BrokerStandIn& broker, const VirtualDevice& device, const char* subtopic,
+                         const void* data, size_t length, bool retained) {
+  char topic[MQTT_TOPIC_MAX + 32];  // Overlong topics reach the stand-in and are rejected there
+  snprintf(topic, sizeof(topic), "%s/%s", device.base, subtopic);
+  broker.publish(topic, data, length, retained);
+}
+
+static void publishFloat(BrokerStandIn& broker, const VirtualDevice& device, const char* subtopic, float value) {
+  char text[16];
+  int length = snprintf(text, sizeof(text), "%.2f", value);
+  publishTopic(broker, device, subtopic, text, length, false);
+  counters.individual++;
+}
+
+static int16_t centi(float value) {
+  return (int16_t)lroundf(value * 100.0f);
+}
+
+// Time between report decisions: every settled read in deadband mode
+static uint32_t cycleMs() {
+  return options.report_mode == REPORT_MODE_DEADBAND ? options.sample_ms : options.interval_ms;
+}
+
+static float deadbandOf(uint8_t metric) {
+  if (metric == 0) return AIR_TEMP_DEADBAND;
+  if (metric == 1) return AIR_HUMIDITY_DEADBAND;
+  return metric % 2 == 0 ? SOIL_MOISTURE_DEADBAND : SOIL_TEMP_DEADBAND;
+}
+
+// Same test as crossesDeadband() in report_policy.cpp
+static bool metricDue(const VirtualDevice& device, uint8_t metric, float value, uint64_t now_ms) {
+  if (options.report_mode == REPORT_MODE_INTERVAL || !device.reported[metric]) return true;
+  if (now_ms - device.reported_at_ms[metric] >= REPORT_HEARTBEAT_INTERVAL) return true;
+  float delta = fabsf(value - device.reported_value[metric]);
+  float deadband = deadbandOf(metric);
+  if (deadband > 0 && delta >= deadband) return true;
+  if (REPORT_RELATIVE_DEADBAND > 0 && delta >= REPORT_RELATIVE_DEADBAND * fabsf(device.reported_value[metric])) {
+    return true;
+  }
+  return false;
+}
+
+// One report cycle: drifts the readings, then publishes like
+// publishSensorData() in mqtt_manager.cpp if any metric is due
+static void publishSensors(BrokerStandIn& broker, VirtualDevice& device, uint64_t now_ms) {
+  // Random walk steps are per 30 s; scaled so both modes drift alike
+  float scale = sqrtf(cycleMs() / 30000.0f);
+  device.air_temperature = drift(device.air_temperature, 0.2f * scale, 5.0f, 40.0f);
+  device.air_humidity = drift(device.air_humidity, 0.8f * scale, 20.0f, 95.0f);
+  for (uint8_t p = 0; p < options.probes; p++) {
+    device.moisture[p] = drift(device.moisture[p], 0.5f * scale, 0.0f, 100.0f);
+    device.soil_temperature[p] = drift(device.soil_temperature[p], 0.1f * scale, 0.0f, 35.0f);
+  }
+
+  float values[SIM_METRICS] = {device.air_temperature, device.air_humidity};
+  for (uint8_t p = 0; p < options.probes; p++) {
+    values[2 + p * 2] = device.moisture[p];
+    values[3 + p * 2] = device.soil_temperature[p];
+  }
+  uint8_t metrics = 2 + options.probes * 2;
+  bool due[SIM_METRICS];
+  bool any = false;
+  for (uint8_t m = 0; m < metrics; m++) {
+    due[m] = metricDue(device, m, values[m], now_ms);
+    any = any || due[m];
+    if (!due[m]) counters.metrics_suppressed++;
+  }
+  if (!any) return;
+
+  // Same content as fillTelemetryFrame() in mqtt_manager.cpp
+  TelemetryFrame frame;
+  memset(&frame, 0, sizeof(frame));
+  memcpy(frame.mac, device.mac, sizeof(frame.mac));
+  frame.epoch = 1760000000 + (uint32_t)(now_ms / 1000);
+  time_t epoch = frame.epoch;
+  strftime(frame.timestamp, sizeof(frame.timestamp), "%Y-%m-%d %H:%M:%S", gmtime(&epoch));
+  frame.air_valid = true;
+  frame.air_temperature_centi = centi(device.air_temperature);
+  frame.air_humidity_centi = centi(device.air_humidity);
+  for (uint8_t p = 0; p < options.probes; p++) {
+    TelemetryProbe& probe = frame.probes[frame.probe_count++];
+    probe.index = p;
+    probe.moisture_centi = centi(device.moisture[p]);
+    probe.temperature_centi = centi(device.soil_temperature[p]);
+    probe.moisture_raw = (int16_t)(SOIL_MOISTURE_DRY - device.moisture[p] * (SOIL_MOISTURE_DRY - SOIL_MOISTURE_WET) / 100.0f);
+    probe.temp_raw = 8790;
+  }
+  frame.wifi_rssi = (int8_t)(-55 - (int)(rng() % 25));
+  frame.free_heap = 187432;
+  frame.min_free_heap = 151208;
+  frame.largest_block = 110580;
+  frame.min_largest_block = 94196;
+  frame.loop_stack_free = 3912;
+  frame.delivered = device.delivered++;
+
+  size_t length = options.cbor ? encodeTelemetryCBOR(frame, payload, sizeof(payload))
+                               : encodeTelemetryJSON(frame, (char*)payload, sizeof(payload));
+  publishTopic(broker, device, options.cbor ? "sensors/cbor" : "sensors", payload, length, false);
+  counters.sensors++;
+
+  // Individual topics only for the due metrics
+  if (options.individual) {
+    char subtopic[32];
+    if (due[0]) publishFloat(broker, device, "air/temperature", device.air_temperature);
+    if (due[1]) publishFloat(broker, device, "air/humidity", device.air_humidity);
+    for (uint8_t p = 0; p < options.probes; p++) {
+      snprintf(subtopic, sizeof(subtopic), "soil/%u/moisture", p + 1);
+      if (due[2 + p * 2]) publishFloat(broker, device, subtopic, device.moisture[p]);
+      snprintf(subtopic, sizeof(subtopic), "soil/%u/temperature", p + 1);
+      if (due[3 + p * 2]) publishFloat(broker, device, subtopic, device.soil_temperature[p]);
+    }
+  }
+
+  // markMetricsReported()
+  for (uint8_t m = 0; m < metrics; m++) {
+    if (!due[m]) continue;
+    device.reported_value[m] = values[m];
+    device.reported_at_ms[m] = now_ms;
+    device.reported[m] = true;
+    counters.metrics_published++;
+  }
+}
+
+static void publishHealth(BrokerStandIn& broker, const VirtualDevice& device, uint64_t now_ms) {
+  HealthReport health = {};
+  health.wifi_rssi = (int8_t)(-55 - (int)(rng() % 25));
+  health.uptime_s = (uint32_t)(now_ms / 1000);
+  health.mqtt_connects = device.session;
+  size_t length = encodeHealthJSON(health, (char*)payload, sizeof(payload));
+  publishTopic(broker, device, "health", payload, length, false);
+  counters.health++;
+}
+
+// A session starts like finishMQTTConnect(): will, retained online, info, health
+static bool connectDevice(BrokerStandIn& broker, VirtualDevice& device, uint64_t now_ms) {
+  char willTopic[MQTT_TOPIC_MAX + 32];
+  snprintf(willTopic, sizeof(willTopic), "%s/status", device.base);
+  counters.attempts++;
+  if (!broker.connect(device.id, willTopic, "offline")) {
+    counters.failures++;
+    return false;
+  }
+
+  device.online = true;
+  device.session++;
+  device.backoff_ms = MQTT_RECONNECT_MIN_MS;
+  publishTopic(broker, device, "status", "online", 6, true);
+  DeviceInfo info;
+  memcpy(info.mac, device.mac, sizeof(info.mac));
+  info.firmware = CURRENT_FIRMWARE_VERSION;
+  info.probes = options.probes;
+  info.sample_interval_ms = options.sample_ms;
+  info.publish_interval_ms = options.report_mode == REPORT_MODE_DEADBAND ? REPORT_HEARTBEAT_INTERVAL : options.interval_ms;
+  info.report_mode = options.report_mode;
+  info.codec = options.cbor ? TELEMETRY_CODEC_CBOR : TELEMETRY_CODEC_JSON;
+  size_t length = encodeDeviceInfoJSON(info, (char*)payload, sizeof(payload));
+  publishTopic(broker, device, "info", payload, length, true);
+  counters.presence += 2;
+  publishHealth(broker, device, now_ms);
+
+  uint64_t second = now_ms / 1000;
+  if (counters.connects_per_second.size() <= second) counters.connects_per_second.resize(second + 1);
+  counters.connects_per_second[second]++;
+
+  uint32_t index = &device - fleet.data();
+  schedule(now_ms + jittered(cycleMs(), options.jitter_pct), index, EVENT_PUBLISH);
+  schedule(now_ms + MQTT_HEALTH_INTERVAL, index, EVENT_HEALTH);
+  return true;
+}
+
+static void dropDevice(BrokerStandIn& broker, VirtualDevice& device, uint64_t now_ms) {
+  broker.disconnect(device.id, false);
+  device.online = false;
+  device.session++;
+  device.dropped_at_ms = now_ms;
+  counters.drops++;
+  schedule(now_ms, &device - fleet.data(), EVENT_RECONNECT);  // First retry right away, as the firmware does
+}
+
+static void handleEvent(BrokerStandIn& broker, const Event& event) {
+  if (event.kind == EVENT_STORM) {
+    counters.storms++;
+    for (VirtualDevice& device : fleet) {
+      if (device.online && rng() % 100 < options.storm_pct) dropDevice(broker, device, event.at_ms);
+    }
+    if (options.outage_s > 0) {
+      broker.setAvailable(false);
+      for (VirtualDevice& device : fleet) {
+        if (device.online) dropDevice(broker, device, event.at_ms);
+      }
+      schedule(event.at_ms + options.outage_s * 1000ULL, UINT32_MAX, EVENT_BROKER_UP);
+    }
+    schedule(event.at_ms + options.storm_every_s * 1000ULL, UINT32_MAX, EVENT_STORM);
+    return;
+  }
+  if (event.kind == EVENT_BROKER_UP) {
+    broker.setAvailable(true);
+    return;
+  }
+
+  VirtualDevice& device = fleet[event.device];
+  if (event.session != device.session) return;
+
+  switch (event.kind) {
+    case EVENT_PUBLISH:
+      publishSensors(broker, device, event.at_ms);
+      schedule(event.at_ms + jittered(cycleMs(), options.jitter_pct), event.device, EVENT_PUBLISH);
+      break;
+    case EVENT_HEALTH:
+      publishHealth(broker, device, event.at_ms);
+      schedule(event.at_ms + MQTT_HEALTH_INTERVAL, event.device, EVENT_HEALTH);
+      break;
+    case EVENT_RECONNECT:
+      if (connectDevice(broker, device, event.at_ms)) {
+        if (device.dropped_at_ms != 0) {
+          counters.reconnect_ms.push_back((uint32_t)(event.at_ms - device.dropped_at_ms));
+        }
+      } else {
+        uint32_t delay = jittered(device.backoff_ms, MQTT_RECONNECT_JITTER_PCT);
+        device.backoff_ms = std::min<uint32_t>(device.backoff_ms * 2, MQTT_RECONNECT_MAX_MS);
+        schedule(event.at_ms + delay, event.device, EVENT_RECONNECT);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+static double percentile(std::vector<uint32_t>& values, double pct) {
+  if (values.empty()) return 0;
+  size_t rank = std::min(values.size() - 1, (size_t)(pct / 100.0 * values.size()));
+  std::nth_element(values.begin(), values.begin() + rank, values.end());
+  return values[rank];
+}
+
+static void usage() {
+  printf("usage: fleet_sim [--devices N] [--report deadband|interval] [--sample ms] [--interval ms]\n"
+         "                 [--jitter pct] [--duration s]\n"
+         "                 [--probes 1-%d] [--codec json|cbor] [--individual 0|1]\n"
+         "                 [--storm-every s] [--storm-pct pct] [--outage s]\n"
+         "                 [--realtime] [--prefix text] [--seed n]\n", MAX_SOIL_PROBES);
+}
+
+static bool parseOptions(int argc, char** argv) {
+  for (int i = 1; i < argc; i++) {
+    const char* name = argv[i];
+    if (strcmp(name, "--realtime") == 0) {
+      options.realtime = true;
+      continue;
+    }
+    if (i + 1 >= argc) return false;
+    const char* value = argv[++i];
+    uint32_t number = (uint32_t)strtoul(value, nullptr, 10);
+    if (strcmp(name, "--devices") == 0) options.devices = number;
+    else if (strcmp(name, "--report") == 0) {
+      if (strcmp(value, "deadband") == 0) options.report_mode = REPORT_MODE_DEADBAND;
+      else if (strcmp(value, "interval") == 0) options.report_mode = REPORT_MODE_INTERVAL;
+      else return false;
+    }
+    else if (strcmp(name, "--sample") == 0) options.sample_ms = number;
+    else if (strcmp(name, "--interval") == 0) options.interval_ms = number;
+    else if (strcmp(name, "--jitter") == 0) options.jitter_pct = std::min<uint32_t>(number, 100);
+    else if (strcmp(name, "--duration") == 0) options.duration_s = number;
+    else if (strcmp(name, "--probes") == 0) options.probes = std::min<uint32_t>(std::max<uint32_t>(number, 1), MAX_SOIL_PROBES);
+    else if (strcmp(name, "--codec") == 0) options.cbor = strcmp(value, "cbor") == 0;
+    else if (strcmp(name, "--individual") == 0) options.individual = number != 0;
+    else if (strcmp(name, "--storm-every") == 0) options.storm_every_s = number;
+    else if (strcmp(name, "--storm-pct") == 0) options.storm_pct = std::min<uint32_t>(number, 100);
+    else if (strcmp(name, "--outage") == 0) options.outage_s = number;
+    else if (strcmp(name, "--prefix") == 0) options.prefix = value;
+    else if (strcmp(name, "--seed") == 0) options.seed = number;
+    else return false;
+  }
+  return options.devices > 0 && options.interval_ms > 0 && options.sample_ms > 0;
+}
+
+int main(int argc, char** argv) {
+  if (!parseOptions(argc, argv)) {
+    usage();
+    return 2;
+  }
+  rng.seed(options.seed);
+
+  fleet.resize(options.devices);
+  for (uint32_t i = 0; i < options.devices; i++) {
+    VirtualDevice& device = fleet[i];
+    memset(&device, 0, sizeof(device));
+    const uint8_t mac[6] = {0x40, 0x4C, 0xCA, (uint8_t)(i >> 16), (uint8_t)(i >> 8), (uint8_t)i};
+    memcpy(device.mac, mac, sizeof(mac));
+    snprintf(device.id, sizeof(device.id), "%02X:%02X:%02X:%02X:%02X:%02X",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    snprintf(device.base, sizeof(device.base), "%s/%s", options.prefix, device.id);
+    device.backoff_ms = MQTT_RECONNECT_MIN_MS;
+    device.air_temperature = 18.0f + rng() % 800 / 100.0f;
+    device.air_humidity = 45.0f + rng() % 2000 / 100.0f;
+    for (uint8_t p = 0; p < MAX_SOIL_PROBES; p++) {
+      device.moisture[p] = 30.0f + rng() % 3000 / 100.0f;
+      device.soil_temperature[p] = 15.0f + rng() % 500 / 100.0f;
+    }
+  }
+
+  BrokerStandIn broker;
+  char filter[MQTT_TOPIC_MAX];
+  snprintf(filter, sizeof(filter), "%s/#", options.prefix);
+  broker.subscribe(filter, [](const StandInMessage&) { counters.received++; });
+  broker.start();
+
+  // Devices boot spread over one report cycle
+  for (uint32_t i = 0; i < options.devices; i++) {
+    schedule(rng() % cycleMs(), i, EVENT_RECONNECT);
+  }
+  if (options.storm_every_s > 0) {
+    schedule(options.storm_every_s * 1000ULL, UINT32_MAX, EVENT_STORM);
+  }
+
+  if (options.report_mode == REPORT_MODE_DEADBAND) {
+    printf("Simulating %u devices for %u s: %s, deadband reporting on reads every %u ms +/-%u%% (heartbeat %u s), "
+           "%u probes, individual topics %s\n",
+           options.devices, options.duration_s, options.cbor ? "CBOR" : "JSON", options.sample_ms, options.jitter_pct,
+           (unsigned)(REPORT_HEARTBEAT_INTERVAL / 1000), options.probes, options.individual ? "on" : "off");
+  } else {
+    printf("Simulating %u devices for %u s: %s, interval reporting every %u ms +/-%u%%, %u probes, individual topics %s\n",
+           options.devices, options.duration_s, options.cbor ? "CBOR" : "JSON", options.interval_ms,
+           options.jitter_pct, options.probes, options.individual ? "on" : "off");
+  }
+  if (options.storm_every_s > 0) {
+    printf("Storm every %u s dropping %u%% of the fleet%s\n", options.storm_every_s, options.storm_pct,
+           options.outage_s ? (", broker down " + std::to_string(options.outage_s) + " s").c_str() : "");
+  }
+
+  uint64_t end_ms = options.duration_s * 1000ULL;
+  auto start = std::chrono::steady_clock::now();
+  while (!events.empty() && events.top().at_ms < end_ms) {
+    Event event = events.top();
+    events.pop();
+    if (options.realtime) {
+      std::this_thread::sleep_until(start + std::chrono::milliseconds(event.at_ms));
+    }
+    handleEvent(broker, event);
+  }
+  broker.stop();
+  double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  BrokerStats stats = broker.stats();
+  std::vector<uint32_t> latency = broker.latencies();
+  printf("\nMessages: %llu published (%llu sensors, %llu individual, %llu status/info, %llu health, %llu wills)\n",
+         (unsigned long long)stats.published, (unsigned long long)counters.sensors,
+         (unsigned long long)counters.individual, (unsigned long long)counters.presence,
+         (unsigned long long)counters.health, (unsigned long long)stats.wills);
+  if (options.report_mode == REPORT_MODE_DEADBAND) {
+    uint64_t metrics = counters.metrics_published + counters.metrics_suppressed;
+    printf("Reporting: %llu metrics published, %llu suppressed by deadband (%.0f%% saved)\n",
+           (unsigned long long)counters.metrics_published, (unsigned long long)counters.metrics_suppressed,
+           metrics ? counters.metrics_suppressed * 100.0 / metrics : 0.0);
+  }
+  printf("Delivered: %llu to the fleet subscriber, %llu retained topics, %llu ring stalls\n",
+         (unsigned long long)counters.received, (unsigned long long)broker.retainedCount(),
+         (unsigned long long)stats.stalls);
+  printf("Throughput: %.0f msg/s, %.2f MB/s over %.2f s wall (%.0fx simulated time)\n",
+         stats.published / wall_s, stats.bytes / wall_s / 1e6, wall_s, options.duration_s / wall_s);
+  printf("Latency publish->subscriber: p50 %.1f us, p90 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n",
+         percentile(latency, 50) / 1e3, percentile(latency, 90) / 1e3, percentile(latency, 99) / 1e3,
+         percentile(latency, 99.9) / 1e3, percentile(latency, 100) / 1e3);
+
+  if (counters.storms > 0) {
+    uint32_t peak = 0;
+    for (uint32_t connects : counters.connects_per_second) peak = std::max(peak, connects);
+    printf("Storms: %llu, %llu drops, %llu reconnect attempts (%llu refused), peak wave %u connects/s\n",
+           (unsigned long long)counters.storms, (unsigned long long)counters.drops,
+           (unsigned long long)counters.attempts, (unsigned long long)counters.failures, peak);
+    printf("Time to reconnect: p50 %.1f s, p90 %.1f s, p99 %.1f s, max %.1f s\n",
+           percentile(counters.reconnect_ms, 50) / 1e3, percentile(counters.reconnect_ms, 90) / 1e3,
+           percentile(counters.reconnect_ms, 99) / 1e3, percentile(counters.reconnect_ms, 100) / 1e3);
+  }
+  return 0;
+}
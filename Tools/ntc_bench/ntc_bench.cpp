@@ -0,0 +1,193 @@
+// ntc_bench.cpp - accuracy report and host benchmark for soil_conversion.cpp
+//
+// Compares the compile-time NTC lookup table and the fixed-point moisture
+// path against the float formulas the firmware used before, over every
+// reachable ADS1115 count, then times both paths.
+//
+// Timings are reported in ns and in host CPU cycles. Cycles come from the
+// core's cycle counter through perf_event when the kernel allows it, and
+// otherwise from the x86 TSC (reference cycles at the nominal clock). They
+// are host cycles, not ESP32-C6 cycles: the host has an FPU, so the
+// measured speedup is a lower bound for the C6, where every float
+// operation is a soft-float call.
+
+#include "soil_conversion.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Original firmware implementation, kept verbatim as the reference
+static float referenceTemperature(int16_t adcValue) {
+  float voltage = adcValue * 0.0001875;
+  if (voltage >= VCC || voltage <= 0) {
+    return -100.0;
+  }
+  float R_ntc = (voltage * R_FIXED) / (VCC - voltage);
+  if (R_ntc <= 0) {
+    return -100.0;
+  }
+  float invT = (1.0 / T0) + (1.0 / BETA) * log(R_ntc / R0);
+  float T = 1.0 / invT;
+  return T - 273.15;
+}
+
+static float referenceMoisture(int raw_value) {
+  int inverted_value = SOIL_MOISTURE_DRY - raw_value;
+  int range = SOIL_MOISTURE_DRY - SOIL_MOISTURE_WET;
+  if (range <= 0) range = 1;
+  float percentage = (inverted_value * 100.0) / range;
+  if (percentage < 0) percentage = 0;
+  if (percentage > 100) percentage = 100;
+  return percentage;
+}
+
+struct ErrorStats {
+  double max_abs = 0.0;
+  double sum_sq = 0.0;
+  int worst_counts = 0;
+  int samples = 0;
+
+  void add(int counts, double err) {
+    double a = std::fabs(err);
+    if (a > max_abs) {
+      max_abs = a;
+      worst_counts = counts;
+    }
+    sum_sq += err * err;
+    samples++;
+  }
+  double rms() const { return samples ? std::sqrt(sum_sq / samples) : 0.0; }
+};
+
+static void accuracyReport() {
+  ErrorStats band;     // -40..125°C, the probe's rated range
+  ErrorStats wide;     // -55..150°C
+  ErrorStats moisture;
+
+  for (int counts = 1; counts < NTC_VCC_COUNTS; counts++) {
+    double ref = referenceTemperature(counts);
+    double lut = ntcCountsToCentiCelsius(counts) / 100.0;
+    if (ref >= -40.0 && ref <= 125.0) band.add(counts, lut - ref);
+    if (ref >= -55.0 && ref <= 150.0) wide.add(counts, lut - ref);
+  }
+
+  for (int counts = 0; counts <= 32767; counts++) {
+    double ref = referenceMoisture(counts);
+    double fix = moistureCountsToCentiPercent(counts, SOIL_MOISTURE_DRY, SOIL_MOISTURE_WET) / 100.0;
+    moisture.add(counts, fix - ref);
+  }
+
+  printf("NTC lookup table: %d entries x 2 bytes = %d bytes, step %d counts\n",
+         (int)NTC_LUT_SIZE, (int)(NTC_LUT_SIZE * 2), NTC_LUT_STEP);
+  printf("  -40..125 C : max |err| %.4f C at %d counts, rms %.4f C (%d points)\n",
+         band.max_abs, band.worst_counts, band.rms(), band.samples);
+  printf("  -55..150 C : max |err| %.4f C at %d counts, rms %.4f C (%d points)\n",
+         wide.max_abs, wide.worst_counts, wide.rms(), wide.samples);
+  printf("Moisture fixed-point: max |err| %.4f %% at %d counts, rms %.4f %%\n",
+         moisture.max_abs, moisture.worst_counts, moisture.rms());
+}
+
+enum CycleSource { CYCLES_PERF, CYCLES_TSC, CYCLES_NONE };
+
+static CycleSource cycleSource = CYCLES_NONE;
+static int perfFd = -1;
+
+static void openCycleCounter() {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = PERF_COUNT_HW_CPU_CYCLES;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  perfFd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  if (perfFd >= 0) {
+    cycleSource = CYCLES_PERF;
+    return;
+  }
+#if defined(__x86_64__) || defined(__i386__)
+  cycleSource = CYCLES_TSC;
+#endif
+}
+
+static uint64_t readCycles() {
+  if (cycleSource == CYCLES_PERF) {
+    uint64_t cycles = 0;
+    return read(perfFd, &cycles, sizeof(cycles)) == (ssize_t)sizeof(cycles) ? cycles : 0;
+  }
+#if defined(__x86_64__) || defined(__i386__)
+  if (cycleSource == CYCLES_TSC) return __rdtsc();
+#endif
+  return 0;
+}
+
+static const char* cycleSourceName() {
+  switch (cycleSource) {
+    case CYCLES_PERF: return "core cycles from perf_event";
+    case CYCLES_TSC:  return "TSC reference cycles; perf_event unavailable";
+    case CYCLES_NONE: break;
+  }
+  return "no cycle counter, ns only";
+}
+
+struct Timing {
+  double ns;
+  double cycles;
+};
+
+template <typename Fn>
+static Timing perCall(const std::vector<int16_t>& input, int rounds, Fn fn) {
+  volatile double sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  uint64_t startCycles = readCycles();
+  for (int r = 0; r < rounds; r++) {
+    for (int16_t v : input) sink = sink + fn(v);
+  }
+  uint64_t endCycles = readCycles();
+  auto end = std::chrono::steady_clock::now();
+  double calls = (double)rounds * input.size();
+  double ns = std::chrono::duration<double, std::nano>(end - start).count();
+  return {ns / calls, (endCycles - startCycles) / calls};
+}
+
+static void printTiming(const char* name, const Timing& timing, const Timing* baseline) {
+  printf("  %-18s: %7.2f ns", name, timing.ns);
+  if (cycleSource != CYCLES_NONE) printf("  %7.1f cycles", timing.cycles);
+  printf("/conversion");
+  if (baseline != nullptr) printf("  (%.1fx)", baseline->ns / timing.ns);
+  printf("\n");
+}
+
+static void benchmark() {
+  std::vector<int16_t> input;
+  for (int counts = 1; counts < NTC_VCC_COUNTS; counts += 7) input.push_back(counts);
+  const int rounds = 2000;
+
+  openCycleCounter();
+  Timing tRef = perCall(input, rounds, [](int16_t v) { return referenceTemperature(v); });
+  Timing tLut = perCall(input, rounds, [](int16_t v) { return ntcCountsToCentiCelsius(v) * 0.01f; });
+  Timing mRef = perCall(input, rounds, [](int16_t v) { return referenceMoisture(v); });
+  Timing mFix = perCall(input, rounds, [](int16_t v) { return moistureCountsToCentiPercent(v, SOIL_MOISTURE_DRY, SOIL_MOISTURE_WET) * 0.01f; });
+
+  printf("\nHost benchmark (%zu conversions x %d rounds, %s)\n", input.size(), rounds, cycleSourceName());
+  printTiming("temperature float", tRef, nullptr);
+  printTiming("temperature LUT", tLut, &tRef);
+  printTiming("moisture float", mRef, nullptr);
+  printTiming("moisture fixed", mFix, &mRef);
+  printf("  Host cycles, not ESP32-C6 cycles: the C6 has no FPU, so its float paths are slower still\n");
+}
+
+int main() {
+  accuracyReport();
+  benchmark();
+  return 0;
+}
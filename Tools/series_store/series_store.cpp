@@ -0,0 +1,444 @@
+// series_store.cpp - see series_store.h
+
+#include "series_store.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define COLUMN_FILE_MAGIC 0x4C4F4353u  // "SCOL"
+#define COLUMN_FILE_HEADER 128
+
+// At the start of every file; widths must match on reopen
+struct ColumnFileHeader {
+  uint32_t magic;
+  uint32_t block_rows;
+  uint32_t rows;
+  uint16_t column_count;
+  uint8_t widths[COLUMN_FILE_HEADER - 14];
+};
+static_assert(sizeof(ColumnFileHeader) == COLUMN_FILE_HEADER, "header size");
+
+// Rollup columns: timestamp, then min/max/sum/count for every channel
+#define ROLLUP_MIN(c) (1 + (c) * 4)
+#define ROLLUP_MAX(c) (2 + (c) * 4)
+#define ROLLUP_SUM(c) (3 + (c) * 4)
+#define ROLLUP_COUNT(c) (4 + (c) * 4)
+
+static const uint32_t TIER_SECONDS[STORE_TIER_COUNT] = {0, 60, 3600};
+static const char* const TIER_FILES[STORE_TIER_COUNT] = {"raw.col", "1m.col", "1h.col"};
+
+ColumnFile::~ColumnFile() {
+  close();
+}
+
+bool ColumnFile::open(const std::string& path, const std::vector<uint8_t>& widths) {
+  if (widths.size() > sizeof(ColumnFileHeader::widths)) return false;
+  columnWidths = widths;
+  columnOffsets.clear();
+  blockBytes = 0;
+  for (uint8_t width : widths) {
+    columnOffsets.push_back(blockBytes);
+    blockBytes += (size_t)width * STORE_BLOCK_ROWS;
+  }
+
+  fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0) return false;
+  struct stat info;
+  fstat(fd, &info);
+
+  if (info.st_size == 0) {
+    if (ftruncate(fd, COLUMN_FILE_HEADER + blockBytes) != 0) return false;
+    mappedSize = COLUMN_FILE_HEADER + blockBytes;
+  } else {
+    mappedSize = info.st_size;
+  }
+  map = (uint8_t*)mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED) {
+    map = nullptr;
+    return false;
+  }
+
+  ColumnFileHeader* header = (ColumnFileHeader*)map;
+  if (info.st_size == 0) {
+    header->magic = COLUMN_FILE_MAGIC;
+    header->block_rows = STORE_BLOCK_ROWS;
+    header->rows = 0;
+    header->column_count = widths.size();
+    memcpy(header->widths, widths.data(), widths.size());
+  } else if (header->magic != COLUMN_FILE_MAGIC || header->block_rows != STORE_BLOCK_ROWS ||
+             header->column_count != widths.size() || memcmp(header->widths, widths.data(), widths.size()) != 0) {
+    fprintf(stderr, "%s: incompatible column file\n", path.c_str());
+    close();
+    return false;
+  }
+  return true;
+}
+
+void ColumnFile::close() {
+  if (map != nullptr) munmap(map, mappedSize);
+  if (fd >= 0) ::close(fd);
+  map = nullptr;
+  fd = -1;
+  mappedSize = 0;
+}
+
+uint32_t ColumnFile::rows() const {
+  return map ? ((const ColumnFileHeader*)map)->rows : 0;
+}
+
+bool ColumnFile::grow() {
+  size_t newSize = mappedSize + blockBytes;
+  if (ftruncate(fd, newSize) != 0) return false;
+  void* grown = mremap(map, mappedSize, newSize, MREMAP_MAYMOVE);
+  if (grown == MAP_FAILED) return false;
+  map = (uint8_t*)grown;
+  mappedSize = newSize;
+  return true;
+}
+
+bool ColumnFile::reserve(uint32_t& row) {
+  row = rows();
+  size_t blocks = (mappedSize - COLUMN_FILE_HEADER) / blockBytes;
+  return row < blocks * STORE_BLOCK_ROWS || grow();
+}
+
+bool ColumnFile::reserveAt(uint32_t row) {
+  uint32_t last;
+  if (!reserve(last)) return false;
+  for (uint32_t r = last; r > row; r--) {
+    for (uint8_t c = 0; c < columnWidths.size(); c++) memcpy(cell(r, c), cell(r - 1, c), columnWidths[c]);
+  }
+  return true;
+}
+
+void ColumnFile::commit() {
+  ((ColumnFileHeader*)map)->rows++;
+}
+
+uint8_t* ColumnFile::cell(uint32_t row, uint8_t column) const {
+  size_t block = row / STORE_BLOCK_ROWS;
+  size_t inBlock = row % STORE_BLOCK_ROWS;
+  return map + COLUMN_FILE_HEADER + block * blockBytes + columnOffsets[column] + inBlock * columnWidths[column];
+}
+
+uint32_t ColumnFile::lowerBound(uint32_t timestamp) const {
+  uint32_t low = 0;
+  uint32_t high = rows();
+  while (low < high) {
+    uint32_t middle = low + (high - low) / 2;
+    if (get<uint32_t>(middle, 0) < timestamp) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+static uint64_t macKey(const uint8_t* mac) {
+  uint64_t key = 0;
+  for (int i = 0; i < 6; i++) key = key << 8 | mac[i];
+  return key;
+}
+
+static void resetBucket(int16_t* min, int16_t* max, int32_t* sum, uint16_t* count) {
+  for (uint8_t c = 0; c < STORE_CHANNELS; c++) {
+    min[c] = INT16_MAX;
+    max[c] = INT16_MIN;
+    sum[c] = 0;
+    count[c] = 0;
+  }
+}
+
+SeriesStore::SeriesStore(const std::string& directory) : root(directory) {
+  mkdir(root.c_str(), 0755);
+}
+
+SeriesStore::~SeriesStore() {
+  flush();
+}
+
+SeriesStore::Device* SeriesStore::device(const uint8_t* mac, bool create) {
+  uint64_t key = macKey(mac);
+  auto found = devices.find(key);
+  if (found != devices.end()) return found->second.get();
+
+  char name[16];
+  snprintf(name, sizeof(name), "%02X%02X%02X%02X%02X%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+  std::string path = root + "/" + name;
+  struct stat info;
+  if (!create && stat(path.c_str(), &info) != 0) return nullptr;
+  mkdir(path.c_str(), 0755);
+
+  std::unique_ptr<Device> entry(new Device());
+  std::vector<uint8_t> raw(1 + STORE_CHANNELS, 2);
+  raw[0] = 4;
+  std::vector<uint8_t> rollup(1 + STORE_CHANNELS * 4, 2);
+  rollup[0] = 4;
+  for (uint8_t c = 0; c < STORE_CHANNELS; c++) rollup[ROLLUP_SUM(c)] = 4;
+
+  for (uint8_t t = 0; t < STORE_TIER_COUNT; t++) {
+    if (!entry->tiers[t].open(path + "/" + TIER_FILES[t], t == STORE_TIER_RAW ? raw : rollup)) return nullptr;
+  }
+  ColumnFile& rawFile = entry->tiers[STORE_TIER_RAW];
+  entry->last_timestamp = rawFile.rows() ? rawFile.get<uint32_t>(rawFile.rows() - 1, 0) : 0;
+  resetBucket(entry->minute.min, entry->minute.max, entry->minute.sum, entry->minute.count);
+  resetBucket(entry->hour.min, entry->hour.max, entry->hour.sum, entry->hour.count);
+
+  Device* result = entry.get();
+  devices.emplace(key, std::move(entry));
+  return result;
+}
+
+void SeriesStore::closeBucket(Device& device, StoreTier tier, Bucket& bucket) {
+  if (!bucket.open) return;
+  ColumnFile& file = device.tiers[tier];
+  uint32_t row;
+  if (file.reserve(row)) {
+    file.set<uint32_t>(row, 0, bucket.start);
+    for (uint8_t c = 0; c < STORE_CHANNELS; c++) {
+      file.set<int16_t>(row, ROLLUP_MIN(c), bucket.count[c] ? bucket.min[c] : (int16_t)STORE_NO_DATA);
+      file.set<int16_t>(row, ROLLUP_MAX(c), bucket.count[c] ? bucket.max[c] : (int16_t)STORE_NO_DATA);
+      file.set<int32_t>(row, ROLLUP_SUM(c), bucket.sum[c]);
+      file.set<uint16_t>(row, ROLLUP_COUNT(c), bucket.count[c]);
+    }
+    file.commit();
+    storeStats.rollups++;
+  }
+  if (tier == STORE_TIER_MINUTE) {
+    addToBucket(device, STORE_TIER_HOUR, device.hour, bucket.start, bucket.min, bucket.max, bucket.sum, bucket.count);
+  }
+  bucket.open = false;
+  resetBucket(bucket.min, bucket.max, bucket.sum, bucket.count);
+}
+
+void SeriesStore::addToBucket(Device& device, StoreTier tier, Bucket& bucket, uint32_t timestamp, const int16_t* min,
+                              const int16_t* max, const int32_t* sum, const uint16_t* count) {
+  uint32_t start = timestamp - timestamp % TIER_SECONDS[tier];
+  if (bucket.open && bucket.start != start) closeBucket(device, tier, bucket);
+  bucket.open = true;
+  bucket.start = start;
+  for (uint8_t c = 0; c < STORE_CHANNELS; c++) {
+    if (count[c] == 0) continue;
+    if (min[c] < bucket.min[c]) bucket.min[c] = min[c];
+    if (max[c] > bucket.max[c]) bucket.max[c] = max[c];
+    bucket.sum[c] += sum[c];
+    bucket.count[c] += count[c];
+  }
+}
+
+void SeriesStore::mergeRollup(Device& device, StoreTier tier, uint32_t start, const int16_t* min, const int16_t* max,
+                              const int32_t* sum, const uint16_t* count) {
+  ColumnFile& file = device.tiers[tier];
+  uint32_t row = file.lowerBound(start);
+  bool found = row < file.rows() && file.get<uint32_t>(row, 0) == start;
+  if (!found) {
+    if (!file.reserveAt(row)) return;
+    file.set<uint32_t>(row, 0, start);
+    for (uint8_t c = 0; c < STORE_CHANNELS; c++) {
+      file.set<int16_t>(row, ROLLUP_MIN(c), (int16_t)STORE_NO_DATA);
+      file.set<int16_t>(row, ROLLUP_MAX(c), (int16_t)STORE_NO_DATA);
+      file.set<int32_t>(row, ROLLUP_SUM(c), 0);
+      file.set<uint16_t>(row, ROLLUP_COUNT(c), 0);
+    }
+  }
+  for (uint8_t c = 0; c < STORE_CHANNELS; c++) {
+    if (count[c] == 0) continue;
+    uint16_t stored = file.get<uint16_t>(row, ROLLUP_COUNT(c));
+    int16_t rowMin = file.get<int16_t>(row, ROLLUP_MIN(c));
+    int16_t rowMax = file.get<int16_t>(row, ROLLUP_MAX(c));
+    file.set<int16_t>(row, ROLLUP_MIN(c), stored == 0 || min[c] < rowMin ? min[c] : rowMin);
+    file.set<int16_t>(row, ROLLUP_MAX(c), stored == 0 || max[c] > rowMax ? max[c] : rowMax);
+    file.set<int32_t>(row, ROLLUP_SUM(c), file.get<int32_t>(row, ROLLUP_SUM(c)) + sum[c]);
+    file.set<uint16_t>(row, ROLLUP_COUNT(c), stored + count[c]);
+  }
+  if (!found) {
+    file.commit();
+    storeStats.rollups++;
+  }
+}
+
+static void frameValues(const TelemetryFrame& frame, int16_t* values) {
+  for (uint8_t c = 0; c < STORE_CHANNELS; c++) values[c] = STORE_NO_DATA;
+  if (frame.air_valid) {
+    values[0] = frame.air_temperature_centi;
+    values[1] = (int16_t)frame.air_humidity_centi;
+  }
+  for (uint8_t p = 0; p < frame.probe_count; p++) {
+    const TelemetryProbe& probe = frame.probes[p];
+    if (probe.index >= MAX_SOIL_PROBES) continue;
+    values[STORE_CHANNEL_SOIL_MOISTURE(probe.index)] = (int16_t)probe.moisture_centi;
+    values[STORE_CHANNEL_SOIL_TEMP(probe.index)] = probe.temperature_centi;
+  }
+}
+
+static void singleSample(const int16_t* values, int32_t* sums, uint16_t* counts) {
+  for (uint8_t c = 0; c < STORE_CHANNELS; c++) {
+    bool present = values[c] != STORE_NO_DATA;
+    sums[c] = present ? values[c] : 0;
+    counts[c] = present ? 1 : 0;
+  }
+}
+
+bool SeriesStore::append(const TelemetryFrame& frame, uint32_t timestamp) {
+  Device* entry = device(frame.mac, true);
+  if (entry == nullptr) return false;
+  if (timestamp < entry->last_timestamp) {
+    storeStats.out_of_order++;
+    return false;
+  }
+
+  int16_t values[STORE_CHANNELS];
+  frameValues(frame, values);
+
+  ColumnFile& raw = entry->tiers[STORE_TIER_RAW];
+  uint32_t row;
+  if (!raw.reserve(row)) return false;
+  raw.set<uint32_t>(row, 0, timestamp);
+  for (uint8_t c = 0; c < STORE_CHANNELS; c++) raw.set<int16_t>(row, 1 + c, values[c]);
+  raw.commit();
+  entry->last_timestamp = timestamp;
+  storeStats.rows++;
+
+  int32_t sums[STORE_CHANNELS];
+  uint16_t counts[STORE_CHANNELS];
+  singleSample(values, sums, counts);
+  addToBucket(*entry, STORE_TIER_MINUTE, entry->minute, timestamp, values, values, sums, counts);
+  return true;
+}
+
+bool SeriesStore::backfill(const TelemetryFrame& frame, uint32_t timestamp) {
+  Device* entry = device(frame.mac, true);
+  if (entry == nullptr) return false;
+  if (timestamp > entry->last_timestamp) return append(frame, timestamp);
+
+  // A reboot can replay part of the log twice
+  ColumnFile& raw = entry->tiers[STORE_TIER_RAW];
+  uint32_t row = raw.lowerBound(timestamp);
+  if (row < raw.rows() && raw.get<uint32_t>(row, 0) == timestamp) {
+    storeStats.duplicates++;
+    return false;
+  }
+
+  int16_t values[STORE_CHANNELS];
+  frameValues(frame, values);
+  if (!raw.reserveAt(row)) return false;
+  raw.set<uint32_t>(row, 0, timestamp);
+  for (uint8_t c = 0; c < STORE_CHANNELS; c++) raw.set<int16_t>(row, 1 + c, values[c]);
+  raw.commit();
+  storeStats.rows++;
+  storeStats.backfilled++;
+
+  // Into the open bucket if the row falls in it, otherwise into the written
+  // row; a minute row already written has been added to its hour, so the
+  // sample goes to the hour as well
+  int32_t sums[STORE_CHANNELS];
+  uint16_t counts[STORE_CHANNELS];
+  singleSample(values, sums, counts);
+  uint32_t minute = timestamp - timestamp % TIER_SECONDS[STORE_TIER_MINUTE];
+  uint32_t hour = timestamp - timestamp % TIER_SECONDS[STORE_TIER_HOUR];
+  if (entry->minute.open && entry->minute.start == minute) {
+    addToBucket(*entry, STORE_TIER_MINUTE, entry->minute, timestamp, values, values, sums, counts);
+    return true;
+  }
+  mergeRollup(*entry, STORE_TIER_MINUTE, minute, values, values, sums, counts);
+  if (entry->hour.open && entry->hour.start == hour) {
+    addToBucket(*entry, STORE_TIER_HOUR, entry->hour, timestamp, values, values, sums, counts);
+  } else {
+    mergeRollup(*entry, STORE_TIER_HOUR, hour, values, values, sums, counts);
+  }
+  return true;
+}
+
+void SeriesStore::flush() {
+  for (auto& entry : devices) {
+    closeBucket(*entry.second, STORE_TIER_MINUTE, entry.second->minute);
+    closeBucket(*entry.second, STORE_TIER_HOUR, entry.second->hour);
+  }
+}
+
+size_t SeriesStore::queryRaw(const uint8_t* mac, uint32_t from, uint32_t to, uint8_t channel,
+                             std::vector<SeriesPoint>& out) {
+  out.clear();
+  Device* entry = device(mac, false);
+  if (entry == nullptr || channel >= STORE_CHANNELS) return 0;
+
+  const ColumnFile& file = entry->tiers[STORE_TIER_RAW];
+  uint32_t rows = file.rows();
+  for (uint32_t row = file.lowerBound(from); row < rows; row++) {
+    uint32_t timestamp = file.get<uint32_t>(row, 0);
+    if (timestamp > to) break;
+    int16_t value = file.get<int16_t>(row, 1 + channel);
+    if (value != STORE_NO_DATA) out.push_back({timestamp, value});
+  }
+  return out.size();
+}
+
+size_t SeriesStore::queryRollup(const uint8_t* mac, StoreTier tier, uint32_t from, uint32_t to, uint8_t channel,
+                                std::vector<RollupPoint>& out) {
+  out.clear();
+  if (tier == STORE_TIER_RAW || tier >= STORE_TIER_COUNT) return 0;
+  Device* entry = device(mac, false);
+  if (entry == nullptr || channel >= STORE_CHANNELS) return 0;
+
+  const ColumnFile& file = entry->tiers[tier];
+  uint32_t rows = file.rows();
+  for (uint32_t row = file.lowerBound(from); row < rows; row++) {
+    uint32_t timestamp = file.get<uint32_t>(row, 0);
+    if (timestamp > to) break;
+    uint16_t count = file.get<uint16_t>(row, ROLLUP_COUNT(channel));
+    if (count == 0) continue;
+    int32_t sum = file.get<int32_t>(row, ROLLUP_SUM(channel));
+    out.push_back({timestamp, count, file.get<int16_t>(row, ROLLUP_MIN(channel)),
+                   file.get<int16_t>(row, ROLLUP_MAX(channel)), sum / count, sum});
+  }
+  return out.size();
+}
+
+size_t SeriesStore::queryDownsampled(const uint8_t* mac, uint32_t from, uint32_t to, uint8_t channel,
+                                     uint32_t bucketSeconds, std::vector<RollupPoint>& out) {
+  out.clear();
+  if (bucketSeconds == 0) return 0;
+
+  // Gather from the coarsest tier whose resolution divides the bucket
+  std::vector<RollupPoint> source;
+  if (bucketSeconds % TIER_SECONDS[STORE_TIER_HOUR] == 0) {
+    queryRollup(mac, STORE_TIER_HOUR, from, to, channel, source);
+  } else if (bucketSeconds % TIER_SECONDS[STORE_TIER_MINUTE] == 0) {
+    queryRollup(mac, STORE_TIER_MINUTE, from, to, channel, source);
+  } else {
+    std::vector<SeriesPoint> raw;
+    queryRaw(mac, from, to, channel, raw);
+    source.reserve(raw.size());
+    for (const SeriesPoint& point : raw) {
+      source.push_back({point.timestamp, 1, point.value, point.value, point.value, point.value});
+    }
+  }
+
+  for (const RollupPoint& point : source) {
+    uint32_t start = point.timestamp - point.timestamp % bucketSeconds;
+    if (out.empty() || out.back().timestamp != start) {
+      out.push_back({start, 0, INT16_MAX, INT16_MIN, 0, 0});
+    }
+    RollupPoint& bucket = out.back();
+    bucket.samples += point.samples;
+    bucket.sum += point.sum;
+    if (point.min < bucket.min) bucket.min = point.min;
+    if (point.max > bucket.max) bucket.max = point.max;
+  }
+  for (RollupPoint& bucket : out) bucket.mean = (int32_t)(bucket.sum / bucket.samples);
+  return out.size();
+}
+
+const StoreStats& SeriesStore::stats() const {
+  storeStats.devices = devices.size();
+  storeStats.mapped_bytes = 0;
+  for (const auto& entry : devices) {
+    for (uint8_t t = 0; t < STORE_TIER_COUNT; t++) storeStats.mapped_bytes += entry.second->tiers[t].mappedBytes();
+  }
+  return storeStats;
+}
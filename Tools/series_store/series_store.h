@@ -0,0 +1,169 @@
+// series_store.h - per-device columnar time-series store for the collector
+//
+// Every device gets a directory named after its MAC with one file per
+// tier, the same tiers the firmware keeps in sensor_history.h:
+//
+//   raw.col   every sample
+//   1m.col    1-minute min/max/sum/count per channel
+//   1h.col    1-hour rollups of the 1-minute rows
+//
+// A file is a header followed by fixed-size blocks of STORE_BLOCK_ROWS
+// rows. Inside a block each column is contiguous, so a range query over one
+// channel reads one timestamp array and one value array per block. Files
+// are memory-mapped and grow one block at a time; the row count in the
+// header is only advanced after a row is complete.
+//
+// Values are the firmware's fixed point (centi-°C, centi-%) in the channel
+// layout of REPORT_METRIC_* / HistorySample: air temperature, air humidity,
+// then moisture and temperature for each soil probe. STORE_NO_DATA marks a
+// channel the message did not carry.
+//
+// Live rows only ever append. Backlog rows (replayed from a device's sample
+// log after an outage) are older than what the device has sent live since,
+// so backfill() slots them in by timestamp and merges them into the minute
+// and hour rows they belong to.
+
+#ifndef LEAFYSENSE_SERIES_STORE_H
+#define LEAFYSENSE_SERIES_STORE_H
+
+#include "telemetry_codec.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define STORE_CHANNELS (2 + 2 * MAX_SOIL_PROBES)
+#define STORE_CHANNEL_SOIL_MOISTURE(p) (2 + (p) * 2)
+#define STORE_CHANNEL_SOIL_TEMP(p) (3 + (p) * 2)
+#define STORE_NO_DATA INT16_MIN
+#define STORE_BLOCK_ROWS 1024
+
+enum StoreTier : uint8_t {
+  STORE_TIER_RAW,
+  STORE_TIER_MINUTE,
+  STORE_TIER_HOUR,
+  STORE_TIER_COUNT
+};
+
+struct SeriesPoint {
+  uint32_t timestamp;           // Unix time
+  int16_t value;
+};
+
+struct RollupPoint {
+  uint32_t timestamp;           // Bucket start
+  uint32_t samples;
+  int16_t min;
+  int16_t max;
+  int32_t mean;
+  int64_t sum;
+};
+
+struct StoreStats {
+  uint64_t rows;                // Raw rows appended
+  uint64_t rollups;             // Minute + hour rows written
+  uint64_t out_of_order;        // Rows older than the device's last row, dropped
+  uint64_t backfilled;          // Backlog rows inserted before newer rows
+  uint64_t duplicates;          // Backlog rows whose timestamp was already stored, dropped
+  uint32_t devices;
+  uint64_t mapped_bytes;
+};
+
+// One memory-mapped file of fixed-width columns
+class ColumnFile {
+ public:
+  ColumnFile() = default;
+  ~ColumnFile();
+  ColumnFile(const ColumnFile&) = delete;
+  ColumnFile& operator=(const ColumnFile&) = delete;
+
+  bool open(const std::string& path, const std::vector<uint8_t>& widths);
+  void close();
+  uint32_t rows() const;
+  uint64_t mappedBytes() const { return mappedSize; }
+
+  // Reserves the next row (growing the file if needed); commit() publishes it
+  bool reserve(uint32_t& row);
+  // Like reserve(), but moves rows [row, rows()) up by one to free row
+  bool reserveAt(uint32_t row);
+  void commit();
+
+  uint8_t* cell(uint32_t row, uint8_t column) const;
+  template <typename T> T get(uint32_t row, uint8_t column) const {
+    T value;
+    memcpy(&value, cell(row, column), sizeof(T));
+    return value;
+  }
+  template <typename T> void set(uint32_t row, uint8_t column, T value) {
+    memcpy(cell(row, column), &value, sizeof(T));
+  }
+
+  // First row with timestamp (column 0) >= timestamp
+  uint32_t lowerBound(uint32_t timestamp) const;
+
+ private:
+  bool grow();
+
+  int fd = -1;
+  uint8_t* map = nullptr;
+  size_t mappedSize = 0;
+  size_t blockBytes = 0;
+  std::vector<uint8_t> columnWidths;
+  std::vector<size_t> columnOffsets;  // Within a block
+};
+
+class SeriesStore {
+ public:
+  explicit SeriesStore(const std::string& directory);
+  ~SeriesStore();
+
+  // Appends one decoded sensors message; timestamp is Unix time
+  bool append(const TelemetryFrame& frame, uint32_t timestamp);
+  // Stores one decoded backlog message, before newer rows if need be
+  bool backfill(const TelemetryFrame& frame, uint32_t timestamp);
+  // Writes the open minute and hour buckets so queries see them
+  void flush();
+
+  size_t queryRaw(const uint8_t* mac, uint32_t from, uint32_t to, uint8_t channel,
+                  std::vector<SeriesPoint>& out);
+  size_t queryRollup(const uint8_t* mac, StoreTier tier, uint32_t from, uint32_t to, uint8_t channel,
+                     std::vector<RollupPoint>& out);
+  // Buckets of bucketSeconds built from the coarsest tier that fits
+  size_t queryDownsampled(const uint8_t* mac, uint32_t from, uint32_t to, uint8_t channel,
+                          uint32_t bucketSeconds, std::vector<RollupPoint>& out);
+
+  const StoreStats& stats() const;
+
+ private:
+  struct Bucket {
+    uint32_t start;
+    bool open;
+    int16_t min[STORE_CHANNELS];
+    int16_t max[STORE_CHANNELS];
+    int32_t sum[STORE_CHANNELS];
+    uint16_t count[STORE_CHANNELS];
+  };
+
+  struct Device {
+    ColumnFile tiers[STORE_TIER_COUNT];
+    Bucket minute;
+    Bucket hour;
+    uint32_t last_timestamp;
+  };
+
+  Device* device(const uint8_t* mac, bool create);
+  void closeBucket(Device& device, StoreTier tier, Bucket& bucket);
+  void addToBucket(Device& device, StoreTier tier, Bucket& bucket, uint32_t start, const int16_t* min,
+                   const int16_t* max, const int32_t* sum, const uint16_t* count);
+  // Adds into the written rollup row for start, inserting it if missing
+  void mergeRollup(Device& device, StoreTier tier, uint32_t start, const int16_t* min, const int16_t* max,
+                   const int32_t* sum, const uint16_t* count);
+
+  std::string root;
+  std::unordered_map<uint64_t, std::unique_ptr<Device>> devices;
+  mutable StoreStats storeStats = {};
+};
+
+#endif
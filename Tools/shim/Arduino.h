@@ -0,0 +1,12 @@
+// Minimal stand-in for the Arduino core so firmware headers that only need
+// basic types (config.h, soil_conversion.h, ...) compile on a Linux host.
+#ifndef LEAFYSENSE_HOST_ARDUINO_SHIM_H
+#define LEAFYSENSE_HOST_ARDUINO_SHIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+typedef std::string String;
+
+#endif
@@ -0,0 +1,44 @@
+// telemetry_decode.cpp - decode one CBOR sensors or backlog message from stdin
+//
+//   mosquitto_sub -h broker -t 'leafysense/+/sensors/cbor' -C 1 | build/telemetry_decode
+//   mosquitto_sub -h broker -t 'leafysense/+/backlog/cbor' -C 1 | build/telemetry_decode
+//
+// Prints the same JSON document the firmware publishes with the JSON codec.
+// The timestamp is rebuilt from the epoch field in UTC.
+
+#include "telemetry_decoder.h"
+
+#include <cstdio>
+#include <ctime>
+#include <vector>
+
+int main() {
+  std::vector<uint8_t> input;
+  uint8_t chunk[512];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), stdin)) > 0) input.insert(input.end(), chunk, chunk + n);
+
+  TelemetryFrame frame;
+  TelemetryDecodeResult result = decodeTelemetryCBOR(input.data(), input.size(), frame);
+  if (!result.ok) {
+    fprintf(stderr, "decode failed: %s\n", result.error.c_str());
+    return 1;
+  }
+
+  if (frame.epoch != 0) {
+    time_t t = frame.epoch;
+    struct tm utc;
+    gmtime_r(&t, &utc);
+    strftime(frame.timestamp, sizeof(frame.timestamp), "%Y-%m-%d %H:%M:%S", &utc);
+  } else {
+    snprintf(frame.timestamp, sizeof(frame.timestamp), "Time not synchronized");
+  }
+
+  char json[2048];
+  if (encodeTelemetryJSON(frame, json, sizeof(json)) == 0) {
+    fprintf(stderr, "JSON output too large\n");
+    return 1;
+  }
+  printf("%s\n", json);
+  return 0;
+}
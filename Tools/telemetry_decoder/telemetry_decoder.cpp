@@ -0,0 +1,513 @@
+// telemetry_decoder.cpp - see telemetry_decoder.h
+
+#include "telemetry_decoder.h"
+
+#include <cstring>
+
+namespace {
+
+struct Reader {
+  const uint8_t* data;
+  size_t length;
+  size_t pos = 0;
+  std::string error;
+
+  bool fail(const char* message) {
+    if (error.empty()) error = message;
+    return false;
+  }
+
+  // Initial byte and argument; indefinite lengths are not produced by the
+  // firmware and are rejected
+  bool head(uint8_t& major, uint64_t& value) {
+    if (pos >= length) return fail("truncated message");
+    uint8_t initial = data[pos++];
+    major = initial >> 5;
+    uint8_t info = initial & 0x1F;
+    if (info < 24) {
+      value = info;
+      return true;
+    }
+    int bytes = info == 24 ? 1 : info == 25 ? 2 : info == 26 ? 4 : info == 27 ? 8 : 0;
+    if (bytes == 0) return fail("unsupported CBOR length encoding");
+    if (pos + bytes > length) return fail("truncated message");
+    value = 0;
+    for (int i = 0; i < bytes; i++) value = (value << 8) | data[pos++];
+    return true;
+  }
+
+  bool integer(int64_t& value) {
+    uint8_t major;
+    uint64_t raw;
+    if (!head(major, raw)) return false;
+    if (major == 0) {
+      value = (int64_t)raw;
+    } else if (major == 1) {
+      value = -1 - (int64_t)raw;
+    } else {
+      return fail("expected an integer");
+    }
+    return true;
+  }
+
+  bool container(uint8_t expectedMajor, uint64_t& count) {
+    uint8_t major;
+    if (!head(major, count)) return false;
+    if (major != expectedMajor) return fail(expectedMajor == 4 ? "expected an array" : "expected a map");
+    return true;
+  }
+
+  // Skips one complete data item of any type
+  bool skip(int depth = 0) {
+    if (depth > 16) return fail("nesting too deep");
+    uint8_t major;
+    uint64_t value;
+    if (!head(major, value)) return false;
+    switch (major) {
+      case 0: case 1: case 7:
+        return true;
+      case 2: case 3:
+        if (value > length - pos) return fail("truncated string");
+        pos += value;
+        return true;
+      case 4:
+        for (uint64_t i = 0; i < value; i++) if (!skip(depth + 1)) return false;
+        return true;
+      case 5:
+        for (uint64_t i = 0; i < value * 2; i++) if (!skip(depth + 1)) return false;
+        return true;
+      case 6:
+        return skip(depth + 1);
+    }
+    return fail("unknown CBOR type");
+  }
+
+  // Reads up to `wanted` integers from an array and skips any extra entries
+  bool intArray(int64_t* out, uint64_t wanted, uint64_t& found) {
+    uint64_t count;
+    if (!container(4, count)) return false;
+    found = count < wanted ? count : wanted;
+    for (uint64_t i = 0; i < count; i++) {
+      if (i < wanted) {
+        if (!integer(out[i])) return false;
+      } else if (!skip()) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+}  // namespace
+
+TelemetryDecodeResult decodeTelemetryCBOR(const uint8_t* data, size_t length, TelemetryFrame& frame) {
+  TelemetryDecodeResult result = {false, 0, ""};
+  memset(&frame, 0, sizeof(frame));
+  Reader r{data, length, 0, ""};
+
+  uint64_t entries;
+  if (!r.container(5, entries)) {
+    result.error = r.error;
+    return result;
+  }
+
+  bool ok = true;
+  for (uint64_t e = 0; e < entries && ok; e++) {
+    int64_t key;
+    if (!r.integer(key)) {
+      ok = false;
+      break;
+    }
+
+    int64_t v[8] = {};
+    uint64_t found = 0;
+    switch (key) {
+      case TELEMETRY_KEY_SCHEMA:
+        ok = r.integer(v[0]);
+        result.schema = (uint32_t)v[0];
+        if (ok && result.schema != TELEMETRY_SCHEMA_VERSION) ok = r.fail("unsupported schema version");
+        break;
+
+      case TELEMETRY_KEY_MAC: {
+        uint8_t major;
+        uint64_t size;
+        ok = r.head(major, size);
+        if (ok && (major != 2 || size != sizeof(frame.mac) || r.pos + size > length)) ok = r.fail("bad MAC field");
+        if (ok) {
+          memcpy(frame.mac, data + r.pos, sizeof(frame.mac));
+          r.pos += size;
+        }
+        break;
+      }
+
+      case TELEMETRY_KEY_EPOCH:
+        ok = r.integer(v[0]);
+        frame.epoch = (uint32_t)v[0];
+        break;
+
+      case TELEMETRY_KEY_AIR:
+        ok = r.intArray(v, 2, found);
+        if (ok && found < 2) ok = r.fail("short air block");
+        frame.air_valid = ok;
+        frame.air_temperature_centi = (int16_t)v[0];
+        frame.air_humidity_centi = (uint16_t)v[1];
+        break;
+
+      case TELEMETRY_KEY_SOIL: {
+        uint64_t probes;
+        ok = r.container(4, probes);
+        for (uint64_t p = 0; p < probes && ok; p++) {
+          ok = r.intArray(v, 5, found);
+          if (ok && found < 5) ok = r.fail("short soil probe");
+          if (!ok || frame.probe_count >= MAX_SOIL_PROBES) continue;
+          TelemetryProbe& probe = frame.probes[frame.probe_count++];
+          probe.index = (uint8_t)v[0];
+          probe.moisture_centi = (uint16_t)v[1];
+          probe.temperature_centi = (int16_t)v[2];
+          probe.moisture_raw = (int16_t)v[3];
+          probe.temp_raw = (int16_t)v[4];
+        }
+        break;
+      }
+
+      case TELEMETRY_KEY_RSSI:
+        ok = r.integer(v[0]);
+        frame.wifi_rssi = (int8_t)v[0];
+        break;
+
+      case TELEMETRY_KEY_MEMORY:
+        ok = r.intArray(v, 7, found);
+        frame.free_heap = (uint32_t)v[0];
+        frame.min_free_heap = (uint32_t)v[1];
+        frame.largest_block = (uint32_t)v[2];
+        frame.min_largest_block = (uint32_t)v[3];
+        frame.alloc_failures = (uint32_t)v[4];
+        frame.loop_stack_free = (uint32_t)v[5];
+        frame.memory_warnings = (uint8_t)v[6];
+        break;
+
+      case TELEMETRY_KEY_MQTT:
+        ok = r.intArray(v, 6, found);
+        frame.queue_depth = (uint8_t)v[0];
+        frame.delivered = (uint32_t)v[1];
+        frame.dropped = (uint32_t)v[2];
+        frame.retransmits = (uint32_t)v[3];
+        frame.ack_ms = (uint32_t)v[4];
+        frame.ack_ms_max = (uint32_t)v[5];
+        break;
+
+      case TELEMETRY_KEY_SEQUENCE:
+        ok = r.integer(v[0]);
+        frame.logged = true;
+        frame.sequence = (uint32_t)v[0];
+        break;
+
+      default:
+        ok = r.skip();  // Field from a newer firmware
+        break;
+    }
+  }
+
+  if (ok && r.pos != length) ok = r.fail("trailing bytes after message");
+  if (ok && result.schema == 0) ok = r.fail("missing schema version");
+
+  result.ok = ok;
+  result.error = r.error;
+  return result;
+}
+
+namespace {
+
+// Forward-only scanner over the JSON produced by encodeTelemetryJSON()
+struct JsonReader {
+  const char* data;
+  size_t length;
+  size_t pos = 0;
+  std::string error;
+
+  bool fail(const char* message) {
+    if (error.empty()) error = message;
+    return false;
+  }
+
+  void space() {
+    while (pos < length && (data[pos] == ' ' || data[pos] == '\t' || data[pos] == '\r' || data[pos] == '\n')) pos++;
+  }
+
+  bool expect(char c) {
+    space();
+    if (pos >= length || data[pos] != c) return fail("malformed JSON");
+    pos++;
+    return true;
+  }
+
+  // True and consumed if the next token is c
+  bool next(char c) {
+    space();
+    if (pos < length && data[pos] == c) {
+      pos++;
+      return true;
+    }
+    return false;
+  }
+
+  // String contents as a view into the message. Escapes are kept as-is;
+  // the firmware never emits them in keys or values this decoder reads.
+  bool string(const char*& text, size_t& size) {
+    if (!expect('"')) return false;
+    size_t start = pos;
+    while (pos < length && data[pos] != '"') {
+      if (data[pos] == '\\') pos++;
+      pos++;
+    }
+    if (pos >= length) return fail("truncated string");
+    text = data + start;
+    size = pos - start;
+    pos++;
+    return true;
+  }
+
+  bool key(const char*& text, size_t& size) {
+    return string(text, size) && expect(':');
+  }
+
+  // Decimal number scaled by 10^decimals, rounded half away from zero
+  bool fixed(int64_t& value, int decimals) {
+    space();
+    bool negative = pos < length && data[pos] == '-';
+    if (negative) pos++;
+    if (pos >= length || data[pos] < '0' || data[pos] > '9') return fail("expected a number");
+
+    int64_t whole = 0;
+    while (pos < length && data[pos] >= '0' && data[pos] <= '9') whole = whole * 10 + (data[pos++] - '0');
+    int64_t fraction = 0;
+    int digits = 0;
+    bool roundUp = false;
+    if (pos < length && data[pos] == '.') {
+      pos++;
+      while (pos < length && data[pos] >= '0' && data[pos] <= '9') {
+        if (digits < decimals) {
+          fraction = fraction * 10 + (data[pos] - '0');
+          digits++;
+        } else if (digits == decimals) {
+          roundUp = data[pos] >= '5';
+          digits++;
+        }
+        pos++;
+      }
+    }
+    if (pos < length && (data[pos] == 'e' || data[pos] == 'E')) return fail("exponent in number");
+    for (int d = digits < decimals ? digits : decimals; d < decimals; d++) fraction *= 10;
+    int64_t scale = 1;
+    for (int d = 0; d < decimals; d++) scale *= 10;
+    value = whole * scale + fraction + (roundUp ? 1 : 0);
+    if (negative) value = -value;
+    return true;
+  }
+
+  bool integer(int64_t& value) {
+    return fixed(value, 0);
+  }
+
+  // Skips one complete value of any type
+  bool skip(int depth = 0) {
+    if (depth > 16) return fail("nesting too deep");
+    space();
+    if (pos >= length) return fail("truncated message");
+    char c = data[pos];
+    if (c == '"') {
+      const char* text;
+      size_t size;
+      return string(text, size);
+    }
+    if (c == '{' || c == '[') {
+      char close = c == '{' ? '}' : ']';
+      pos++;
+      if (next(close)) return true;
+      do {
+        if (c == '{') {
+          const char* text;
+          size_t size;
+          if (!key(text, size)) return false;
+        }
+        if (!skip(depth + 1)) return false;
+      } while (next(','));
+      return expect(close);
+    }
+    while (pos < length && data[pos] != ',' && data[pos] != '}' && data[pos] != ']' && data[pos] != ' ') pos++;
+    return true;
+  }
+};
+
+bool keyIs(const char* text, size_t size, const char* name) {
+  return strlen(name) == size && memcmp(text, name, size) == 0;
+}
+
+int hexDigit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+bool parseMac(const char* text, size_t size, uint8_t* mac) {
+  if (size != 17) return false;
+  for (int i = 0; i < 6; i++) {
+    int high = hexDigit(text[i * 3]);
+    int low = hexDigit(text[i * 3 + 1]);
+    if (high < 0 || low < 0 || (i < 5 && text[i * 3 + 2] != ':')) return false;
+    mac[i] = (uint8_t)(high << 4 | low);
+  }
+  return true;
+}
+
+// Reads {"name": integer, ...} into the matching fields; unknown names skip
+template <typename Fn>
+bool intObject(JsonReader& r, Fn assign) {
+  if (!r.expect('{')) return false;
+  if (r.next('}')) return true;
+  do {
+    const char* name;
+    size_t size;
+    if (!r.key(name, size)) return false;
+    if (!assign(name, size)) return false;
+  } while (r.next(','));
+  return r.expect('}');
+}
+
+}  // namespace
+
+TelemetryDecodeResult decodeTelemetryJSON(const char* data, size_t length, TelemetryFrame& frame) {
+  TelemetryDecodeResult result = {false, TELEMETRY_SCHEMA_VERSION, ""};
+  memset(&frame, 0, sizeof(frame));
+  JsonReader r{data, length, 0, ""};
+
+  bool ok = r.expect('{');
+  bool empty = ok && r.next('}');
+  while (ok && !empty) {
+    const char* name;
+    size_t size;
+    int64_t v = 0;
+    ok = r.key(name, size);
+    if (!ok) break;
+
+    if (keyIs(name, size, "device_id")) {
+      const char* text;
+      size_t textSize;
+      ok = r.string(text, textSize) && (parseMac(text, textSize, frame.mac) || r.fail("bad device_id"));
+    } else if (keyIs(name, size, "seq")) {
+      ok = r.integer(v);
+      frame.logged = true;
+      frame.sequence = (uint32_t)v;
+    } else if (keyIs(name, size, "timestamp")) {
+      const char* text;
+      size_t textSize;
+      ok = r.string(text, textSize);
+      if (ok) {
+        size_t copy = textSize < sizeof(frame.timestamp) - 1 ? textSize : sizeof(frame.timestamp) - 1;
+        memcpy(frame.timestamp, text, copy);
+      }
+    } else if (keyIs(name, size, "air")) {
+      ok = intObject(r, [&](const char* field, size_t fieldSize) {
+        if (keyIs(field, fieldSize, "temperature")) {
+          if (!r.fixed(v, 2)) return false;
+          frame.air_temperature_centi = (int16_t)v;
+        } else if (keyIs(field, fieldSize, "humidity")) {
+          if (!r.fixed(v, 2)) return false;
+          frame.air_humidity_centi = (uint16_t)v;
+        } else {
+          return r.skip();
+        }
+        return true;
+      });
+      frame.air_valid = ok;
+    } else if (keyIs(name, size, "soil")) {
+      ok = intObject(r, [&](const char* sensor, size_t sensorSize) {
+        // "sensorN" with N = registry index + 1
+        int64_t number = 0;
+        bool named = sensorSize > 6 && memcmp(sensor, "sensor", 6) == 0;
+        for (size_t i = 6; named && i < sensorSize; i++) {
+          named = sensor[i] >= '0' && sensor[i] <= '9';
+          number = number * 10 + (sensor[i] - '0');
+        }
+        if (!named || number < 1 || frame.probe_count >= MAX_SOIL_PROBES) return r.skip();
+        TelemetryProbe& probe = frame.probes[frame.probe_count++];
+        probe.index = (uint8_t)(number - 1);
+        return intObject(r, [&](const char* field, size_t fieldSize) {
+          if (keyIs(field, fieldSize, "moisture")) {
+            if (!r.fixed(v, 2)) return false;
+            probe.moisture_centi = (uint16_t)v;
+          } else if (keyIs(field, fieldSize, "temperature")) {
+            if (!r.fixed(v, 2)) return false;
+            probe.temperature_centi = (int16_t)v;
+          } else if (keyIs(field, fieldSize, "moisture_raw")) {
+            if (!r.integer(v)) return false;
+            probe.moisture_raw = (int16_t)v;
+          } else if (keyIs(field, fieldSize, "temp_raw")) {
+            if (!r.integer(v)) return false;
+            probe.temp_raw = (int16_t)v;
+          } else {
+            return r.skip();
+          }
+          return true;
+        });
+      });
+    } else if (keyIs(name, size, "wifi_rssi")) {
+      ok = r.integer(v);
+      frame.wifi_rssi = (int8_t)v;
+    } else if (keyIs(name, size, "free_heap")) {
+      ok = r.integer(v);
+      frame.free_heap = (uint32_t)v;
+    } else if (keyIs(name, size, "memory")) {
+      ok = intObject(r, [&](const char* field, size_t fieldSize) {
+        uint32_t* target = keyIs(field, fieldSize, "min_free_heap") ? &frame.min_free_heap
+                         : keyIs(field, fieldSize, "largest_block") ? &frame.largest_block
+                         : keyIs(field, fieldSize, "min_largest_block") ? &frame.min_largest_block
+                         : keyIs(field, fieldSize, "alloc_failures") ? &frame.alloc_failures
+                         : keyIs(field, fieldSize, "loop_stack_free") ? &frame.loop_stack_free
+                         : nullptr;
+        if (keyIs(field, fieldSize, "warnings")) {
+          if (!r.integer(v)) return false;
+          frame.memory_warnings = (uint8_t)v;
+          return true;
+        }
+        if (target == nullptr) return r.skip();
+        if (!r.integer(v)) return false;
+        *target = (uint32_t)v;
+        return true;
+      });
+    } else if (keyIs(name, size, "mqtt")) {
+      ok = intObject(r, [&](const char* field, size_t fieldSize) {
+        uint32_t* target = keyIs(field, fieldSize, "delivered") ? &frame.delivered
+                         : keyIs(field, fieldSize, "dropped") ? &frame.dropped
+                         : keyIs(field, fieldSize, "retransmits") ? &frame.retransmits
+                         : keyIs(field, fieldSize, "ack_ms") ? &frame.ack_ms
+                         : keyIs(field, fieldSize, "ack_ms_max") ? &frame.ack_ms_max
+                         : nullptr;
+        if (keyIs(field, fieldSize, "queue_depth")) {
+          if (!r.integer(v)) return false;
+          frame.queue_depth = (uint8_t)v;
+          return true;
+        }
+        if (target == nullptr) return r.skip();
+        if (!r.integer(v)) return false;
+        *target = (uint32_t)v;
+        return true;
+      });
+    } else {
+      ok = r.skip();  // Field from a newer firmware
+    }
+
+    if (ok && !r.next(',')) {
+      ok = r.expect('}');
+      break;
+    }
+  }
+
+  r.space();
+  if (ok && r.pos != length) ok = r.fail("trailing bytes after message");
+
+  result.ok = ok;
+  result.error = r.error;
+  return result;
+}
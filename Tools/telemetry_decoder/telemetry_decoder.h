@@ -0,0 +1,32 @@
+// telemetry_decoder.h - host-side decoders for the firmware's telemetry
+//
+// Decodes the combined sensors message produced by encodeTelemetryCBOR()
+// or encodeTelemetryJSON() (Firmware/LeafySense/telemetry_codec.h) back
+// into a TelemetryFrame. Unknown keys and extra trailing array entries are
+// skipped, so newer firmware with appended fields still decodes.
+//
+// Both decoders read the message in place and never allocate unless they
+// fail (the error text). JSON numbers go straight to the frame's fixed-point
+// fields without a float round trip. The JSON message has no epoch, so
+// frame.epoch stays 0 and frame.timestamp holds the device's local time.
+//
+// Backlog messages (<prefix>/<device>/backlog, backlog/cbor) use the same
+// codecs; their sequence field sets frame.logged and frame.sequence.
+
+#ifndef LEAFYSENSE_TELEMETRY_DECODER_H
+#define LEAFYSENSE_TELEMETRY_DECODER_H
+
+#include "telemetry_codec.h"
+
+#include <string>
+
+struct TelemetryDecodeResult {
+  bool ok;
+  uint32_t schema;      // Schema version found in the message
+  std::string error;    // Set when ok is false
+};
+
+TelemetryDecodeResult decodeTelemetryCBOR(const uint8_t* data, size_t length, TelemetryFrame& frame);
+TelemetryDecodeResult decodeTelemetryJSON(const char* data, size_t length, TelemetryFrame& frame);
+
+#endif